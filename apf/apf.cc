@@ -352,9 +352,9 @@ int countIntPoints(MeshElement* e, int order)
 
 void getIntPoint(MeshElement* e, int order, int point, Vector3& param)
 {
-  IntegrationPoint const* p = 
-    getIntegration(e->getType())->getAccurate(order)->getPoint(point);
-  param = p->param;
+  Integration const* in = getIntegration(e->getType())->getAccurate(order);
+  param = in->getPoint(point)->param;
+  e->setIntPoint(in, point);
 }
 
 double getIntWeight(MeshElement* e, int order, int point)
@@ -448,7 +448,7 @@ void getMatrixNodes(Element* e, NewArray<Matrix3x3>& values)
 void getShapeValues(Element* e, Vector3 const& local,
     NewArray<double>& values)
 {
-  e->getShape()->getValues(e->getMesh(), e->getEntity(), local,values);
+  e->getShapeValues(local,values);
 }
 
 void getShapeGrads(Element* e, Vector3 const& local,
@@ -461,7 +461,7 @@ void getVectorShapeValues(Element* e, Vector3 const& local,
     NewArray<Vector3>& values)
 {
   NewArray<Vector3> vvals(values.size());
-  e->getShape()->getVectorValues(e->getMesh(), e->getEntity(), local, vvals);
+  e->getVectorValues(local, vvals);
 
   apf::Matrix3x3 Jinv;
   apf::getJacobianInv( e->getParent(), local, Jinv );
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include <PCU.h>
+#include "apfCSR.h"
+#include "apfMesh.h"
+#include "apf.h"
+
+namespace apf {
+
+static void numberOwnedFirst(Mesh* m, int dim, MeshTag* ids,
+    std::vector<MeshEntity*>& ents, int& owned)
+{
+  std::vector<MeshEntity*> copies;
+  ents.clear();
+  ents.reserve(m->count(dim));
+  MeshIterator* it = m->begin(dim);
+  MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    if (m->isOwned(e))
+      ents.push_back(e);
+    else
+      copies.push_back(e);
+  }
+  m->end(it);
+  owned = ents.size();
+  ents.insert(ents.end(), copies.begin(), copies.end());
+  for (int i = 0; i < int(ents.size()); ++i)
+    m->setIntTag(ents[i], ids, &i);
+}
+
+static void packGlobal(FlatCopies const& copies, long global)
+{
+  for (unsigned i = 0; i < copies.size(); ++i) {
+    PCU_COMM_PACK(copies[i].peer, copies[i].entity);
+    PCU_COMM_PACK(copies[i].peer, global);
+  }
+}
+
+/* owners number their entities contiguously after the
+   entities of lower ranks, then send the numbers to
+   every remote and ghost copy in one exchange */
+static void getGlobals(Mesh* m, MeshTag* ids,
+    std::vector<MeshEntity*> const& ents, int owned,
+    std::vector<long>& globals)
+{
+  long offset = owned;
+  PCU_Exscan_Longs(&offset, 1);
+  globals.assign(ents.size(), -1);
+  for (int i = 0; i < owned; ++i)
+    globals[i] = offset + i;
+  PCU_Comm_Begin();
+  FlatCopies copies;
+  for (int i = 0; i < owned; ++i) {
+    if (m->isShared(ents[i])) {
+      m->getFlatRemotes(ents[i], copies);
+      packGlobal(copies, globals[i]);
+    }
+    if (m->isGhosted(ents[i])) {
+      m->getFlatGhosts(ents[i], copies);
+      packGlobal(copies, globals[i]);
+    }
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    MeshEntity* e;
+    PCU_COMM_UNPACK(e);
+    long global;
+    PCU_COMM_UNPACK(global);
+    int i;
+    m->getIntTag(e, ids, &i);
+    globals[i] = global;
+  }
+}
+
+static void prefixSum(std::vector<int>& offsets)
+{
+  for (size_t i = 1; i < offsets.size(); ++i)
+    offsets[i] += offsets[i - 1];
+}
+
+static void getElemVerts(Mesh* m, MeshTag* ids, MeshArrays& a)
+{
+  int ne = a.elems.size();
+  a.elemTypes.resize(ne);
+  CSR& ev = a.elemVerts;
+  ev.offsets.assign(ne + 1, 0);
+  for (int i = 0; i < ne; ++i) {
+    a.elemTypes[i] = m->getType(a.elems[i]);
+    ev.offsets[i + 1] = Mesh::adjacentCount[a.elemTypes[i]][0];
+  }
+  prefixSum(ev.offsets);
+  ev.items.resize(ev.offsets[ne]);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < ne; ++i) {
+    Downward dv;
+    int nv = m->getDownward(a.elems[i], 0, dv);
+    for (int j = 0; j < nv; ++j)
+      m->getIntTag(dv[j], ids, &ev.items[ev.offsets[i] + j]);
+  }
+}
+
+/* elements sharing a facet, found through the upward
+   adjacency of each facet: a count pass and a fill pass */
+static int getFacetNeighbors(Mesh* m, MeshTag* ids, MeshEntity* e,
+    int dim, int* out)
+{
+  Downward facets;
+  int nf = m->getDownward(e, dim - 1, facets);
+  int n = 0;
+  for (int j = 0; j < nf; ++j) {
+    Up up;
+    m->getUp(facets[j], up);
+    for (int k = 0; k < up.n; ++k) {
+      if (up.e[k] == e)
+        continue;
+      if (out)
+        m->getIntTag(up.e[k], ids, &out[n]);
+      ++n;
+    }
+  }
+  return n;
+}
+
+static void getElemElems(Mesh* m, MeshTag* ids, int dim, MeshArrays& a)
+{
+  int ne = a.elems.size();
+  CSR& ee = a.elemElems;
+  ee.offsets.assign(ne + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < ne; ++i)
+    ee.offsets[i + 1] = getFacetNeighbors(m, ids, a.elems[i], dim, 0);
+  prefixSum(ee.offsets);
+  ee.items.resize(ee.offsets[ne]);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < ne; ++i)
+    getFacetNeighbors(m, ids, a.elems[i], dim, &ee.items[ee.offsets[i]]);
+}
+
+static void getVertVerts(Mesh* m, MeshTag* ids, MeshArrays& a)
+{
+  int nv = a.verts.size();
+  std::vector<int> ends;
+  ends.reserve(m->count(1) * 2);
+  MeshIterator* it = m->begin(1);
+  MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    MeshEntity* ev[2];
+    m->getDownward(e, 0, ev);
+    for (int j = 0; j < 2; ++j) {
+      int i;
+      m->getIntTag(ev[j], ids, &i);
+      ends.push_back(i);
+    }
+  }
+  m->end(it);
+  CSR& vv = a.vertVerts;
+  vv.offsets.assign(nv + 1, 0);
+  for (size_t i = 0; i < ends.size(); ++i)
+    ++vv.offsets[ends[i] + 1];
+  prefixSum(vv.offsets);
+  vv.items.resize(ends.size());
+  std::vector<int> fill(vv.offsets.begin(), vv.offsets.end() - 1);
+  for (size_t i = 0; i < ends.size(); i += 2) {
+    vv.items[fill[ends[i]]++] = ends[i + 1];
+    vv.items[fill[ends[i + 1]]++] = ends[i];
+  }
+}
+
+static void getCoords(Mesh* m, MeshArrays& a)
+{
+  int nv = a.verts.size();
+  a.coords.resize(nv * 3);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i = 0; i < nv; ++i) {
+    Vector3 x;
+    m->getPoint(a.verts[i], 0, x);
+    x.toArray(&a.coords[i * 3]);
+  }
+}
+
+void exportMeshArrays(Mesh* m, MeshArrays& a, int which, int cellDim)
+{
+  if (cellDim == -1)
+    cellDim = m->getDimension();
+  a.dim = cellDim;
+  MeshTag* ids = m->createIntTag("apf_csr_id", 1);
+  numberOwnedFirst(m, 0, ids, a.verts, a.ownedVerts);
+  if (cellDim)
+    numberOwnedFirst(m, cellDim, ids, a.elems, a.ownedElems);
+  else {
+    a.elems = a.verts;
+    a.ownedElems = a.ownedVerts;
+  }
+  getGlobals(m, ids, a.verts, a.ownedVerts, a.vertGlobals);
+  if (cellDim)
+    getGlobals(m, ids, a.elems, a.ownedElems, a.elemGlobals);
+  else
+    a.elemGlobals = a.vertGlobals;
+  getElemVerts(m, ids, a);
+  if ((which & EXPORT_ELEM_ELEM) && cellDim > 0)
+    getElemElems(m, ids, cellDim, a);
+  if ((which & EXPORT_VERT_VERT) && cellDim > 0)
+    getVertVerts(m, ids, a);
+  if (which & EXPORT_COORDS)
+    getCoords(m, a);
+  removeTagFromDimension(m, ids, 0);
+  if (cellDim)
+    removeTagFromDimension(m, ids, cellDim);
+  m->destroyTag(ids);
+}
+
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef APF_CSR_H
+#define APF_CSR_H
+
+/** \file apfCSR.h
+  \brief bulk export of mesh topology as flat arrays */
+
+#include <vector>
+
+namespace apf {
+
+class Mesh;
+class MeshEntity;
+
+/** \brief compressed sparse row adjacency
+  \details the neighbors of row i are
+  items[offsets[i]] through items[offsets[i+1]-1] */
+struct CSR
+{
+  std::vector<int> offsets;
+  std::vector<int> items;
+  /** \brief the number of rows */
+  int rows() const {return offsets.empty() ? 0 : offsets.size() - 1;}
+};
+
+/** \brief selects the optional arrays built by apf::exportMeshArrays */
+enum
+{
+  /** \brief vertex coordinates, 3 per vertex */
+  EXPORT_COORDS = 1,
+  /** \brief elements sharing a facet with each element */
+  EXPORT_ELEM_ELEM = 2,
+  /** \brief vertices sharing an edge with each vertex */
+  EXPORT_VERT_VERT = 4,
+  EXPORT_ALL = 7
+};
+
+/** \brief flat topology of one part for solver coupling
+  \details local ids are ordered with owned entities first,
+  in iteration order, followed by the non-owned copies.
+  Global ids of owned entities are the part offset plus the local id,
+  which matches apf::makeGlobal(apf::numberOwnedNodes(...))
+  for the vertices of a linear mesh.
+  All adjacency arrays hold local ids. */
+struct MeshArrays
+{
+  int dim;
+  int ownedVerts;
+  int ownedElems;
+  std::vector<MeshEntity*> verts;
+  std::vector<MeshEntity*> elems;
+  std::vector<long> vertGlobals;
+  std::vector<long> elemGlobals;
+  /** \brief the apf::Mesh::Type of each element */
+  std::vector<int> elemTypes;
+  std::vector<double> coords;
+  CSR elemVerts;
+  CSR elemElems;
+  CSR vertVerts;
+};
+
+/** \brief export local and global numbering and CSR adjacencies
+  \details everything is computed in one traversal per entity
+  dimension and one PCU exchange for the global ids of shared
+  vertices, so this is collective and must be called on every
+  rank. When built with OpenMP, the adjacency fills run on
+  threads and only read the mesh.
+  \param m the mesh, which must not be modified during the call
+  \param a the output arrays
+  \param which a bitwise or of the EXPORT_ flags
+  \param cellDim the dimension of the exported elements,
+                 defaults to the mesh dimension */
+void exportMeshArrays(Mesh* m, MeshArrays& a, int which = EXPORT_ALL,
+    int cellDim = -1);
+
+}
+
+#endif
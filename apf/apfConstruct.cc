@@ -1,9 +1,12 @@
 #include <PCU.h>
 #include "apfConvert.h"
+#include "apfCSR.h"
 #include "apfMesh2.h"
 #include "apf.h"
 #include "apfNumbering.h"
 #include <map>
+#include <vector>
+#include <algorithm>
 
 namespace apf {
 
@@ -25,14 +28,13 @@ static void constructElements(
     GlobalToVert& globalToVert)
 {
   ModelEntity* interior = m->findModelEntity(m->getDimension(), 0);
-  int nev = apf::Mesh::adjacentCount[etype][0];
-  for (int i = 0; i < nelem; ++i) {
-    Downward verts;
-    int offset = i * nev;
-    for (int j = 0; j < nev; ++j)
-      verts[j] = globalToVert[conn[j + offset]];
-    buildElement(m, interior, etype, verts);
-  }
+  int end = nelem * apf::Mesh::adjacentCount[etype][0];
+  if (!end)
+    return;
+  std::vector<MeshEntity*> verts(end);
+  for (int i = 0; i < end; ++i)
+    verts[i] = globalToVert[conn[i]];
+  buildElements(m, interior, etype, nelem, &verts[0]);
 }
 
 static Gid getMax(const GlobalToVert& globalToVert)
@@ -250,26 +252,16 @@ void setCoords(Mesh2* m, const double* coords, int nverts,
 
 void destruct(Mesh2* m, int*& conn, int& nelem, int &etype, int cellDim)
 {
-  if(cellDim == -1) cellDim = m->getDimension();
-  //int dim = m->getDimension();
-  nelem = m->count(cellDim);
+  MeshArrays a;
+  exportMeshArrays(m, a, 0, cellDim);
+  nelem = a.elems.size();
   conn = 0;
-  GlobalNumbering* global = makeGlobal(numberOwnedNodes(m, "apf_destruct"));
-  synchronize(global);
-  MeshIterator* it = m->begin(cellDim);
-  MeshEntity* e;
-  int i = 0;
-  while ((e = m->iterate(it))) {
-    etype = m->getType(e);
-    Downward verts;
-    int nverts = m->getDownward(e, 0, verts);
-    if (!conn)
-      conn = new Gid[nelem * nverts];
-    for (int j = 0; j < nverts; ++j)
-      conn[i++] = getNumber(global, Node(verts[j], 0));
-  }
-  m->end(it);
-  destroyGlobalNumbering(global);
+  if (!nelem)
+    return;
+  etype = a.elemTypes[nelem - 1];
+  conn = new Gid[a.elemVerts.items.size()];
+  for (size_t i = 0; i < a.elemVerts.items.size(); ++i)
+    conn[i] = a.vertGlobals[a.elemVerts.items[i]];
 }
 
 void extractCoords(Mesh2* m, double*& coords, int& nverts)
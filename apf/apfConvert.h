@@ -78,7 +78,9 @@ void setCoords(Mesh2* m, const double* coords, int nverts,
     GlobalToVert& globalToVert);
 
 /** \brief convert an apf::Mesh2 object into a connectivity array
-  \details this is useful for debugging the apf::convert function
+  \details this is useful for debugging the apf::convert function.
+  It numbers the vertices globally with apf::exportMeshArrays,
+  so it is collective and must be called on every rank.
   \param mesh the apf mesh
   \param nelem number of elements
   \param etype apf::Mesh::Type
@@ -87,7 +89,10 @@ void setCoords(Mesh2* m, const double* coords, int nverts,
 void destruct(Mesh2* m, int*& conn, int& nelem, int &etype, int cellDim = -1);
 
 /** \brief get a contiguous set of global vertex coordinates
-  \details this is used for debugging apf::setCoords */
+  \details this is used for debugging apf::setCoords.
+  The coordinates of owned vertices are listed in iteration order,
+  which is the order of their global ids from apf::destruct.
+  This is a local operation. */
 void extractCoords(Mesh2* m, double*& coords, int& nverts);
 
 }
@@ -11,6 +11,8 @@
 #include "apfShape.h"
 #include "apfMesh.h"
 #include "apfVectorElement.h"
+#include "apfIntegrate.h"
+#include "apfTabulation.h"
 
 namespace apf {
 
@@ -23,6 +25,13 @@ void Element::init(Field* f, MeshEntity* e, VectorElement* p)
   parent = p;
   nen = shape->countNodes();
   nc = f->countComponents();
+  intRule = 0;
+  intPoint = 0;
+  tableRule = 0;
+  table = 0;
+  tableValues = 0;
+  tableGradients = 0;
+  tableVectorValues = 0;
   getNodeData();
 }
 
@@ -83,7 +92,7 @@ void Element::getGlobalGradients(Vector3 const& local,
   parent->getJacobian(local,J);
   Matrix3x3 jinv = getJacobianInverse(J, getDimension());
   NewArray<Vector3> localGradients;
-  shape->getLocalGradients(mesh, entity, local,localGradients);
+  getLocalGradients(local,localGradients);
   globalGradients.allocate(nen);
   for (int i=0; i < nen; ++i)
     globalGradients[i] = jinv * localGradients[i];
@@ -105,7 +114,7 @@ void Element::getComponents(Vector3 const& xi, double* c)
   // handle cases with scalar shape functions
   else {
     NewArray<double> shapeValues;
-    shape->getValues(mesh, entity, xi, shapeValues);
+    getShapeValues(xi, shapeValues);
     for (int ci = 0; ci < nc; ++ci)
       c[ci] = 0;
     for (int ni = 0; ni < nen; ++ni)
@@ -114,6 +123,91 @@ void Element::getComponents(Vector3 const& xi, double* c)
   }
 }
 
+void Element::setIntPoint(Integration const* in, int point)
+{
+  intRule = in;
+  intPoint = point;
+}
+
+static bool isSamePoint(Vector3 const& a, Vector3 const& b)
+{
+  return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+/* field elements follow the integration point of their mesh element.
+   the table is looked up again only when the integration rule
+   changes, and stays null for shapes that cannot be tabulated */
+Tabulation* Element::findTabulation(Vector3 const& xi, int& point)
+{
+  Element* me = parent;
+  if (!me)
+    me = this;
+  Integration const* in = me->intRule;
+  if (!in)
+    return 0;
+  point = me->intPoint;
+  if (!isSamePoint(in->getPoint(point)->param, xi))
+    return 0;
+  if (in != tableRule) {
+    tableRule = in;
+    table = 0;
+    tableValues = 0;
+    tableGradients = 0;
+    tableVectorValues = 0;
+    if (field->getShape()->canTabulate(getType()))
+      table = getTabulation(shape, in);
+  }
+  return table;
+}
+
+void Element::getShapeValues(Vector3 const& xi, NewArray<double>& values)
+{
+  int point;
+  Tabulation* t = findTabulation(xi, point);
+  if (!t) {
+    shape->getValues(mesh, entity, xi, values);
+    return;
+  }
+  if (!tableValues)
+    tableValues = t->getValues(0);
+  double const* v = tableValues + point * nen;
+  values.allocate(nen);
+  for (int i = 0; i < nen; ++i)
+    values[i] = v[i];
+}
+
+void Element::getLocalGradients(Vector3 const& xi, NewArray<Vector3>& grads)
+{
+  int point;
+  Tabulation* t = findTabulation(xi, point);
+  if (!t) {
+    shape->getLocalGradients(mesh, entity, xi, grads);
+    return;
+  }
+  if (!tableGradients)
+    tableGradients = t->getLocalGradients(0);
+  Vector3 const* g = tableGradients + point * nen;
+  grads.allocate(nen);
+  for (int i = 0; i < nen; ++i)
+    grads[i] = g[i];
+}
+
+void Element::getVectorValues(Vector3 const& xi, NewArray<Vector3>& values)
+{
+  int point;
+  Tabulation* t = findTabulation(xi, point);
+  if (!t) {
+    shape->getVectorValues(mesh, entity, xi, values);
+    return;
+  }
+  if (!tableVectorValues)
+    tableVectorValues = t->getVectorValues(0);
+  Vector3 const* v = tableVectorValues + point * nen;
+  values.allocate(nen);
+  for (int i = 0; i < nen; ++i)
+    values[i] = v[i];
+}
+
 void Element::getNodeData()
 {
   field->getData()->getElementData(entity,nodeData);
@@ -17,6 +17,8 @@ namespace apf {
 class EntityShape;
 class FieldShape;
 class VectorElement;
+class Integration;
+class Tabulation;
 
 class Element
 {
@@ -36,9 +38,17 @@ class Element
     FieldShape* getFieldShape() {return field->getShape();}
     void getComponents(Vector3 const& xi, double* c);
     void getElementNodeData(NewArray<double>& d);
+    /* shape function queries that read the tabulation of the
+       current integration point when xi is that point */
+    void getShapeValues(Vector3 const& xi, NewArray<double>& values);
+    void getLocalGradients(Vector3 const& xi, NewArray<Vector3>& grads);
+    void getVectorValues(Vector3 const& xi, NewArray<Vector3>& values);
+    /* called by apf::getIntPoint on mesh elements */
+    void setIntPoint(Integration const* in, int point);
   protected:
     void init(Field* f, MeshEntity* e, VectorElement* p);
     void getNodeData();
+    Tabulation* findTabulation(Vector3 const& xi, int& point);
     Field* field;
     Mesh* mesh;
     MeshEntity* entity;
@@ -47,6 +57,15 @@ class Element
     int nen;
     int nc;
     NewArray<double> nodeData;
+    Integration const* intRule;
+    int intPoint;
+    Integration const* tableRule;
+    Tabulation* table;
+    /* first point of each tabulated quantity, kept so that
+       shared tables are locked once per element, not per point */
+    double const* tableValues;
+    Vector3 const* tableGradients;
+    Vector3 const* tableVectorValues;
 };
 
 Matrix3x3 getJacobianInverse(Matrix3x3 J, int dim);
@@ -281,7 +281,11 @@ static void getTi(
   static apf::NewArray<double> transformR[apf::Mesh::TYPES][MAX_ORDER+1];
   int n = type == apf::Mesh::TRIANGLE ? countTriNodes(P) : countTetNodes(P);
 
-  // get the transform matrices if the are not already computed
+  // get the transform matrices if the are not already computed,
+  // one thread at a time
+#ifdef _OPENMP
+#pragma omp critical(apf_h1_transforms)
+#endif
   if (!transformQ[type][P].allocated()) {
     mth::Matrix<double> LQ(n,n);
     mth::Matrix<double> LR(n,n);
@@ -652,6 +656,7 @@ class H1Shape: public FieldShape {
       }
     }
     int getOrder() {return P;}
+    bool canTabulate(int) {return true;}
     void getNodeXi(int type, int node, Vector3& xi)
     {
       xi = getH1NodeXi(type, P, node);
@@ -297,6 +297,7 @@ class Hierarchic2 : public FieldShape {
         return 0;
     }
     int getOrder() {return 2;}
+    bool canTabulate(int) {return true;}
 };
 
 class Hierarchic3 : public FieldShape
@@ -147,7 +147,11 @@ static void getTi(
   static apf::NewArray<double> transformR[apf::Mesh::TYPES][MAX_ND_ORDER+1];
   int n = type == apf::Mesh::TRIANGLE ? countTriNodes(P) : countTetNodes(P);
 
-  // get the transform matrices if the are not already computed
+  // get the transform matrices if the are not already computed,
+  // one thread at a time
+#ifdef _OPENMP
+#pragma omp critical(apf_l2_transforms)
+#endif
   if (!transformQ[type][P].allocated()) {
     mth::Matrix<double> LQ(n,n);
     mth::Matrix<double> LR(n,n);
@@ -270,6 +274,7 @@ class L2ShapeTri: public FieldShape {
       return 0;
     }
     int getOrder() {return P;}
+    bool canTabulate(int) {return true;}
     void getNodeXi(int type, int node, Vector3& xi)
     {
       PCU_ALWAYS_ASSERT_VERBOSE(type == Mesh::TRIANGLE,
@@ -393,6 +398,7 @@ class L2ShapeTet: public FieldShape {
       return 0;
     }
     int getOrder() {return P;}
+    bool canTabulate(int) {return true;}
     void getNodeXi(int type, int node, Vector3& xi)
     {
       PCU_ALWAYS_ASSERT_VERBOSE(type == Mesh::TET,
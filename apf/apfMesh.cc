@@ -288,6 +288,38 @@ void Mesh::getPoint(MeshEntity* e, int node, Vector3& p)
   getVector(coordinateField,e,node,p);
 }
 
+static void flatten(Copies const& from, FlatCopies& to)
+{
+  to.clear();
+  to.reserve(from.size());
+  APF_CONST_ITERATE(Copies, from, it)
+    to.push_back(Copy(it->first, it->second));
+}
+
+void Mesh::getFlatRemotes(MeshEntity* e, FlatCopies& remotes)
+{
+  Copies copies;
+  getRemotes(e, copies);
+  flatten(copies, remotes);
+}
+
+void Mesh::getFlatGhosts(MeshEntity* e, FlatCopies& ghosts)
+{
+  Copies copies;
+  getGhosts(e, copies);
+  flatten(copies, ghosts);
+}
+
+void Mesh::getFlatResidence(MeshEntity* e, FlatParts& residence)
+{
+  Parts parts;
+  getResidence(e, parts);
+  residence.clear();
+  residence.reserve(parts.size());
+  APF_ITERATE(Parts, parts, it)
+    residence.push_back(*it);
+}
+
 FieldShape* Mesh::getShape() const
 {
   return coordinateField->getShape();
@@ -396,6 +428,22 @@ void unite(Parts& into, Parts const& from)
   into.insert(from.begin(),from.end());
 }
 
+MeshEntity* findCopy(FlatCopies const& copies, int peer)
+{
+  Copy const* b = copies.begin();
+  Copy const* e = copies.end();
+  while (b < e) {
+    Copy const* mid = b + (e - b) / 2;
+    if (mid->peer < peer)
+      b = mid + 1;
+    else
+      e = mid;
+  }
+  if (b != copies.end() && b->peer == peer)
+    return b->entity;
+  return 0;
+}
+
 void getPeers(Mesh* m, int d, Parts& peers)
 {
   PCU_ALWAYS_ASSERT(d < m->getDimension());
@@ -754,11 +802,10 @@ void unfreezeFields(Mesh* m) {
 
 Copy getOtherCopy(Mesh* m, MeshEntity* s)
 {
-  Copies remotes;
-  m->getRemotes(s,remotes);
+  FlatCopies remotes;
+  m->getFlatRemotes(s,remotes);
   PCU_ALWAYS_ASSERT(remotes.size()==1);
-  Copies::iterator it = remotes.begin();
-  return Copy(it->first, it->second);
+  return remotes[0];
 }
 
 int getDimension(Mesh* m, MeshEntity* e)
@@ -872,16 +919,11 @@ void warnAboutEmptyParts(Mesh* m)
 
 static void getRemotesArray(Mesh* m, MeshEntity* e, CopyArray& a)
 {
-  Copies remotes;
-  m->getRemotes(e, remotes);
+  FlatCopies remotes;
+  m->getFlatRemotes(e, remotes);
   a.setSize(remotes.size());
-  size_t i = 0;
-  APF_ITERATE(Copies, remotes, it) 
-  {
-    a[i].peer = it->first;
-    a[i].entity = it->second;
-    ++i;
-  }
+  for (unsigned i = 0; i < remotes.size(); ++i)
+    a[i] = remotes[i];
 }
 
 NormalSharing::NormalSharing(Mesh* m):mesh(m) {}
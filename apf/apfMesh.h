@@ -16,6 +16,7 @@
 #include <set>
 #include "apfVector.h"
 #include "apfDynamicArray.h"
+#include "apfSmallArray.h"
 
 struct gmi_model;
 
@@ -92,6 +93,12 @@ typedef DynamicArray<Copy> CopyArray;
 typedef CopyArray Matches;
 /** \brief a set of DG copies */
 typedef CopyArray DgCopies;
+/** \brief flat remote copy container
+  \details holds the same copies as apf::Copies, in increasing
+  part order, but does not allocate for entities with few copies */
+typedef SmallArray<Copy,8> FlatCopies;
+/** \brief flat set of unique part ids, in increasing order */
+typedef SmallArray<int,8> FlatParts;
 
 /** \brief Interface to a mesh part
   \details This base class is the interface for almost all mesh
@@ -223,6 +230,16 @@ class Mesh
       \details this includes parts with remote copies and the
                current part as well */
     virtual void getResidence(MeshEntity* e, Parts& residence) = 0;
+    /** \brief Get the remote copies of an entity without allocating
+      \details remotes is cleared first. The default adapts
+               getRemotes, databases should override it */
+    virtual void getFlatRemotes(MeshEntity* e, FlatCopies& remotes);
+    /** \brief Get the ghost copies of an entity without allocating
+      \details see getFlatRemotes */
+    virtual void getFlatGhosts(MeshEntity* e, FlatCopies& ghosts);
+    /** \brief Get the resident parts of an entity without allocating
+      \details see getFlatRemotes */
+    virtual void getFlatResidence(MeshEntity* e, FlatParts& residence);
     /** \brief Creates a double array tag over the mesh given a name and size */
     virtual MeshTag* createDoubleTag(const char* name, int size) = 0;
     /** \brief Creates an int array tag over the mesh given a name and size */
@@ -418,6 +435,11 @@ int getDimension(Mesh* m, MeshEntity* e);
   \param into becomes the union */
 void unite(Parts& into, Parts const& from);
 
+/** \brief find the copy of an entity on a part
+  \returns the on-part pointer of the copy, or zero if
+  there is no copy on that part */
+MeshEntity* findCopy(FlatCopies const& copies, int peer);
+
 /** \brief removes a tag from all entities of dimension (d) */
 void removeTagFromDimension(Mesh* m, MeshTag* tag, int d);
 
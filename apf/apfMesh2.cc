@@ -7,6 +7,8 @@
 #include "apfShape.h"
 #include "apfTagData.h"
 #include "apfNumbering.h"
+#include <algorithm>
+#include <vector>
 
 namespace apf
 {
@@ -14,6 +16,37 @@ namespace apf
 void Mesh2::setPoint(MeshEntity* e, int node, Vector3 const& p)
 {
   setVector(Mesh::coordinateField,e,node,p);
+  if (!modifyCallbacks.empty())
+    notifyMoved(e);
+}
+
+void Mesh2::addModifyCallback(ModifyCallback* cb)
+{
+  modifyCallbacks.push_back(cb);
+}
+
+void Mesh2::removeModifyCallback(ModifyCallback* cb)
+{
+  modifyCallbacks.erase(std::remove(modifyCallbacks.begin(),
+        modifyCallbacks.end(), cb), modifyCallbacks.end());
+}
+
+void Mesh2::notifyCreated_(MeshEntity* e)
+{
+  for (size_t i = 0; i < modifyCallbacks.size(); ++i)
+    modifyCallbacks[i]->created(e);
+}
+
+void Mesh2::notifyDestroying_(MeshEntity* e)
+{
+  for (size_t i = 0; i < modifyCallbacks.size(); ++i)
+    modifyCallbacks[i]->destroying(e);
+}
+
+void Mesh2::notifyMoved(MeshEntity* e)
+{
+  for (size_t i = 0; i < modifyCallbacks.size(); ++i)
+    modifyCallbacks[i]->moved(e);
 }
 
 MeshEntity* Mesh2::createVertex(ModelEntity* c, Vector3 const& point,
@@ -30,6 +63,11 @@ void displaceMesh(Mesh2* m, Field* d, double factor)
   m->getCoordinateField()->axpy(factor,d);
 }
 
+void Mesh2::reserve(std::size_t const counts[TYPES])
+{
+  (void)counts;
+}
+
 MeshEntity* makeOrFind(
     Mesh2* m,
     ModelEntity* c,
@@ -82,6 +120,218 @@ MeshEntity* buildElement(
   return b.run(type,verts);
 }
 
+/* open addressing over the sorted vertices of an entity,
+   kept at most half full */
+class BulkTable
+{
+  public:
+    enum { MAX_KEY = 4 };
+    struct Slot
+    {
+      MeshEntity* key[MAX_KEY];
+      int n;
+      MeshEntity* value;
+    };
+    BulkTable():
+      slots(1 << 10),
+      used(0)
+    {
+    }
+    Slot& find(MeshEntity* const* key, int n)
+    {
+      size_t mask = slots.size() - 1;
+      size_t i = hash(key, n) & mask;
+      while (slots[i].n && !matches(slots[i], key, n))
+        i = (i + 1) & mask;
+      return slots[i];
+    }
+    /* fills a slot returned by find, after which
+       slots may move */
+    void insert(Slot& s, MeshEntity* const* key, int n, MeshEntity* value)
+    {
+      for (int i = 0; i < n; ++i)
+        s.key[i] = key[i];
+      s.n = n;
+      s.value = value;
+      if (++used * 2 > slots.size())
+        rehash();
+    }
+  private:
+    static size_t hash(MeshEntity* const* key, int n)
+    {
+      size_t h = n;
+      for (int i = 0; i < n; ++i)
+        h ^= reinterpret_cast<size_t>(key[i]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+      h ^= h >> 16;
+      h *= 0x45d9f3b;
+      h ^= h >> 16;
+      return h;
+    }
+    static bool matches(Slot const& s, MeshEntity* const* key, int n)
+    {
+      if (s.n != n)
+        return false;
+      for (int i = 0; i < n; ++i)
+        if (s.key[i] != key[i])
+          return false;
+      return true;
+    }
+    void rehash()
+    {
+      std::vector<Slot> old(slots.size() * 2);
+      old.swap(slots);
+      for (size_t i = 0; i < old.size(); ++i)
+        if (old[i].n) {
+          Slot& s = find(old[i].key, old[i].n);
+          s = old[i];
+        }
+    }
+    std::vector<Slot> slots;
+    size_t used;
+};
+
+static int getSortedVerts(Mesh* m, int type, MeshEntity** down,
+    MeshEntity** key)
+{
+  if (type == Mesh::EDGE) {
+    key[0] = std::min(down[0], down[1]);
+    key[1] = std::max(down[0], down[1]);
+    return 2;
+  }
+  /* each vertex of a face starts one of its edges */
+  int ne = Mesh::adjacentCount[type][1];
+  int n = 0;
+  for (int i = 0; i < ne; ++i) {
+    MeshEntity* ends[2];
+    m->getDownward(down[i], 0, ends);
+    for (int j = 0; j < 2; ++j) {
+      int k = n;
+      while (k > 0 && key[k - 1] > ends[j])
+        --k;
+      if (k > 0 && key[k - 1] == ends[j])
+        continue;
+      for (int l = n; l > k; --l)
+        key[l] = key[l - 1];
+      key[k] = ends[j];
+      ++n;
+    }
+  }
+  return n;
+}
+
+class BulkOp : public ElementVertOp
+{
+  public:
+    BulkOp(Mesh2* m, ModelEntity* c, BuildCallback* cb,
+        BulkTable* e, BulkTable* v, bool f):
+      mesh(m),
+      model(c),
+      callback(cb),
+      entities(e),
+      verts(v),
+      fresh(f)
+    {
+    }
+    virtual MeshEntity* apply(int type, MeshEntity** down)
+    {
+      /* nothing contains regions, so only a repeated region
+         could be found again */
+      if (Mesh::typeDimension[type] == 3)
+        return makeOrCreate(type, down, fresh);
+      MeshEntity* key[BulkTable::MAX_KEY];
+      int n = getSortedVerts(mesh, type, down, key);
+      BulkTable::Slot& s = entities->find(key, n);
+      if (s.n)
+        return s.value;
+      MeshEntity* e = makeOrCreate(type, down, isFresh(key, n));
+      entities->insert(s, key, n, e);
+      return e;
+    }
+  private:
+    bool isFresh(MeshEntity** key, int n)
+    {
+      for (int i = 0; i < n; ++i)
+        if (verts->find(key + i, 1).value)
+          return true;
+      return false;
+    }
+    MeshEntity* makeOrCreate(int type, MeshEntity** down, bool isNew)
+    {
+      if (!isNew) {
+        MeshEntity* e = findUpward(mesh, type, down);
+        if (e)
+          return e;
+      }
+      MeshEntity* e = mesh->createEntity(type, model, down);
+      if (callback)
+        callback->call(e);
+      return e;
+    }
+    Mesh2* mesh;
+    ModelEntity* model;
+    BuildCallback* callback;
+    BulkTable* entities;
+    BulkTable* verts;
+    bool fresh;
+};
+
+BulkBuilder::BulkBuilder(Mesh2* m, BuildCallback* cb):
+  mesh(m),
+  callback(cb),
+  entities(new BulkTable()),
+  verts(new BulkTable())
+{
+}
+
+BulkBuilder::~BulkBuilder()
+{
+  delete entities;
+  delete verts;
+}
+
+/* vertices without upward adjacencies when first seen are new,
+   and so is anything built on one of them. The verts table maps
+   each seen vertex to itself if it is new and to zero if not */
+MeshEntity* BulkBuilder::build(ModelEntity* c, int type,
+    MeshEntity** elementVerts)
+{
+  int nv = Mesh::adjacentCount[type][0];
+  bool fresh = false;
+  for (int i = 0; i < nv; ++i) {
+    MeshEntity* v = elementVerts[i];
+    BulkTable::Slot& s = verts->find(&v, 1);
+    if (!s.n)
+      verts->insert(s, &v, 1, mesh->hasUp(v) ? 0 : v);
+    if (verts->find(&v, 1).value)
+      fresh = true;
+  }
+  BulkOp op(mesh, c, callback, entities, verts, fresh);
+  return op.run(type, elementVerts);
+}
+
+void buildElements(
+    Mesh2* m,
+    ModelEntity* c,
+    int type,
+    int nelem,
+    MeshEntity* const* conn,
+    MeshEntity** elems)
+{
+  std::size_t counts[Mesh::TYPES] = {};
+  counts[type] = nelem;
+  m->reserve(counts);
+  int nv = Mesh::adjacentCount[type][0];
+  BulkBuilder b(m);
+  for (int i = 0; i < nelem; ++i) {
+    Downward v;
+    for (int j = 0; j < nv; ++j)
+      v[j] = conn[i * nv + j];
+    MeshEntity* e = b.build(c, type, v);
+    if (elems)
+      elems[i] = e;
+  }
+}
+
 MeshEntity* buildOneElement(
     Mesh2* m,
     ModelEntity* c,
@@ -155,10 +405,10 @@ static void packProposal(Mesh* m, MeshEntity* e, int to)
   Downward down;
   int nd = m->getDownward(e, d - 1, down);
   PCU_COMM_PACK(to,nd);
+  FlatCopies remotes;
   for (int i = 0; i < nd; ++i) {
-    Copies remotes;
-    m->getRemotes(down[i], remotes);
-    MeshEntity* dr = remotes[to];
+    m->getFlatRemotes(down[i], remotes);
+    MeshEntity* dr = findCopy(remotes, to);
     PCU_COMM_PACK(to,dr);
   }
 }
@@ -339,6 +589,16 @@ void clear(Mesh2* m) {
   for (size_t i = 0; i < tags.getSize(); ++i) {
     m->destroyTag(tags[i]);
   }
+  /* top down, as entities are destroyed, so that callbacks
+     never see an entity after it has been reported */
+  if (!m->modifyCallbacks.empty())
+    for (int d = m->getDimension(); d >= 0; --d) {
+      MeshIterator* it = m->begin(d);
+      MeshEntity* e;
+      while ((e = m->iterate(it)))
+        m->notifyDestroying_(e);
+      m->end(it);
+    }
   m->clear_();
 }
 
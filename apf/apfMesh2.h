@@ -16,6 +16,8 @@
 
 namespace apf {
 
+class ModifyCallback;
+
 /** \brief Extended mesh interface for modification
   \details this interface, which is a superset of apf::Mesh,
   includes methods for mesh modification.
@@ -79,7 +81,9 @@ class Mesh2 : public Mesh
     MeshEntity* createVert(ModelEntity* c)
     {
       requireUnfrozen();
-      return createVert_(c);
+      MeshEntity* v = createVert_(c);
+      notifyCreated(v);
+      return v;
     }
 /** \brief Underlying implementation of apf::Mesh2::createEntity */
     virtual MeshEntity* createEntity_(int type, ModelEntity* c,
@@ -93,8 +97,17 @@ class Mesh2 : public Mesh
     MeshEntity* createEntity(int type, ModelEntity* c, MeshEntity** down)
     {
       requireUnfrozen();
-      return createEntity_(type,c,down);
+      MeshEntity* e = createEntity_(type,c,down);
+      notifyCreated(e);
+      return e;
     }
+/** \brief make room for entities that are about to be created
+  \details implementations may allocate once here instead of
+  growing their storage as entities are created. The default
+  does nothing.
+  \param counts the number of new entities of each
+         apf::Mesh::Type that are expected */
+    virtual void reserve(std::size_t const counts[TYPES]);
 /** \brief Underlying implementation of apf::Mesh2::destroy */
     virtual void destroy_(MeshEntity* e) = 0;
 /** \brief Destroy a mesh entity
@@ -103,6 +116,7 @@ class Mesh2 : public Mesh
     void destroy(MeshEntity* e)
     {
       requireUnfrozen();
+      notifyDestroying(e);
       destroy_(e);
     }
 /** \brief Change the geometric classification of an entity. */
@@ -118,6 +132,30 @@ class Mesh2 : public Mesh
   mesh modifications so that all structures are properly updated before
   using the mesh any further. */
     virtual void acceptChanges() = 0;
+/** \brief start telling a callback about entity changes
+  \details entities created with apf::Mesh2::createVert and
+  apf::Mesh2::createEntity, destroyed with apf::Mesh2::destroy,
+  or given nodes with apf::Mesh2::setPoint are reported.
+  Other changes, such as setting remote copies, are not. */
+    void addModifyCallback(ModifyCallback* cb);
+/** \brief stop telling a callback about entity changes */
+    void removeModifyCallback(ModifyCallback* cb);
+  private:
+    void notifyCreated(MeshEntity* e)
+    {
+      if (!modifyCallbacks.empty())
+        notifyCreated_(e);
+    }
+    void notifyDestroying(MeshEntity* e)
+    {
+      if (!modifyCallbacks.empty())
+        notifyDestroying_(e);
+    }
+    void notifyCreated_(MeshEntity* e);
+    void notifyDestroying_(MeshEntity* e);
+    void notifyMoved(MeshEntity* e);
+    std::vector<ModifyCallback*> modifyCallbacks;
+    friend void clear(Mesh2* m);
 };
 
 /** \brief APF's migration function, works on apf::Mesh2
@@ -146,6 +184,54 @@ class Field;
   Setting the factor to -1 will undo the deformation */
 void displaceMesh(Mesh2* m, Field* d, double factor=1.0);
 
+/** \brief User-defined entity modification callback
+  \details see apf::Mesh2::addModifyCallback */
+class ModifyCallback
+{
+  public:
+    virtual ~ModifyCallback() {}
+    /** \brief will be called after an entity is created */
+    virtual void created(MeshEntity* e) = 0;
+    /** \brief will be called before an entity is destroyed */
+    virtual void destroying(MeshEntity* e) = 0;
+    /** \brief will be called after a node of an entity moves */
+    virtual void moved(MeshEntity* e) = 0;
+};
+
+/** \brief Verifies only what changed since its last run
+  \details this watches a mesh through an apf::ModifyCallback,
+  so construct it before the changes it should see.
+  Each run repeats the checks of apf::verify on the entities created
+  since the last run, the entities adjacent to those created or
+  destroyed, and the vertices that moved, then starts over.
+  All cross-part checks share one communication round, after the
+  rounds that compare tag and field information, so the cost
+  follows the size of the change instead of the size of the mesh.
+  Changes that apf::Mesh2 does not report, like new remote copies
+  of an untouched entity, can be added with mark. */
+class IncrementalVerifier : public ModifyCallback
+{
+  public:
+    IncrementalVerifier(Mesh2* m, bool abort_on_error = true);
+    ~IncrementalVerifier();
+    /** \brief collective: verifies the changes and forgets them
+      \returns the number of coordinate and tag mismatches and
+      negative simplex elements found on all parts */
+    long run();
+    /** \brief verify this entity in the next run */
+    void mark(MeshEntity* e);
+    void created(MeshEntity* e);
+    void destroying(MeshEntity* e);
+    void moved(MeshEntity* e);
+  private:
+    IncrementalVerifier(IncrementalVerifier const&);
+    IncrementalVerifier& operator=(IncrementalVerifier const&);
+    Mesh2* mesh;
+    bool abortOnError;
+    std::set<MeshEntity*> changed[4];
+    std::set<MeshEntity*> movedEntities;
+};
+
 /** \brief User-defined entity creation callback */
 class BuildCallback
 {
@@ -176,6 +262,48 @@ MeshEntity* buildElement(
     MeshEntity** verts,
     BuildCallback* cb = 0);
 
+class BulkTable;
+
+/** \brief builds many elements from their vertices
+  \details each call to build has the same result as
+  apf::buildElement, but the intermediate entities that elements
+  share are found by hashing their sorted vertices instead of
+  searching upward adjacencies. Adjacencies are only searched
+  when all vertices of an entity were already in use before the
+  builder first saw them, so building onto an existing mesh still
+  works. Entities among vertices that the builder has seen should
+  not be created through other means while it is in use. */
+class BulkBuilder
+{
+  public:
+    BulkBuilder(Mesh2* m, BuildCallback* cb = 0);
+    ~BulkBuilder();
+    /** \brief build an element, see apf::buildElement */
+    MeshEntity* build(ModelEntity* c, int type, MeshEntity** verts);
+  private:
+    BulkBuilder(BulkBuilder const&);
+    BulkBuilder& operator=(BulkBuilder const&);
+    Mesh2* mesh;
+    BuildCallback* callback;
+    BulkTable* entities;
+    BulkTable* verts;
+};
+
+/** \brief build many elements of one type from their vertices
+  \details this reserves room for the elements with
+  apf::Mesh2::reserve and builds them with an apf::BulkBuilder.
+  \param conn the vertices of element i are
+         conn[i * nv] to conn[i * nv + nv - 1],
+         where nv is apf::Mesh::adjacentCount[type][0]
+  \param elems if not zero, receives the elements */
+void buildElements(
+    Mesh2* m,
+    ModelEntity* c,
+    int type,
+    int nelem,
+    MeshEntity* const* conn,
+    MeshEntity** elems = 0);
+
 /** \brief build a one-element mesh
   \details this is mostly useful for debugging
   \todo this doesn't get used much, maybe remove it */
@@ -56,10 +56,10 @@ static void getAffected(
           m->setIntTag(adjacent[i],tag,&dummy);
           affected[dimension].push_back(adjacent[i]);
         }
-        Copies remotes;
-        m->getRemotes(adjacent[i],remotes);
-        APF_ITERATE(Copies,remotes,rit)
-          PCU_COMM_PACK(rit->first,rit->second);
+        FlatCopies remotes;
+        m->getFlatRemotes(adjacent[i],remotes);
+        for (unsigned j=0; j < remotes.size(); ++j)
+          PCU_COMM_PACK(remotes[j].peer,remotes[j].entity);
         if (m->hasMatching())
         {
           Matches matches;
@@ -315,23 +315,16 @@ static void packReference(
     int to,
     MeshEntity* e)
 {
-  Copies remotes;
-  m->getRemotes(e,remotes);
-  Copies::iterator found = remotes.find(to);
-  if (found!=remotes.end())
+  FlatCopies copies;
+  m->getFlatRemotes(e,copies);
+  MeshEntity* remote = findCopy(copies,to);
+  if (!remote)
   {
-    MeshEntity* remote = found->second;
-    PCU_COMM_PACK(to,remote);
-  }
-  else
-  {
-    Copies ghosts;
-    m->getGhosts(e,ghosts);
-    found = ghosts.find(to);
-    PCU_ALWAYS_ASSERT(found!=ghosts.end());
-    MeshEntity* ghost = found->second;
-    PCU_COMM_PACK(to,ghost);
+    m->getFlatGhosts(e,copies);
+    remote = findCopy(copies,to);
+    PCU_ALWAYS_ASSERT(remote);
   }
+  PCU_COMM_PACK(to,remote);
 }
 
 static void packDownward(Mesh2* m, int to, MeshEntity* e)
@@ -471,45 +471,67 @@ static void computeTetTi(
   mth::decomposeQR(T, Q, R);
 }
 
-static void getTi(
-    int P,
-    int type,
-    mth::Matrix<double>& Q,
-    mth::Matrix<double>& R)
+/* the inverse of Ti, computed once per element type and order
+   from its QR factorization and stored row major, so that
+   evaluating the shapes is one product instead of a solve */
+static double const* getTiInverse(int P, int type)
 {
-
   bool cond = (type == apf::Mesh::TRIANGLE || type == apf::Mesh::TET);
   PCU_ALWAYS_ASSERT_VERBOSE(cond,
       "type should be either apf::Mesh::TRIANGLE or apf::Mesh::TET!");
 
-  static apf::NewArray<double> transformQ[apf::Mesh::TYPES][MAX_ND_ORDER+1];
-  static apf::NewArray<double> transformR[apf::Mesh::TYPES][MAX_ND_ORDER+1];
-  int n = type == apf::Mesh::TRIANGLE ? countTriNodes(P) : countTetNodes(P);
-
-  // get the transform matrices if the are not already computed
-  if (!transformQ[type][P].allocated()) {
-    mth::Matrix<double> LQ(n,n);
-    mth::Matrix<double> LR(n,n);
+  static apf::NewArray<double> transforms[apf::Mesh::TYPES][MAX_ND_ORDER+1];
+  apf::NewArray<double>& t = transforms[type][P];
+  /* threads evaluating shapes may race to fill the cache */
+#ifdef _OPENMP
+#pragma omp critical(apf_nedelec_transforms)
+#endif
+  if (!t.allocated()) {
+    int n = type == apf::Mesh::TRIANGLE ? countTriNodes(P) : countTetNodes(P);
+    mth::Matrix<double> Q(n,n);
+    mth::Matrix<double> R(n,n);
     type == apf::Mesh::TRIANGLE ?
-    	  computeTriangleTi(P, LQ, LR) : computeTetTi(P, LQ, LR);
-
-    transformQ[type][P].allocate(n*n);
-    transformR[type][P].allocate(n*n);
-
-    for (int i = 0; i < n; i++) {
-      for (int j = 0; j < n; j++) {
-	      transformQ[type][P][i*n+j] = LQ(i,j);
-      	transformR[type][P][i*n+j] = LR(i,j);
-      }
+      computeTriangleTi(P, Q, R) : computeTetTi(P, Q, R);
+    t.allocate(n*n);
+    mth::Vector<double> B(n);
+    mth::Vector<double> X(n);
+    for (int j = 0; j < n; j++) {
+      B.zero();
+      B[j] = 1.;
+      mth::solveFromQR(Q, R, B, X);
+      for (int i = 0; i < n; i++)
+        t[i*n+j] = X[i];
     }
   }
+  return &t[0];
+}
 
-  // set Q and R using transformQ and transformR
-  for (int i = 0; i < n; i++) {
-    for (int j = 0; j < n; j++) {
-      Q(i,j) = transformQ[type][P][i*n+j];
-      R(i,j) = transformR[type][P][i*n+j];
-    }
+/* dof counts as compile time constants, matching
+   countTriNodes and countTetNodes */
+template <int P>
+struct NedelecDofs
+{
+  enum {
+    TRIANGLE = P*(P+2),
+    TET = P*(P+2)*(P+3)/2
+  };
+};
+
+/* shapes = Ti^{-1} u, where u holds the D components of the N
+   basis polynomials. the sizes are fixed per order so the
+   compiler can unroll and vectorize the product */
+template <int N, int D>
+static void applyTiInverse(double const* ti, double const (*u)[D],
+    apf::NewArray<apf::Vector3>& shapes)
+{
+  shapes.allocate(N);
+  for (int i = 0; i < N; i++) {
+    double const* row = ti + i*N;
+    double s[3] = {0., 0., 0.};
+    for (int j = 0; j < N; j++)
+      for (int k = 0; k < D; k++)
+        s[k] += row[j] * u[j][k];
+    shapes[i] = apf::Vector3(s[0], s[1], s[2]);
   }
 }
 
@@ -621,14 +643,12 @@ class Nedelec: public FieldShape {
 	  apf::Vector3 const& xi, apf::NewArray<apf::Vector3>& shapes) const
       {
       	const int pm1 = P - 1;
-        const int p = P;
 
-      	apf::NewArray<double> shape_x(p);
-      	apf::NewArray<double> shape_y(p);
-      	apf::NewArray<double> shape_l(p);
+      	double shape_x[P];
+      	double shape_y[P];
+      	double shape_l[P];
 
-        int dof = countNodes();
-        mth::Matrix<double> u(dof, dim);
+        double u[NedelecDofs<P>::TRIANGLE][2];
 
         double x = xi[0]; double y = xi[1];
 
@@ -641,51 +661,31 @@ class Nedelec: public FieldShape {
           for (int i = 0; i + j <= pm1; i++)
           {
             double s = shape_x[i]*shape_y[j]*shape_l[pm1-i-j];
-            u(n,0) = s;  u(n,1) = 0.;  n++;
-            u(n,0) = 0.;  u(n,1) = s;  n++;
+            u[n][0] = s;  u[n][1] = 0.;  n++;
+            u[n][0] = 0.;  u[n][1] = s;  n++;
           }
         for (int j = 0; j <= pm1; j++)
         {
           double s = shape_x[pm1-j]*shape_y[j];
-          u(n,0) = s*(y - c);  u(n,1) = -s*(x - c); n++;
-        }
-
-
-	      mth::Matrix<double> Q(dof, dof);
-      	mth::Matrix<double> R(dof, dof);
-      	getTi(P, apf::Mesh::TRIANGLE, Q, R);
-
-        mth::Matrix<double> S(dof, dim);
-      	for(int i = 0; i < dim; i++) // S = Ti * u
-        {
-          mth::Vector<double> B (dof);
-          mth::Vector<double> X (dof);
-          for (int j = 0; j < dof; j++) B[j] = u(j,i); // populate b in QR x = b
-          mth::solveFromQR(Q, R, B, X);
-          for (int j = 0; j < dof; j++)  S(j,i) = X[j]; // populate S with x
+          u[n][0] = s*(y - c);  u[n][1] = -s*(x - c); n++;
         }
 
-        shapes.allocate(dof);
-        for (int i = 0; i < dof; i++) // populate y
-        {
-      	  shapes[i] = apf::Vector3( S(i,0), S(i,1), 0.0 );
-        }
+        applyTiInverse<NedelecDofs<P>::TRIANGLE, 2>(
+            getTiInverse(P, apf::Mesh::TRIANGLE), u, shapes);
       }
       void getLocalVectorCurls(apf::Mesh* /*m*/, apf::MeshEntity* /*e*/,
-	  apf::Vector3 const& xi, apf::NewArray<apf::Vector3>&) const
+	  apf::Vector3 const& xi, apf::NewArray<apf::Vector3>& curl_shapes) const
       {
       	const int pm1 = P - 1;
-        const int p = P;
 
-      	apf::NewArray<double> shape_x(p);
-      	apf::NewArray<double> shape_y(p);
-      	apf::NewArray<double> shape_l(p);
-      	apf::NewArray<double> dshape_x(p);
-      	apf::NewArray<double> dshape_y(p);
-      	apf::NewArray<double> dshape_l(p);
+      	double shape_x[P];
+      	double shape_y[P];
+      	double shape_l[P];
+      	double dshape_x[P];
+      	double dshape_y[P];
+      	double dshape_l[P];
 
-      	int dof = countNodes();
-        mth::Vector<double> curlu(dof);
+        double curlu[NedelecDofs<P>::TRIANGLE][1];
 
         double x = xi[0]; double y = xi[1];
 
@@ -703,23 +703,22 @@ class Nedelec: public FieldShape {
             const double dy = (dshape_y[j]*shape_l[l] -
                           shape_y[j]*dshape_l[l]) * shape_x[i];
 
-            curlu(n++) = -dy;
-            curlu(n++) =  dx;
+            curlu[n++][0] = -dy;
+            curlu[n++][0] =  dx;
           }
         for (int j = 0; j <= pm1; j++)
         {
           int i = pm1 - j;
           // curl of shape_x(i)*shape_y(j) * (ip.y - c, -(ip.x - c), 0):
-          curlu(n++) = -((dshape_x[i]*(x - c) + shape_x[i]) * shape_y[j] +
+          curlu[n++][0] = -((dshape_x[i]*(x - c) + shape_x[i]) * shape_y[j] +
                      (dshape_y[j]*(y - c) + shape_y[j]) * shape_x[i]);
         }
 
-      	mth::Matrix<double> Q(dof, dof);
-      	mth::Matrix<double> R(dof, dof);
-      	getTi(P, apf::Mesh::TRIANGLE, Q, R);
-
-        mth::Vector<double> X(dof);
-        mth::solveFromQR(Q, R, curlu, X);
+        applyTiInverse<NedelecDofs<P>::TRIANGLE, 1>(
+            getTiInverse(P, apf::Mesh::TRIANGLE), curlu, curl_shapes);
+        // the curl of an in-plane field is normal to the plane
+        for (int i = 0; i < NedelecDofs<P>::TRIANGLE; i++)
+          curl_shapes[i] = apf::Vector3(0., 0., curl_shapes[i][0]);
       }
     };
     class Tetrahedron : public apf::EntityShape
@@ -850,15 +849,13 @@ class Nedelec: public FieldShape {
 	  apf::Vector3 const& xi, apf::NewArray<apf::Vector3>& shapes) const
       {
         const int pm1 = P - 1;
-        const int p = P;
 
-      	apf::NewArray<double> shape_x(p);
-      	apf::NewArray<double> shape_y(p);
-      	apf::NewArray<double> shape_z(p);
-      	apf::NewArray<double> shape_l(p);
+      	double shape_x[P];
+      	double shape_y[P];
+      	double shape_z[P];
+      	double shape_l[P];
 
-        int dof = countNodes();
-        mth::Matrix<double> u(dof, dim);
+        double u[NedelecDofs<P>::TET][3];
 
         double x = xi[0]; double y = xi[1]; double z = xi[2];
 
@@ -873,60 +870,41 @@ class Nedelec: public FieldShape {
             for (int i = 0; i + j + k <= pm1; i++)
             {
               double s = shape_x[i]*shape_y[j]*shape_z[k]*shape_l[pm1-i-j-k];
-                    u(n,0) =  s;  u(n,1) = 0.;  u(n,2) = 0.;  n++;
-                    u(n,0) = 0.;  u(n,1) =  s;  u(n,2) = 0.;  n++;
-                    u(n,0) = 0.;  u(n,1) = 0.;  u(n,2) =  s;  n++;
+                    u[n][0] =  s;  u[n][1] = 0.;  u[n][2] = 0.;  n++;
+                    u[n][0] = 0.;  u[n][1] =  s;  u[n][2] = 0.;  n++;
+                    u[n][0] = 0.;  u[n][1] = 0.;  u[n][2] =  s;  n++;
                  }
         for (int k = 0; k <= pm1; k++)
           for (int j = 0; j + k <= pm1; j++)
           {
             double s = shape_x[pm1-j-k]*shape_y[j]*shape_z[k];
-            u(n,0) = s*(y - c);  u(n,1) = -s*(x - c);  u(n,2) =  0.;  n++;
-            u(n,0) = s*(z - c);  u(n,1) =  0.;  u(n,2) = -s*(x - c);  n++;
+            u[n][0] = s*(y - c);  u[n][1] = -s*(x - c);  u[n][2] =  0.;  n++;
+            u[n][0] = s*(z - c);  u[n][1] =  0.;  u[n][2] = -s*(x - c);  n++;
           }
         for (int k = 0; k <= pm1; k++)
         {
           double s = shape_y[pm1-k]*shape_z[k];
-          u(n,0) = 0.;  u(n,1) = s*(z - c);  u(n,2) = -s*(y - c);  n++;
+          u[n][0] = 0.;  u[n][1] = s*(z - c);  u[n][2] = -s*(y - c);  n++;
         }
 
-      	mth::Matrix<double> Q(dof, dof);
-      	mth::Matrix<double> R(dof, dof);
-      	getTi(P, apf::Mesh::TET, Q, R);
-
-        mth::Matrix<double> S(dof, dim);
-      	for(int i = 0; i < dim; i++) // S = Ti * u
-        {
-          mth::Vector<double> B (dof);
-          mth::Vector<double> X (dof);
-          for (int j = 0; j < dof; j++) B[j] = u(j,i); // populate b
-          mth::solveFromQR(Q, R, B, X);
-          for (int j = 0; j < dof; j++)  S(j,i) = X[j]; // populate S with x
-        }
-
-        shapes.allocate(dof);
-        for (int i = 0; i < dof; i++) // populate y
-        {
-      	  shapes[i] = apf::Vector3( S(i,0), S(i,1), S(i,2) );
-        }
+        applyTiInverse<NedelecDofs<P>::TET, 3>(
+            getTiInverse(P, apf::Mesh::TET), u, shapes);
       }
       void getLocalVectorCurls(apf::Mesh* /*m*/, apf::MeshEntity* /*e*/,
 	  apf::Vector3 const& xi, apf::NewArray<apf::Vector3>& curl_shapes) const
       {
       	const int pm1 = P - 1;
-        const int p = P;
 
-      	apf::NewArray<double> shape_x(p);
-      	apf::NewArray<double> shape_y(p);
-      	apf::NewArray<double> shape_z(p);
-      	apf::NewArray<double> shape_l(p);
-      	apf::NewArray<double> dshape_x(p);
-      	apf::NewArray<double> dshape_y(p);
-      	apf::NewArray<double> dshape_z(p);
-      	apf::NewArray<double> dshape_l(p);
+      	double shape_x[P];
+      	double shape_y[P];
+      	double shape_z[P];
+      	double shape_l[P];
+      	double dshape_x[P];
+      	double dshape_y[P];
+      	double dshape_z[P];
+      	double dshape_l[P];
 
-      	int dof = countNodes();
-        mth::Matrix<double> u(dof, dim);
+        double u[NedelecDofs<P>::TET][3];
 
         double x = xi[0]; double y = xi[1]; double z = xi[2];
 
@@ -948,9 +926,9 @@ class Nedelec: public FieldShape {
               const double dz = (dshape_z[k]*shape_l[l] -
                              shape_z[k]*dshape_l[l])*shape_x[i]*shape_y[j];
 
-              u(n,0) =  0.;  u(n,1) =  dz;  u(n,2) = -dy;  n++;
-              u(n,0) = -dz;  u(n,1) =  0.;  u(n,2) =  dx;  n++;
-              u(n,0) =  dy;  u(n,1) = -dx;  u(n,2) =  0.;  n++;
+              u[n][0] =  0.;  u[n][1] =  dz;  u[n][2] = -dy;  n++;
+              u[n][0] = -dz;  u[n][1] =  0.;  u[n][2] =  dx;  n++;
+              u[n][0] =  dy;  u[n][1] = -dx;  u[n][2] =  0.;  n++;
             }
         for (int k = 0; k <= pm1; k++)
           for (int j = 0; j + k <= pm1; j++)
@@ -958,48 +936,30 @@ class Nedelec: public FieldShape {
             int i = pm1 - j - k;
             // s = shape_x(i)*shape_y(j)*shape_z(k);
             // curl of s*(ip.y - c, -(ip.x - c), 0):
-            u(n,0) =  shape_x[i]*(x - c)*shape_y[j]*dshape_z[k];
-            u(n,1) =  shape_x[i]*shape_y[j]*(y - c)*dshape_z[k];
-            u(n,2) =  -((dshape_x[i]*(x - c) + shape_x[i])*shape_y[j]*shape_z[k] +
+            u[n][0] =  shape_x[i]*(x - c)*shape_y[j]*dshape_z[k];
+            u[n][1] =  shape_x[i]*shape_y[j]*(y - c)*dshape_z[k];
+            u[n][2] =  -((dshape_x[i]*(x - c) + shape_x[i])*shape_y[j]*shape_z[k] +
                       (dshape_y[j]*(y - c) + shape_y[j])*shape_x[i]*shape_z[k]);
             n++;
             // curl of s*(ip.z - c, 0, -(ip.x - c)):
-            u(n,0) = -shape_x[i]*(x - c)*dshape_y[j]*shape_z[k];
-            u(n,1) = (shape_x[i]*shape_y[j]*(dshape_z[k]*(z - c) + shape_z[k]) +
+            u[n][0] = -shape_x[i]*(x - c)*dshape_y[j]*shape_z[k];
+            u[n][1] = (shape_x[i]*shape_y[j]*(dshape_z[k]*(z - c) + shape_z[k]) +
                      (dshape_x[i]*(x - c) + shape_x[i])*shape_y[j]*shape_z[k]);
-            u(n,2) = -shape_x[i]*dshape_y[j]*shape_z[k]*(z - c);
+            u[n][2] = -shape_x[i]*dshape_y[j]*shape_z[k]*(z - c);
             n++;
           }
         for (int k = 0; k <= pm1; k++)
         {
           int j = pm1 - k;
           // curl of shape_y(j)*shape_z(k)*(0, ip.z - c, -(ip.y - c)):
-          u(n,0) = -((dshape_y[j]*(y - c) + shape_y[j])*shape_z[k] +
+          u[n][0] = -((dshape_y[j]*(y - c) + shape_y[j])*shape_z[k] +
                    shape_y[j]*(dshape_z[k]*(z - c) + shape_z[k]));
-          u(n,1) = 0.;
-          u(n,2) = 0.;  n++;
-        }
-
-
-      	mth::Matrix<double> Q(dof, dof);
-	      mth::Matrix<double> R(dof, dof);
-	      getTi(P, apf::Mesh::TET, Q, R);
-
-        mth::Matrix<double> S(dof, dim);
-      	for(int i = 0; i < dim; i++) // S = Ti * u
-        {
-          mth::Vector<double> B(dof);
-          mth::Vector<double> X(dof);
-          for (int j = 0; j < dof; j++) B[j] = u(j,i); // populate b
-          mth::solveFromQR(Q, R, B, X);
-          for (int j = 0; j < dof; j++)  S(j,i) = X[j]; // populate S with x
+          u[n][1] = 0.;
+          u[n][2] = 0.;  n++;
         }
 
-        curl_shapes.allocate(dof);
-        for (int i = 0; i < dof; i++) // populate y
-        {
-      	  curl_shapes[i] = apf::Vector3( S(i,0), S(i,1), S(i,2) );
-        }
+        applyTiInverse<NedelecDofs<P>::TET, 3>(
+            getTiInverse(P, apf::Mesh::TET), u, curl_shapes);
       }
     };
     EntityShape* getEntityShape(int type)
@@ -1040,6 +1000,7 @@ class Nedelec: public FieldShape {
       return 0;
     }
     int getOrder() {return P;}
+    bool canTabulate(int) {return true;}
     void getNodeXi(int type, int node, Vector3& xi)
     {
       apf::NewArray<double> op;
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include <PCU.h>
+#include <pcu_shm.h>
+#include "apfNodeSync.h"
+#include "apfField.h"
+#include "apfFieldData.h"
+#include "apfShape.h"
+#include "apfMesh.h"
+#include "apfNew.h"
+
+namespace apf {
+
+NodeSynchronizer::NodeSynchronizer(Field* f, Sharing* shr):
+  field(f)
+{
+  Mesh* m = f->getMesh();
+  FieldShape* s = f->getShape();
+  FieldDataOf<double>* data = f->getData();
+  bool deleteSharing = false;
+  if (!shr) {
+    shr = getSharing(m);
+    deleteSharing = true;
+  }
+  shm = pcu_shm_open();
+  size_t size = 0;
+  PCU_Comm_Begin();
+  for (int d = 0; d < 4; ++d) {
+    if ( ! s->hasNodesIn(d))
+      continue;
+    MeshEntity* e;
+    MeshIterator* it = m->begin(d);
+    while ((e = m->iterate(it))) {
+      if (( ! data->hasEntity(e)) || ( ! shr->isOwned(e)))
+        continue;
+      bool isPublished = false;
+      CopyArray copies;
+      shr->getCopies(e, copies);
+      for (size_t i = 0; i < copies.getSize(); ++i) {
+        int peer = copies[i].peer;
+        if (pcu_shm_node_rank(shm, peer) < 0) {
+          Remote r = {e, peer, copies[i].entity};
+          messaged.push_back(r);
+          continue;
+        }
+        if (!isPublished) {
+          Slot slot = {e, pcu_shm_self(shm), size};
+          published.push_back(slot);
+          size += f->countValuesOn(e);
+          isPublished = true;
+        }
+        PCU_COMM_PACK(peer, copies[i].entity);
+        PCU_COMM_PACK(peer, published.back().offset);
+      }
+      Copies ghosts;
+      if (m->getGhosts(e, ghosts))
+        APF_ITERATE(Copies, ghosts, git) {
+          Remote r = {e, git->first, git->second};
+          messaged.push_back(r);
+        }
+    }
+    m->end(it);
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    Slot slot;
+    PCU_COMM_UNPACK(slot.entity);
+    PCU_COMM_UNPACK(slot.offset);
+    slot.node = pcu_shm_node_rank(shm, PCU_Comm_Sender());
+    reads.push_back(slot);
+  }
+  pcu_shm_alloc(shm, size * sizeof(double));
+  segments.resize(pcu_shm_peers(shm));
+  for (size_t i = 0; i < segments.size(); ++i)
+    segments[i] = static_cast<double*>(pcu_shm_segment(shm, i, 0));
+  if (deleteSharing)
+    delete shr;
+}
+
+NodeSynchronizer::~NodeSynchronizer()
+{
+  pcu_shm_close(shm);
+}
+
+void NodeSynchronizer::run()
+{
+  FieldDataOf<double>* data = field->getData();
+  double* mine = segments[pcu_shm_self(shm)];
+  for (size_t i = 0; i < published.size(); ++i)
+    data->get(published[i].entity, mine + published[i].offset);
+  pcu_shm_fence(shm);
+  for (size_t i = 0; i < reads.size(); ++i)
+    data->set(reads[i].entity, segments[reads[i].node] + reads[i].offset);
+  PCU_Comm_Begin();
+  for (size_t i = 0; i < messaged.size(); ++i) {
+    MeshEntity* e = messaged[i].entity;
+    int n = field->countValuesOn(e);
+    NewArray<double> values(n);
+    data->get(e, &(values[0]));
+    PCU_COMM_PACK(messaged[i].peer, messaged[i].copy);
+    PCU_Comm_Pack(messaged[i].peer, &(values[0]), n * sizeof(double));
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    MeshEntity* e;
+    PCU_COMM_UNPACK(e);
+    int n = field->countValuesOn(e);
+    NewArray<double> values(n);
+    PCU_Comm_Unpack(&(values[0]), n * sizeof(double));
+    data->set(e, &(values[0]));
+  }
+  /* owners may overwrite their segments in the next run
+     only once every copy has read them */
+  pcu_shm_fence(shm);
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef APF_NODE_SYNC_H
+#define APF_NODE_SYNC_H
+
+/** \file apfNodeSync.h
+  \brief field synchronization through node-shared memory */
+
+#include <vector>
+
+struct pcu_shm;
+
+namespace apf {
+
+class Field;
+class MeshEntity;
+class Sharing;
+
+/** \brief repeatedly copies a field's values from owners to their
+           remote copies and ghosts, like apf::synchronize
+  \details construction is collective and exchanges one round of
+  messages to plan the copies. After that, owners publish the
+  values wanted on their compute node into node-shared memory
+  (MPI-3), and copies on the same node read them from there.
+  Only copies on other nodes and ghosts still get messages.
+  The plan covers the owned entities that have values when it is
+  made, and holds until the mesh, its partition or the field's
+  shape changes. The coordinate field works too.
+  It saves messages, not memory: owners copy the published values
+  into a node-shared segment on top of the field data every rank
+  keeps anyway. */
+class NodeSynchronizer
+{
+  public:
+    /** \brief plans with the given sharing, or the mesh's
+               default sharing when shr is null */
+    NodeSynchronizer(Field* f, Sharing* shr = 0);
+    ~NodeSynchronizer();
+    /** \brief collective: synchronizes the current values */
+    void run();
+  private:
+    struct Slot
+    {
+      MeshEntity* entity;
+      int node;
+      size_t offset;
+    };
+    struct Remote
+    {
+      MeshEntity* entity;
+      int peer;
+      MeshEntity* copy;
+    };
+    Field* field;
+    pcu_shm* shm;
+    /* owned entities and where their values go in this rank's
+       segment, then copies and where to read their values */
+    std::vector<Slot> published;
+    std::vector<Slot> reads;
+    std::vector<Remote> messaged;
+    std::vector<double*> segments;
+};
+
+}
+
+#endif
@@ -55,6 +55,11 @@ bool FieldShape::isVectorShape()
   return false;
 }
 
+bool FieldShape::canTabulate(int)
+{
+  return false;
+}
+
 void FieldShape::registerSelf(const char* name_)
 {
   std::string name = name_;
@@ -407,6 +412,7 @@ class Linear : public FieldShape
         return 0;
     }
     int getOrder() {return 1;}
+    bool canTabulate(int) {return true;}
     void getNodeXi(int, int, Vector3& xi)
     {
       xi = Vector3(0,0,0);
@@ -540,6 +546,7 @@ class QuadraticBase : public FieldShape
       return shapes[type];
     }
     int getOrder() {return 2;}
+    bool canTabulate(int) {return true;}
     void getNodeXi(int, int, Vector3& xi)
     {
       /* for vertex nodes, mid-edge nodes,
@@ -969,6 +976,7 @@ class LagrangeCubic : public FieldShape
         return 0;
     }
     int getOrder() {return 3;}
+    bool canTabulate(int) {return true;}
     void getNodeXi(int type, int node, Vector3& xi)
     {
       PCU_ALWAYS_ASSERT(node < 2);
@@ -1069,6 +1077,7 @@ class Constant : public FieldShape
         return 0;
    }
     int getOrder() {return 0;}
+    bool canTabulate(int) {return true;}
     void getNodeXi(int type, int node, Vector3& xi)
     {
       PCU_ALWAYS_ASSERT(node == 0);
@@ -120,6 +120,13 @@ class FieldShape
     virtual void getNodeTangent(int type, int node, Vector3& t);
 /** \brief Returns true if the shape functions are vectors */
     virtual bool isVectorShape();
+/** \brief Returns true if the shape functions of this element type
+           can be tabulated
+  \details this holds when the values depend only on the parent
+  element coordinates, not on the mesh entity, and never change.
+  See apf::getTabulation. The default is false.
+  \param type select from apf::Mesh::Type */
+    virtual bool canTabulate(int type);
 /** \brief Get a unique string for this shape function scheme */
     virtual const char* getName() const = 0;
     void registerSelf(const char* name);
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef APF_SMALL_ARRAY_H
+#define APF_SMALL_ARRAY_H
+
+/** \file apfSmallArray.h
+  \brief growable array with inline storage */
+
+#include <cstddef>
+
+namespace apf {
+
+/** \brief growable array that stores its first N elements inline
+  \details queries that usually return a few items, like the
+  remote copies of an entity, can fill one of these without
+  touching the heap. Larger contents spill to a heap buffer,
+  which is kept by clear() so that a reused array only
+  allocates while it grows. */
+template <class T, unsigned N>
+class SmallArray
+{
+  public:
+    SmallArray():sz(0),cap(N),elems(inlineElems) {}
+    SmallArray(SmallArray<T,N> const& other):
+      sz(0),cap(N),elems(inlineElems)
+    {
+      copy(other);
+    }
+    ~SmallArray()
+    {
+      if (elems != inlineElems)
+        delete [] elems;
+    }
+    SmallArray<T,N>& operator=(SmallArray<T,N> const& other)
+    {
+      if (this != &other)
+        copy(other);
+      return *this;
+    }
+    /** \brief mutable index operator */
+    T& operator[](unsigned i) {return elems[i];}
+    /** \brief immutable index operator */
+    T const& operator[](unsigned i) const {return elems[i];}
+    /** \brief get the number of elements */
+    unsigned size() const {return sz;}
+    /** \brief true if there are no elements */
+    bool empty() const {return sz == 0;}
+    /** \brief remove all elements, keeping the storage */
+    void clear() {sz = 0;}
+    /** \brief append an element */
+    void push_back(T const& v)
+    {
+      if (sz == cap)
+        reserve(cap * 2);
+      elems[sz++] = v;
+    }
+    /** \brief ensure room for n elements */
+    void reserve(unsigned n)
+    {
+      if (n <= cap)
+        return;
+      T* newElems = new T[n];
+      for (unsigned i = 0; i < sz; ++i)
+        newElems[i] = elems[i];
+      if (elems != inlineElems)
+        delete [] elems;
+      elems = newElems;
+      cap = n;
+    }
+    /** \brief pointer to the first element */
+    T* begin() {return elems;}
+    /** \brief pointer past the last element */
+    T* end() {return elems + sz;}
+    /** \brief pointer to the first element */
+    T const* begin() const {return elems;}
+    /** \brief pointer past the last element */
+    T const* end() const {return elems + sz;}
+  private:
+    void copy(SmallArray<T,N> const& other)
+    {
+      clear();
+      reserve(other.sz);
+      for (unsigned i = 0; i < other.sz; ++i)
+        elems[i] = other.elems[i];
+      sz = other.sz;
+    }
+    unsigned sz;
+    unsigned cap;
+    T* elems;
+    T inlineElems[N];
+};
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include "apfTabulation.h"
+#include "apfShape.h"
+#include "apfIntegrate.h"
+#include <pcu_util.h>
+#include <map>
+
+namespace apf {
+
+Tabulation::Tabulation(EntityShape* s, Integration const* in):
+  shape(s),
+  integration(in),
+  nodes(s->countNodes())
+{
+}
+
+int Tabulation::countPoints() const
+{
+  return integration->countPoints();
+}
+
+Vector3 const& Tabulation::getPoint(int point) const
+{
+  return integration->getPoint(point)->param;
+}
+
+double Tabulation::getWeight(int point) const
+{
+  return integration->getPoint(point)->weight;
+}
+
+/* the shape functions of tabulated shapes ignore
+   the mesh and entity, so none are given.
+   tables are shared by all threads, so each quantity is
+   checked and filled inside one critical section */
+double const* Tabulation::getValues(int point)
+{
+#ifdef _OPENMP
+#pragma omp critical(apf_tabulation)
+#endif
+  if (!values.allocated()) {
+    int np = countPoints();
+    values.allocate(np * nodes);
+    NewArray<double> v;
+    for (int i = 0; i < np; ++i) {
+      shape->getValues(0, 0, getPoint(i), v);
+      for (int j = 0; j < nodes; ++j)
+        values[i * nodes + j] = v[j];
+    }
+  }
+  return &values[point * nodes];
+}
+
+Vector3 const* Tabulation::getLocalGradients(int point)
+{
+#ifdef _OPENMP
+#pragma omp critical(apf_tabulation)
+#endif
+  if (!gradients.allocated()) {
+    int np = countPoints();
+    gradients.allocate(np * nodes);
+    NewArray<Vector3> g;
+    for (int i = 0; i < np; ++i) {
+      shape->getLocalGradients(0, 0, getPoint(i), g);
+      for (int j = 0; j < nodes; ++j)
+        gradients[i * nodes + j] = g[j];
+    }
+  }
+  return &gradients[point * nodes];
+}
+
+Vector3 const* Tabulation::getVectorValues(int point)
+{
+#ifdef _OPENMP
+#pragma omp critical(apf_tabulation)
+#endif
+  if (!vectorValues.allocated()) {
+    int np = countPoints();
+    vectorValues.allocate(np * nodes);
+    NewArray<Vector3> v(nodes);
+    for (int i = 0; i < np; ++i) {
+      shape->getVectorValues(0, 0, getPoint(i), v);
+      for (int j = 0; j < nodes; ++j)
+        vectorValues[i * nodes + j] = v[j];
+    }
+  }
+  return &vectorValues[point * nodes];
+}
+
+class Tabulations
+{
+  public:
+    typedef std::pair<EntityShape*, Integration const*> Key;
+    typedef std::map<Key, Tabulation*> Map;
+    ~Tabulations()
+    {
+      APF_ITERATE(Map, tables, it)
+        delete it->second;
+    }
+    Tabulation* get(EntityShape* s, Integration const* in)
+    {
+      Tabulation* t;
+#ifdef _OPENMP
+#pragma omp critical(apf_tabulations)
+#endif
+      {
+        Tabulation*& slot = tables[Key(s, in)];
+        if (!slot)
+          slot = new Tabulation(s, in);
+        t = slot;
+      }
+      return t;
+    }
+  private:
+    Map tables;
+};
+
+Tabulation* getTabulation(EntityShape* s, Integration const* in)
+{
+  static Tabulations tabulations;
+  return tabulations.get(s, in);
+}
+
+Tabulation* getTabulation(FieldShape* s, int type, int order)
+{
+  if (!s->canTabulate(type))
+    return 0;
+  Integration const* in = getIntegration(type)->getAccurate(order);
+  PCU_ALWAYS_ASSERT(in);
+  return getTabulation(s->getEntityShape(type), in);
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef APF_TABULATION_H
+#define APF_TABULATION_H
+
+/** \file apfTabulation.h
+  \brief shape functions tabulated at integration points */
+
+#include "apfNew.h"
+#include "apfVector.h"
+
+namespace apf {
+
+class FieldShape;
+class EntityShape;
+class Integration;
+
+/** \brief shape function values and gradients at the integration
+           points of one element type and integration order
+  \details each quantity is evaluated for all points the first
+  time it is requested, then returned from memory. The arrays
+  for point i hold one entry per element node, in the element
+  node order of the EntityShape, and the arrays of all points
+  are contiguous. Tables may be queried from several OpenMP
+  threads at once. */
+class Tabulation
+{
+  public:
+    Tabulation(EntityShape* s, Integration const* in);
+    /** \brief the integration rule this table was built for */
+    Integration const* getIntegration() const {return integration;}
+    /** \brief the number of integration points */
+    int countPoints() const;
+    /** \brief the number of element nodes */
+    int countNodes() const {return nodes;}
+    /** \brief the parent coordinates of an integration point */
+    Vector3 const& getPoint(int point) const;
+    /** \brief the integration weight of a point */
+    double getWeight(int point) const;
+    /** \brief scalar shape function values at a point */
+    double const* getValues(int point);
+    /** \brief shape function gradients in parent coordinates */
+    Vector3 const* getLocalGradients(int point);
+    /** \brief vector shape function values in parent coordinates,
+               before the Piola transformation */
+    Vector3 const* getVectorValues(int point);
+  private:
+    EntityShape* shape;
+    Integration const* integration;
+    int nodes;
+    NewArray<double> values;
+    NewArray<Vector3> gradients;
+    NewArray<Vector3> vectorValues;
+};
+
+/** \brief get the tabulation of a shape at the integration points
+           that are accurate to some order
+  \details tables are built once and kept until the program exits.
+  This returns zero when FieldShape::canTabulate is false for the
+  type, since those shape functions vary from element to element.
+  Elements created by apf::createElement use these tables
+  automatically when they are queried at the point most recently
+  returned by apf::getIntPoint for their mesh element.
+  \param s the shape functions
+  \param type select from apf::Mesh::Type
+  \param order the integration order, as in apf::getIntPoint */
+Tabulation* getTabulation(FieldShape* s, int type, int order);
+
+/** \brief get the tabulation of an element shape for an integration
+  \details this is the lookup used by apf::Element. The caller
+  must have checked FieldShape::canTabulate. */
+Tabulation* getTabulation(EntityShape* s, Integration const* in);
+
+}
+
+#endif
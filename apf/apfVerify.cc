@@ -1,15 +1,35 @@
 #include <PCU.h>
-#include "apfMesh.h"
+#include "apfMesh2.h"
 #include "apf.h"
 #include <gmi.h>
 #include <sstream>
+#include <algorithm>
 #include <apfGeometry.h>
 #include <pcu_util.h>
 #include <lionPrint.h>
 #include "stdlib.h" // malloc
+#include <cstring>
 
 namespace apf {
 
+/* an incremental verify sends all of its cross-part checks
+   in one round, each message starting with one of these */
+enum {
+  NO_RECORD,
+  COPIES_RECORD,
+  GHOSTS_RECORD,
+  MATCHES_RECORD,
+  COORDS_RECORD,
+  ALIGNMENT_RECORD,
+  TAG_RECORD
+};
+
+static void packRecord(int to, int kind)
+{
+  if (kind != NO_RECORD)
+    PCU_COMM_PACK(to, kind);
+}
+
 static void intersect(
     std::set<int>& a,
     std::set<int> const& b)
@@ -184,14 +204,14 @@ static void verifyUp(Mesh* m, UpwardCounts& guc,
 
 static void verifyResidence(Mesh* m, MeshEntity* e)
 {
-  Parts p;
-  m->getResidence(e, p);
-  PCU_ALWAYS_ASSERT(p.count(m->getOwner(e)));
-  Copies r;
-  m->getRemotes(e, r);
+  FlatParts p;
+  m->getFlatResidence(e, p);
+  PCU_ALWAYS_ASSERT(std::binary_search(p.begin(), p.end(), m->getOwner(e)));
+  FlatCopies r;
+  m->getFlatRemotes(e, r);
   PCU_ALWAYS_ASSERT(r.size() + 1 == p.size());
-  APF_ITERATE(Copies, r, it)
-    PCU_ALWAYS_ASSERT(p.count(it->first));
+  for (unsigned i = 0; i < r.size(); ++i)
+    PCU_ALWAYS_ASSERT(std::binary_search(p.begin(), p.end(), r[i].peer));
 }
 
 static void verifyEntity(Mesh* m, UpwardCounts& guc, MeshEntity* e, bool abort_on_error)
@@ -254,7 +274,7 @@ static void unpackCopies(
   }
 }
 
-static void sendAllCopies(Mesh* m, MeshEntity* e)
+static void sendAllCopies(Mesh* m, MeshEntity* e, int kind = NO_RECORD)
 {
   Copies a;
   Copies r;
@@ -264,6 +284,7 @@ static void sendAllCopies(Mesh* m, MeshEntity* e)
   PCU_ALWAYS_ASSERT(!r.count(PCU_Comm_Self()));
   APF_ITERATE(Copies, r, it)
   {
+    packRecord(it->first, kind);
     PCU_COMM_PACK(it->first, it->second);
     packCopies(it->first, a);
   }
@@ -297,13 +318,14 @@ static void verifyRemoteCopies(Mesh* m)
 }
 
 // ghost verification
-static void sendGhostCopies(Mesh* m, MeshEntity* e)
+static void sendGhostCopies(Mesh* m, MeshEntity* e, int kind = NO_RECORD)
 {
   Copies g;
   m->getGhosts(e, g);
   PCU_ALWAYS_ASSERT(g.size());
   APF_ITERATE(Copies, g, it)
   {
+    packRecord(it->first, kind);
     PCU_COMM_PACK(it->first, it->second);
     PCU_COMM_PACK(it->first, e);
   }
@@ -359,11 +381,13 @@ static bool hasMatch(
   return false;
 }
 
-static void sendSelfToMatches(MeshEntity* e, Matches& matches)
+static void sendSelfToMatches(MeshEntity* e, Matches& matches,
+    int kind = NO_RECORD)
 {
   APF_ITERATE(Matches, matches, it)
   {
     PCU_ALWAYS_ASSERT(!((it->peer == PCU_Comm_Self())&&(it->entity == e)));
+    packRecord(it->peer, kind);
     PCU_COMM_PACK(it->peer, e);
     PCU_COMM_PACK(it->peer, it->entity);
   }
@@ -409,19 +433,20 @@ static void verifyMatches(Mesh* m)
     receiveMatches(m);
 }
 
-static void sendCoords(Mesh* m, MeshEntity* e)
+static void sendCoords(Mesh* m, MeshEntity* e, int kind = NO_RECORD)
 {
   Vector3 x;
   m->getPoint(e, 0, x);
   Vector3 p(0,0,0);
   m->getParam(e, p);
-  Copies r;
-  m->getRemotes(e, r);
-  APF_ITERATE(Copies, r, it)
+  FlatCopies r;
+  m->getFlatRemotes(e, r);
+  for (unsigned i = 0; i < r.size(); ++i)
   {
-    PCU_COMM_PACK(it->first, it->second);
-    PCU_COMM_PACK(it->first, x);
-    PCU_COMM_PACK(it->first, p);
+    packRecord(r[i].peer, kind);
+    PCU_COMM_PACK(r[i].peer, r[i].entity);
+    PCU_COMM_PACK(r[i].peer, x);
+    PCU_COMM_PACK(r[i].peer, p);
   }
 }
 
@@ -484,26 +509,28 @@ long verifyVolumes(Mesh* m, bool printVolumes)
   return PCU_Add_Long(n);
 }
 
-static void packAlignment(Mesh* m, MeshEntity* e, MeshEntity* r, int to)
+static void packAlignment(Mesh* m, MeshEntity* e, MeshEntity* r, int to,
+    int kind)
 {
+  packRecord(to, kind);
   PCU_COMM_PACK(to,r);
   int d = getDimension(m, e);
   Downward down;
   int nd = m->getDownward(e, d - 1, down);
+  FlatCopies remotes;
   for (int i = 0; i < nd; ++i) {
-    Copies remotes;
-    m->getRemotes(down[i], remotes);
-    MeshEntity* dr = remotes[to];
+    m->getFlatRemotes(down[i], remotes);
+    MeshEntity* dr = findCopy(remotes, to);
     PCU_COMM_PACK(to,dr);
   }
 }
 
-static void sendAlignment(Mesh* m, MeshEntity* e)
+static void sendAlignment(Mesh* m, MeshEntity* e, int kind = NO_RECORD)
 {
-  Copies remotes;
-  m->getRemotes(e, remotes);
-  APF_ITERATE(Copies, remotes, it)
-    packAlignment(m, e, it->second, it->first);
+  FlatCopies remotes;
+  m->getFlatRemotes(e, remotes);
+  for (unsigned i = 0; i < remotes.size(); ++i)
+    packAlignment(m, e, remotes[i].entity, remotes[i].peer, kind);
 }
 
 static void receiveAlignment(Mesh* m)
@@ -728,33 +755,16 @@ static void receiveTagData(Mesh* m, DynamicArray<MeshTag*>& tags)
       lion_oprint(1,"  - tag \"%s\" data mismatch over remote/ghost copies\n", m->getTagName(*it));
 }
 
-static void verifyTags(Mesh* m)
+static void verifyTagInfo(Mesh* m, DynamicArray<MeshTag*>& tags)
 {
-  DynamicArray<MeshTag*> tags;
-  m->getTags(tags);
   int self = PCU_Comm_Self();
   int n = tags.getSize();
-  if (!n) return;
-
   PCU_Comm_Begin();
   if (self) {
     PCU_COMM_PACK(self - 1, n);
     for (int i = 0; i < n; ++i)
       packTagInfo(m, tags[i], self - 1);
   }
-  else // master
-  {
-    if (n)
-    {
-      lion_oprint(1,"  - verifying tags: ");
-      for (int i = 0; i < n; ++i)
-      {
-        lion_oprint(1,"%s", m->getTagName(tags[i]));
-        if (i<n-1) lion_oprint(1,", ");
-      }
-      lion_oprint(1,"\n");
-    }
-  }
   PCU_Comm_Send();
   while (PCU_Comm_Receive()) {
     int n;
@@ -770,6 +780,26 @@ static void verifyTags(Mesh* m)
       PCU_ALWAYS_ASSERT(size == m->getTagSize(tags[i]));
     }
   }
+}
+
+static void verifyTags(Mesh* m)
+{
+  DynamicArray<MeshTag*> tags;
+  m->getTags(tags);
+  int n = tags.getSize();
+  if (!n) return;
+
+  if (!PCU_Comm_Self())
+  {
+    lion_oprint(1,"  - verifying tags: ");
+    for (int i = 0; i < n; ++i)
+    {
+      lion_oprint(1,"%s", m->getTagName(tags[i]));
+      if (i<n-1) lion_oprint(1,", ");
+    }
+    lion_oprint(1,"\n");
+  }
+  verifyTagInfo(m, tags);
   
   // verify tag data
 
@@ -841,4 +871,242 @@ void verify(Mesh* m, bool abort_on_error)
     lion_oprint(1,"mesh verified in %f seconds\n", t1 - t0);
 }
 
+static size_t getTagBytes(Mesh* m, MeshTag* tag)
+{
+  size_t size = m->getTagSize(tag);
+  switch (m->getTagType(tag))
+  {
+    case Mesh::DOUBLE: return size * sizeof(double);
+    case Mesh::INT: return size * sizeof(int);
+    case Mesh::LONG: return size * sizeof(long);
+  }
+  return 0;
+}
+
+static void getTagData(Mesh* m, MeshEntity* e, MeshTag* tag, char* data)
+{
+  switch (m->getTagType(tag))
+  {
+    case Mesh::DOUBLE:
+      m->getDoubleTag(e, tag, reinterpret_cast<double*>(data));
+      break;
+    case Mesh::INT:
+      m->getIntTag(e, tag, reinterpret_cast<int*>(data));
+      break;
+    case Mesh::LONG:
+      m->getLongTag(e, tag, reinterpret_cast<long*>(data));
+      break;
+  }
+}
+
+/* the records version of sendTagData */
+static void packTagData(Mesh* m, MeshEntity* e, DynamicArray<MeshTag*>& tags,
+    Copies& copies, bool is_ghost)
+{
+  for (size_t i = 0; i < tags.getSize(); ++i)
+  {
+    std::string name = m->getTagName(tags[i]);
+    if (name == "ghosted_tag" && is_ghost) continue;
+    if (name == "ghost_tag") continue;
+    if (!m->hasTag(e, tags[i])) continue;
+    size_t bytes = getTagBytes(m, tags[i]);
+    PCU_ALWAYS_ASSERT(bytes);
+    std::vector<char> data(bytes);
+    getTagData(m, e, tags[i], &data[0]);
+    int index = i;
+    APF_ITERATE(Copies, copies, it)
+    {
+      packRecord(it->first, TAG_RECORD);
+      PCU_COMM_PACK(it->first, it->second);
+      PCU_COMM_PACK(it->first, index);
+      PCU_Comm_Pack(it->first, &data[0], bytes);
+    }
+  }
+}
+
+static bool receiveTagData(Mesh* m, MeshTag** tags)
+{
+  MeshEntity* e;
+  PCU_COMM_UNPACK(e);
+  int index;
+  PCU_COMM_UNPACK(index);
+  MeshTag* tag = tags[index];
+  size_t bytes = getTagBytes(m, tag);
+  std::vector<char> sent(bytes);
+  PCU_Comm_Unpack(&sent[0], bytes);
+  if (!m->hasTag(e, tag))
+    return false;
+  std::vector<char> data(bytes);
+  getTagData(m, e, tag, &data[0]);
+  return !memcmp(&sent[0], &data[0], bytes);
+}
+
+IncrementalVerifier::IncrementalVerifier(Mesh2* m, bool abort_on_error):
+  mesh(m),
+  abortOnError(abort_on_error)
+{
+  mesh->addModifyCallback(this);
+}
+
+IncrementalVerifier::~IncrementalVerifier()
+{
+  mesh->removeModifyCallback(this);
+}
+
+void IncrementalVerifier::mark(MeshEntity* e)
+{
+  changed[getDimension(mesh, e)].insert(e);
+}
+
+/* entities one dimension down lose or gain an upward adjacency */
+void IncrementalVerifier::created(MeshEntity* e)
+{
+  int d = getDimension(mesh, e);
+  changed[d].insert(e);
+  if (!d)
+    return;
+  Downward down;
+  int nd = mesh->getDownward(e, d - 1, down);
+  for (int i = 0; i < nd; ++i)
+    changed[d - 1].insert(down[i]);
+}
+
+void IncrementalVerifier::destroying(MeshEntity* e)
+{
+  int d = getDimension(mesh, e);
+  changed[d].erase(e);
+  movedEntities.erase(e);
+  if (!d)
+    return;
+  Downward down;
+  int nd = mesh->getDownward(e, d - 1, down);
+  for (int i = 0; i < nd; ++i)
+    changed[d - 1].insert(down[i]);
+}
+
+void IncrementalVerifier::moved(MeshEntity* e)
+{
+  movedEntities.insert(e);
+}
+
+static void sendRecords(Mesh* m, MeshEntity* e,
+    DynamicArray<MeshTag*>& tags)
+{
+  int d = getDimension(m, e);
+  if (m->isShared(e) && !m->isGhost(e)) {
+    sendAllCopies(m, e, COPIES_RECORD);
+    if (d)
+      sendAlignment(m, e, ALIGNMENT_RECORD);
+    else
+      sendCoords(m, e, COORDS_RECORD);
+  }
+  if (m->isGhosted(e) || m->isGhost(e))
+    sendGhostCopies(m, e, GHOSTS_RECORD);
+  Matches matches;
+  m->getMatches(e, matches);
+  PCU_ALWAYS_ASSERT(!hasDuplicates(matches));
+  sendSelfToMatches(e, matches, MATCHES_RECORD);
+  if (m->getOwner(e) != PCU_Comm_Self())
+    return;
+  if (m->isShared(e)) {
+    Copies r;
+    m->getRemotes(e, r);
+    packTagData(m, e, tags, r, false);
+  }
+  if (m->isGhosted(e)) {
+    Copies g;
+    m->getGhosts(e, g);
+    packTagData(m, e, tags, g, true);
+  }
+}
+
+/* counts coordinate and tag mismatches */
+static void receiveRecord(Mesh* m, DynamicArray<MeshTag*>& tags,
+    long* mismatches)
+{
+  int kind;
+  PCU_COMM_UNPACK(kind);
+  switch (kind)
+  {
+    case COPIES_RECORD: receiveAllCopies(m); break;
+    case GHOSTS_RECORD: receiveGhostCopies(m); break;
+    case MATCHES_RECORD: receiveMatches(m); break;
+    case ALIGNMENT_RECORD: receiveAlignment(m); break;
+    case COORDS_RECORD:
+      if (!receiveCoords(m))
+        ++mismatches[0];
+      break;
+    case TAG_RECORD:
+      if (!receiveTagData(m, &tags[0]))
+        ++mismatches[1];
+      break;
+    default:
+      fail("apf::IncrementalVerifier: unknown record\n");
+  }
+}
+
+long IncrementalVerifier::run()
+{
+  double t0 = PCU_Time();
+  Mesh* m = mesh;
+  DynamicArray<MeshTag*> tags;
+  m->getTags(tags);
+  if (tags.getSize())
+    verifyTagInfo(m, tags);
+  verifyFields(m);
+
+  UpwardCounts guc;
+  getUpwardCounts(m->getModel(), m->getDimension(), guc);
+  std::set<MeshEntity*> elements;
+  int md = m->getDimension();
+  PCU_Comm_Begin();
+  for (int d = 0; d <= 3; ++d)
+    APF_ITERATE(std::set<MeshEntity*>, changed[d], it) {
+      verifyEntity(m, guc, *it, abortOnError);
+      sendRecords(m, *it, tags);
+      if (d == md)
+        elements.insert(*it);
+    }
+  /* elements adjacent to a new entity are newer still,
+     so only moved old entities add work */
+  APF_ITERATE(std::set<MeshEntity*>, movedEntities, it) {
+    MeshEntity* e = *it;
+    int d = getDimension(m, e);
+    if (changed[d].count(e))
+      continue;
+    if (!d && m->isShared(e) && !m->isGhost(e))
+      sendCoords(m, e, COORDS_RECORD);
+    Adjacent adjacent;
+    m->getAdjacent(e, md, adjacent);
+    for (size_t i = 0; i < adjacent.getSize(); ++i)
+      elements.insert(adjacent[i]);
+  }
+  PCU_Comm_Send();
+  long counts[3] = {0, 0, 0};
+  while (PCU_Comm_Receive())
+    receiveRecord(m, tags, counts);
+  APF_ITERATE(std::set<MeshEntity*>, elements, it)
+    if (isSimplex(m->getType(*it)) && measure(m, *it) < 0)
+      ++counts[2];
+  PCU_Add_Longs(counts, 3);
+  for (int d = 0; d <= 3; ++d)
+    changed[d].clear();
+  movedEntities.clear();
+  if (!PCU_Comm_Self()) {
+    if (counts[0])
+      lion_eprint(1,"apf::verify fail: %ld coordinate mismatches\n",
+          counts[0]);
+    if (counts[1])
+      lion_eprint(1,"apf::verify fail: %ld tag data mismatches\n",
+          counts[1]);
+    if (counts[2])
+      lion_eprint(1,"apf::verify warning: %ld negative simplex elements\n",
+          counts[2]);
+  }
+  double t1 = PCU_Time();
+  if (!PCU_Comm_Self())
+    lion_oprint(1,"mesh changes verified in %f seconds\n", t1 - t0);
+  return counts[0] + counts[1] + counts[2];
+}
+
 }
@@ -26,6 +26,7 @@ set(APF_SOURCES
   apfScalarElement.cc
   apfScalarField.cc
   apfShape.cc
+  apfTabulation.cc
   apfIPShape.cc
   apfHierarchic.cc
   apfPolyBasis1D.cc
@@ -50,6 +51,8 @@ set(APF_SOURCES
   apfPartition.cc
   apfConvert.cc
   apfConstruct.cc
+  apfCSR.cc
+  apfNodeSync.cc
   apfVerify.cc
   apfGeometry.cc
   apfBoundaryToElementXi.cc
@@ -67,13 +70,17 @@ set(APF_HEADERS
   apfDynamicMatrix.h
   apfDynamicVector.h
   apfDynamicArray.h
+  apfSmallArray.h
   apfNew.h
   apfCavityOp.h
   apfShape.h
+  apfTabulation.h
   apfNumbering.h
   apfMixedNumbering.h
   apfPartition.h
   apfConvert.h
+  apfCSR.h
+  apfNodeSync.h
   apfGeometry.h
   apf2mth.h
   apfField.h
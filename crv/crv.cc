@@ -11,6 +11,7 @@
 #include "crvQuality.h"
 #include <lionPrint.h>
 #include <cstdlib>
+#include <vector>
 
 namespace crv {
 
@@ -163,11 +164,17 @@ int countNumberInvalidElements(apf::Mesh2* m)
       n += (apf::measure(m,e) < 1e-10);
     }
   } else {
+    std::vector<apf::MeshEntity*> elems;
+    elems.reserve(m->count(m->getDimension()));
+    while ((e = m->iterate(it)))
+      elems.push_back(e);
+    std::vector<int> tags(elems.size());
     Quality* qual = makeQuality(m,2);
-    while ((e = m->iterate(it))) {
-      n += (qual->checkValidity(e) > 1);
-    }
+    if (!elems.empty())
+      qual->checkValidities(&elems[0],elems.size(),&tags[0]);
     delete qual;
+    for (size_t i = 0; i < tags.size(); ++i)
+      n += (tags[i] > 1);
   }
   m->end(it);
   return n;
@@ -172,6 +172,12 @@ public:
   virtual double getQuality(apf::MeshEntity* e) = 0;
   /** \brief check the validity (det(Jacobian) > eps) of an element */
   virtual int checkValidity(apf::MeshEntity* e) = 0;
+  /** \brief check the validity of many elements at once
+    \details sets tags[i] to checkValidity(e[i]). The 3D
+    implementation converts the Jacobian determinants of a batch
+    of elements to control points together, which is faster
+    than checking them one at a time */
+  virtual void checkValidities(apf::MeshEntity** e, int count, int* tags);
 protected:
   apf::Mesh* mesh;
   int algorithm;
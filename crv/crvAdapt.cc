@@ -17,6 +17,7 @@
 #include <maLayer.h>
 #include <PCU.h>
 #include <pcu_util.h>
+#include <vector>
 
 namespace crv {
 
@@ -115,23 +116,29 @@ int markInvalidEntities(Adapt* a)
   ma::Mesh* m = a->mesh;
   int dimension = m->getDimension();
   ma::Iterator* it = m->begin(dimension);
-  Quality* qual = makeQuality(m,2);
+  std::vector<ma::Entity*> unchecked;
   while ((e = m->iterate(it)))
   {
     /* this skip conditional is powerful: it affords us a
        3X speedup of the entire adaptation in some cases */
-    int qualityTag = crv::getTag(a,e);
-    if (qualityTag) continue;
-    qualityTag = qual->checkValidity(e);
-    if (qualityTag >= 2)
+    if (crv::getTag(a,e)) continue;
+    unchecked.push_back(e);
+  }
+  m->end(it);
+  std::vector<int> qualityTags(unchecked.size());
+  Quality* qual = makeQuality(m,2);
+  if (!unchecked.empty())
+    qual->checkValidities(&unchecked[0],unchecked.size(),&qualityTags[0]);
+  delete qual;
+  for (size_t i = 0; i < unchecked.size(); ++i)
+  {
+    if (qualityTags[i] >= 2)
     {
-      crv::setTag(a,e,qualityTag);
-      if (m->isOwned(e))
+      crv::setTag(a,unchecked[i],qualityTags[i]);
+      if (m->isOwned(unchecked[i]))
         ++count;
     }
   }
-  m->end(it);
-  delete qual;
   return PCU_Add_Int(count);
 }
 
@@ -213,7 +220,7 @@ void adapt(ma::Input* in)
   {
     ma::print("iteration %d",i);
     ma::coarsen(a);
-    ma::midBalance(a);
+    ma::refineBalance(a);
     crv::refine(a);
     allowSplitCollapseOutsideLayer(a);
     flagCleaner(a); // all true-flags must be false before using markEntities
@@ -21,6 +21,32 @@ static double minAcceptable = 0.0;
 
 static double convergenceTolerance = 0.01;
 
+static int numSplits[apf::Mesh::TYPES] =
+  {0,2,4,0,8,0,0,0};
+
+/* elements whose Jacobian determinant control points are
+   converted together by Quality::checkValidities */
+static int const batchSize = 16;
+
+/* the subdivision coefficients are stored transposed, so that
+   every input control point scales a contiguous row of
+   the output control points */
+static void getSubdivisionMatrices(int P, int type,
+    apf::NewArray<double>& c)
+{
+  getBezierJacobianDetSubdivisionCoefficients(P,type,c);
+  int n = getNumControlPoints(type,P);
+  apf::NewArray<double> t(n*n);
+  for (int k = 0; k < numSplits[type]; ++k){
+    double* ck = &c[k*n*n];
+    for (int i = 0; i < n*n; ++i)
+      t[i] = ck[i];
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+        ck[i*n+j] = t[i+j*n];
+  }
+}
+
 class Quality2D : public Quality
 {
 public:
@@ -35,9 +61,10 @@ public:
     n = getNumControlPoints(apf::Mesh::TRIANGLE,2*(order-1));
     if (algorithm == 0 || algorithm == 2){
       for (int d = 1; d <= 2; ++d)
-      getBezierJacobianDetSubdivisionCoefficients(
-          2*(order-1),apf::Mesh::simplexTypes[d],subdivisionCoeffs[d]);
+        getSubdivisionMatrices(
+            2*(order-1),apf::Mesh::simplexTypes[d],subdivisionCoeffs[d]);
     }
+    work.allocate(maxAdaptiveIter*numSplits[apf::Mesh::TRIANGLE]*n);
   };
   virtual ~Quality2D() {};
   double getQuality(apf::MeshEntity* e);
@@ -46,6 +73,7 @@ public:
   int n;
   apf::NewArray<double> blendingCoeffs;
   apf::NewArray<double> subdivisionCoeffs[3];
+  apf::NewArray<double> work;
 };
 
 class Quality3D : public Quality
@@ -55,10 +83,16 @@ public:
   {
     if (algorithm == 0 || algorithm == 2){
       for (int d = 1; d <= 3; ++d)
-      getBezierJacobianDetSubdivisionCoefficients(
-          3*(order-1),apf::Mesh::simplexTypes[d],subdivisionCoeffs[d]);
+        getSubdivisionMatrices(
+            3*(order-1),apf::Mesh::simplexTypes[d],subdivisionCoeffs[d]);
     }
     n = getNumControlPoints(apf::Mesh::TET,3*(order-1));
+    work.allocate(maxAdaptiveIter*numSplits[apf::Mesh::TET]*n);
+    detNodes.allocate(n);
+    edgeNodes.allocate(getNumControlPoints(apf::Mesh::EDGE,3*(order-1)));
+    triNodes.allocate(getNumControlPoints(apf::Mesh::TRIANGLE,3*(order-1)));
+    samples.allocate(n*batchSize);
+    batchNodes.allocate(n*batchSize);
     xi.allocate(n);
     transformationMatrix.resize(n,n);
     mth::Matrix<double> A(n,n);
@@ -71,16 +105,34 @@ public:
   virtual ~Quality3D() {};
   double getQuality(apf::MeshEntity* e);
   int checkValidity(apf::MeshEntity* e);
+  void checkValidities(apf::MeshEntity** e, int count, int* tags);
   // 3D uses an alternate method of computing these
   // returns a validity tag so both quality and validity can
   // quit early if this function thinks they should
   // if validity = true, quit if its obvious the element is invalid
   int computeJacDetNodes(apf::MeshEntity* e,
       apf::NewArray<double>& nodes, bool validity);
+  // samples det(J) into column zero of a node-major array
+  // whose rows are stride apart
+  int sampleJacDet(apf::MeshEntity* e, double* interNodes, int stride,
+      bool validity);
+  // applies the transformation matrix to count sampled columns
+  void transformJacDet(int count, int stride, double const* interNodes,
+      double* nodes);
+  // validity of an element from its control points
+  int checkJacDetNodes(apf::NewArray<double>& nodes);
   int n;
   apf::NewArray<double> subdivisionCoeffs[4];
   apf::NewArray<apf::Vector3> xi;
   mth::Matrix<double> transformationMatrix;
+  // scratch space reused across calls, so that checking an
+  // element does not allocate
+  apf::NewArray<double> work;
+  apf::NewArray<double> detNodes;
+  apf::NewArray<double> edgeNodes;
+  apf::NewArray<double> triNodes;
+  apf::NewArray<double> samples;
+  apf::NewArray<double> batchNodes;
 };
 
 Quality* makeQuality(apf::Mesh* m, int algorithm)
@@ -100,6 +152,12 @@ Quality::Quality(apf::Mesh* m, int algorithm_) :
   PCU_ALWAYS_ASSERT(order >= 1);
 };
 
+void Quality::checkValidities(apf::MeshEntity** e, int count, int* tags)
+{
+  for (int i = 0; i < count; ++i)
+    tags[i] = checkValidity(e[i]);
+}
+
 /* This work is based on the approach of Geometric Validity of high-order
  * lagrange finite elements, theory and practical guidance,
  * by George, Borouchaki, and Barral. (2014)
@@ -189,7 +247,7 @@ static double Nijkl(apf::NewArray<apf::Vector3>& nodes,
   return sum*d*d*d/CD;
 }
 
-static double calcMinJacDet(int n, apf::NewArray<double>& nodes)
+static double calcMinJacDet(int n, double const* nodes)
 {
   double minJ = 1e10;
   for (int i = 0; i < n; ++i)
@@ -197,7 +255,7 @@ static double calcMinJacDet(int n, apf::NewArray<double>& nodes)
   return minJ;
 }
 
-static double calcMaxJacDet(int n, apf::NewArray<double>& nodes)
+static double calcMaxJacDet(int n, double const* nodes)
 {
   double maxJ = -1e10;
   for (int i = 0; i < n; ++i)
@@ -242,8 +300,8 @@ static void getJacDetByElevation(int type, int P,
   double maxDist[2] = {0.,1e10};
 
   int n = getNumControlPoints(type,P);
-  minJ = calcMinJacDet(n,nodes);
-  maxJ = calcMaxJacDet(n,nodes);
+  minJ = calcMinJacDet(n,&nodes[0]);
+  maxJ = calcMaxJacDet(n,&nodes[0]);
   maxDist[0] = nodes[1]-nodes[0];
   for (int j = 1; j < n-1; ++j)
     maxDist[0] = std::max(maxDist[0],nodes[j+1]-nodes[j]);
@@ -273,8 +331,8 @@ static void getJacDetByElevation(int type, int P,
       maxDist[(i+1) % 2] = std::max(elevatedNodes[(i+1) % 2][j+1]
                          - elevatedNodes[(i+1) % 2][j],maxDist[(i+1) % 2]);
 
-    minJ = calcMinJacDet(ni,elevatedNodes[(i+1) % 2]);
-    maxJ = calcMaxJacDet(ni,elevatedNodes[(i+1) % 2]);
+    minJ = calcMinJacDet(ni,&elevatedNodes[(i+1) % 2][0]);
+    maxJ = calcMaxJacDet(ni,&elevatedNodes[(i+1) % 2][0]);
 
     ++i;
   }
@@ -284,9 +342,6 @@ static void getJacDetByElevation(int type, int P,
  * This is the subdivision version, with recursion
  *
  */
-static int numSplits[apf::Mesh::TYPES] =
-  {0,2,4,0,8,0,0,0};
-
 static void getJacDetBySubdivision(int type, int P,
     int iter, apf::NewArray<double>& nodes,
     double& minJ, double& maxJ, bool& done)
@@ -294,8 +349,8 @@ static void getJacDetBySubdivision(int type, int P,
   int n = getNumControlPoints(type,P);
   double change = minJ;
   if(!done){
-    minJ = calcMinJacDet(n,nodes);
-    maxJ = calcMaxJacDet(n,nodes);
+    minJ = calcMinJacDet(n,&nodes[0]);
+    maxJ = calcMaxJacDet(n,&nodes[0]);
     change = minJ - change;
   }
 
@@ -330,8 +385,57 @@ static void getJacDetBySubdivision(int type, int P,
   }
 }
 
+/* subNodes of split k are the product of its subdivision matrix
+ * with the control points. N is the number of control points
+ * when known at compile time, or 0 to use dynamicN.
+ */
+template <int N>
+static void subdivide(int splits, int dynamicN, double const* c,
+    double const* nodes, double* subNodes)
+{
+  int const n = N ? N : dynamicN;
+  for (int k = 0; k < splits; ++k, c += n*n, subNodes += n){
+    for (int j = 0; j < n; ++j)
+      subNodes[j] = 0.;
+    for (int i = 0; i < n; ++i){
+      double x = nodes[i];
+      double const* ci = c+i*n;
+      for (int j = 0; j < n; ++j)
+        subNodes[j] += x*ci[j];
+    }
+  }
+}
+
+/* the sizes used by orders 2 through 4 in 2D and 3D
+ * get kernels of fixed length
+ */
+static void subdivideJacDet(int type, int n, double const* c,
+    double const* nodes, double* subNodes)
+{
+  int splits = numSplits[type];
+  switch (n) {
+    case 3: subdivide<3>(splits,n,c,nodes,subNodes); break;
+    case 4: subdivide<4>(splits,n,c,nodes,subNodes); break;
+    case 5: subdivide<5>(splits,n,c,nodes,subNodes); break;
+    case 6: subdivide<6>(splits,n,c,nodes,subNodes); break;
+    case 7: subdivide<7>(splits,n,c,nodes,subNodes); break;
+    case 10: subdivide<10>(splits,n,c,nodes,subNodes); break;
+    case 15: subdivide<15>(splits,n,c,nodes,subNodes); break;
+    case 20: subdivide<20>(splits,n,c,nodes,subNodes); break;
+    case 28: subdivide<28>(splits,n,c,nodes,subNodes); break;
+    case 55: subdivide<55>(splits,n,c,nodes,subNodes); break;
+    case 84: subdivide<84>(splits,n,c,nodes,subNodes); break;
+    default: subdivide<0>(splits,n,c,nodes,subNodes);
+  }
+}
+
+/* c holds the matrices from getSubdivisionMatrices.
+ * each level of recursion takes numSplits[type]*n doubles
+ * from the front of work, so work must hold
+ * maxAdaptiveIter*numSplits[type]*n of them
+ */
 static void getJacDetBySubdivisionMatrices(int type, int P,
-    int iter, apf::NewArray<double>& c,apf::NewArray<double>& nodes,
+    int iter, apf::NewArray<double>& c, double* nodes, double* work,
     double& minJ, double& maxJ, bool& done, bool& quality)
 {
   int n = getNumControlPoints(type,P);
@@ -346,26 +450,24 @@ static void getJacDetBySubdivisionMatrices(int type, int P,
       && std::fabs(change) > convergenceTolerance){
 
     iter++;
-    apf::NewArray<double> subNodes[8];
-    for (int i = 0; i < numSplits[type]; ++i)
-      subNodes[i].allocate(n);
+    int splits = numSplits[type];
+    double* subNodes = work;
+    subdivideJacDet(type,n,&c[0],nodes,subNodes);
 
-    subdivideBezierEntityJacobianDet(P,type,c,nodes,subNodes);
-
-    apf::NewArray<double> newMinJ(numSplits[type]);
-    apf::NewArray<double> newMaxJ(numSplits[type]);
-    for (int i = 0; i < numSplits[type]; ++i){
+    double newMinJ[8];
+    double newMaxJ[8];
+    for (int i = 0; i < splits; ++i){
       newMinJ[i] = 1e10;
       newMaxJ[i] = -1e10;
     }
 
-    for (int i = 0; i < numSplits[type]; ++i)
-      getJacDetBySubdivisionMatrices(type,P,iter,c,subNodes[i],
-          newMinJ[i],newMaxJ[i],done,quality);
+    for (int i = 0; i < splits; ++i)
+      getJacDetBySubdivisionMatrices(type,P,iter,c,subNodes+i*n,
+          work+splits*n,newMinJ[i],newMaxJ[i],done,quality);
 
     minJ = newMinJ[0];
     maxJ = newMaxJ[0];
-    for (int i = 1; i < numSplits[type]; ++i){
+    for (int i = 1; i < splits; ++i){
       minJ = std::min(newMinJ[i],minJ);
       maxJ = std::max(newMaxJ[i],maxJ);
     }
@@ -431,7 +533,8 @@ int Quality2D::checkValidity(apf::MeshEntity* e)
           bool done = false;
           bool quality = false;
           getJacDetBySubdivisionMatrices(apf::Mesh::EDGE,2*(order-1),
-              0,subdivisionCoeffs[1],edgeNodes,minJ,maxJ,done,quality);
+              0,subdivisionCoeffs[1],&edgeNodes[0],&work[0],
+              minJ,maxJ,done,quality);
         }
         if(minJ < minAcceptable){
           return 8+edge;
@@ -449,7 +552,8 @@ int Quality2D::checkValidity(apf::MeshEntity* e)
       else if(algorithm == 2){
         bool quality = false;
         getJacDetBySubdivisionMatrices(apf::Mesh::TRIANGLE,2*(order-1),
-            0,subdivisionCoeffs[2],nodes,minJ,maxJ,done,quality);
+            0,subdivisionCoeffs[2],&nodes[0],&work[0],
+            minJ,maxJ,done,quality);
       } else {
         getJacDetBySubdivision(apf::Mesh::TRIANGLE,2*(order-1),
             0,nodes,minJ,maxJ,done);
@@ -464,34 +568,52 @@ int Quality2D::checkValidity(apf::MeshEntity* e)
 
 int Quality3D::checkValidity(apf::MeshEntity* e)
 {
-
-  apf::NewArray<double> nodes(n);
-//  apf::Element* elem = apf::createElement(mesh->getCoordinateField(),e);
-//  apf::NewArray<apf::Vector3> elemNodes;
-//  apf::getVectorNodes(elem,elemNodes);
-//  apf::destroyElement(elem);
-//  getTetJacDetNodes(order,elemNodes,nodes);
-  int validityTag = computeJacDetNodes(e,nodes,true);
+  int validityTag = computeJacDetNodes(e,detNodes,true);
   if (validityTag > 1)
     return validityTag;
+  return checkJacDetNodes(detNodes);
+}
+
+/* the samples of a batch are stored with the element index
+ * fastest, so the transformation matrix is applied to all of
+ * them in one sweep over its entries
+ */
+void Quality3D::checkValidities(apf::MeshEntity** e, int count, int* tags)
+{
+  int batch[batchSize];
+  for (int start = 0; start < count; start += batchSize){
+    int end = std::min(count,start+batchSize);
+    // elements flagged while sampling are left out of the batch
+    int size = 0;
+    for (int i = start; i < end; ++i){
+      tags[i] = sampleJacDet(e[i],&samples[size],batchSize,true);
+      if (tags[i] <= 1)
+        batch[size++] = i;
+    }
+    transformJacDet(size,batchSize,&samples[0],&batchNodes[0]);
+    for (int b = 0; b < size; ++b){
+      for (int j = 0; j < n; ++j)
+        detNodes[j] = batchNodes[j*batchSize+b];
+      tags[batch[b]] = checkJacDetNodes(detNodes);
+    }
+  }
+}
+
+int Quality3D::checkJacDetNodes(apf::NewArray<double>& nodes)
+{
 // check verts
-  apf::Downward verts;
-  mesh->getDownward(e,0,verts);
   for (int i = 0; i < 4; ++i){
     if(nodes[i] < minAcceptable){
       return 2+i;
     }
   }
 
-  apf::MeshEntity* edges[6];
-  mesh->getDownward(e,1,edges);
   double minJ = 0, maxJ = 0;
   // Vertices will already be flagged in the first check
   for (int edge = 0; edge < 6; ++edge){
     for (int i = 0; i < 3*(order-1)-1; ++i){
       if (nodes[4+edge*(3*(order-1)-1)+i] < minAcceptable){
         minJ = -1e10;
-        apf::NewArray<double> edgeNodes(3*(order-1)+1);
 
         if(algorithm < 2){
           edgeNodes[0] = nodes[apf::tet_edge_verts[edge][0]];
@@ -516,7 +638,8 @@ int Quality3D::checkValidity(apf::MeshEntity* e)
           bool done = false;
           bool quality = false;
           getJacDetBySubdivisionMatrices(apf::Mesh::EDGE,3*(order-1),
-              0,subdivisionCoeffs[1],edgeNodes,minJ,maxJ,done,quality);
+              0,subdivisionCoeffs[1],&edgeNodes[0],&work[0],
+              minJ,maxJ,done,quality);
         }
         if(minJ < minAcceptable){
           return 8+edge;
@@ -524,20 +647,18 @@ int Quality3D::checkValidity(apf::MeshEntity* e)
       }
     }
   }
-  apf::MeshEntity* faces[4];
-  mesh->getDownward(e,2,faces);
   for (int face = 0; face < 4; ++face){
     double minJ = -1e10;
     for (int i = 0; i < (3*order-4)*(3*order-5)/2; ++i){
       if (nodes[18*order-20+face*(3*order-4)*(3*order-5)/2+i] < minAcceptable){
         minJ = -1e10;
-        apf::NewArray<double> triNodes((3*order-2)*(3*order-1)/2);
         getTriDetJacNodesFromTetDetJacNodes(face,3*(order-1),nodes,triNodes);
         if(algorithm == 2){
           bool done = false;
           bool quality = false;
           getJacDetBySubdivisionMatrices(apf::Mesh::TRIANGLE,3*(order-1),
-              0,subdivisionCoeffs[2],triNodes,minJ,maxJ,done,quality);
+              0,subdivisionCoeffs[2],&triNodes[0],&work[0],
+              minJ,maxJ,done,quality);
         } else if(algorithm == 1)
           getJacDetByElevation(apf::Mesh::TRIANGLE,3*(order-1),
               triNodes,minJ,maxJ);
@@ -562,7 +683,8 @@ int Quality3D::checkValidity(apf::MeshEntity* e)
         bool done = false;
         bool quality = false;
         getJacDetBySubdivisionMatrices(apf::Mesh::TET,3*(order-1),
-            0,subdivisionCoeffs[3],nodes,minJ,maxJ,done,quality);
+            0,subdivisionCoeffs[3],&nodes[0],&work[0],
+            minJ,maxJ,done,quality);
       }
       if(minJ < minAcceptable){
         return 20;
@@ -617,17 +739,26 @@ double computeTetJacobianDetFromBezierFormulation(apf::Mesh* m,
 int Quality3D::computeJacDetNodes(apf::MeshEntity* e,
     apf::NewArray<double>& nodes, bool validity)
 {
-  apf::NewArray<double> interNodes(n);
+  int validityTag = sampleJacDet(e,&samples[0],1,validity);
+  if (validityTag > 1)
+    return validityTag;
+  transformJacDet(1,1,&samples[0],&nodes[0]);
+  return 1;
+}
+
+int Quality3D::sampleJacDet(apf::MeshEntity* e, double* interNodes,
+    int stride, bool validity)
+{
   apf::MeshElement* me = apf::createMeshElement(mesh,e);
   if (validity == false)
   {
     for (int i = 0; i < n; ++i){
-      interNodes[i] = apf::getDV(me,xi[i]);
+      interNodes[i*stride] = apf::getDV(me,xi[i]);
     }
   }
   for (int i = 0; i < 4; ++i){
-    interNodes[i] = apf::getDV(me,xi[i]);
-    if(interNodes[i] < 1e-10){
+    interNodes[i*stride] = apf::getDV(me,xi[i]);
+    if(interNodes[i*stride] < 1e-10){
       apf::destroyMeshElement(me);
       return i+2;
     }
@@ -635,8 +766,8 @@ int Quality3D::computeJacDetNodes(apf::MeshEntity* e,
   for (int edge = 0; edge < 6; ++edge){
     for (int i = 0; i < 3*(order-1)-1; ++i){
       int index = 4+edge*(3*(order-1)-1)+i;
-      interNodes[index] = apf::getDV(me,xi[index]);
-      if(interNodes[index] < 1e-10){
+      interNodes[index*stride] = apf::getDV(me,xi[index]);
+      if(interNodes[index*stride] < 1e-10){
         apf::destroyMeshElement(me);
         return edge+8;
       }
@@ -645,8 +776,8 @@ int Quality3D::computeJacDetNodes(apf::MeshEntity* e,
   for (int face = 0; face < 4; ++face){
     for (int i = 0; i < (3*order-4)*(3*order-5)/2; ++i){
       int index = 18*order-20+face*(3*order-4)*(3*order-5)/2+i;
-      interNodes[index] = apf::getDV(me,xi[index]);
-      if(interNodes[index] < 1e-10){
+      interNodes[index*stride] = apf::getDV(me,xi[index]);
+      if(interNodes[index*stride] < 1e-10){
         apf::destroyMeshElement(me);
         return face+14;
       }
@@ -654,21 +785,34 @@ int Quality3D::computeJacDetNodes(apf::MeshEntity* e,
   }
   for (int i = 0; i < (3*order-4)*(3*order-5)*(3*order-6)/6; ++i){
     int index = 18*order*order-36*order+20+i;
-    interNodes[index] = apf::getDV(me,xi[index]);
-    if(interNodes[index] < 1e-10){
+    interNodes[index*stride] = apf::getDV(me,xi[index]);
+    if(interNodes[index*stride] < 1e-10){
       apf::destroyMeshElement(me);
       return 20;
     }
   }
   apf::destroyMeshElement(me);
+  return 1;
+}
 
-  for( int i = 0; i < n; ++i){
-    nodes[i] = 0.;
-    for( int j = 0; j < n; ++j)
-      nodes[i] += interNodes[j]*transformationMatrix(i,j);
+/* the innermost loop runs over the columns, which are
+ * independent, so it vectorizes without changing the order
+ * in which each control point is summed
+ */
+void Quality3D::transformJacDet(int count, int stride,
+    double const* interNodes, double* nodes)
+{
+  for (int i = 0; i < n; ++i){
+    double* row = nodes+i*stride;
+    for (int b = 0; b < count; ++b)
+      row[b] = 0.;
+    for (int j = 0; j < n; ++j){
+      double t = transformationMatrix(i,j);
+      double const* column = interNodes+j*stride;
+      for (int b = 0; b < count; ++b)
+        row[b] += column[b]*t;
+    }
   }
-
-  return 1;
 }
 
 double Quality2D::getQuality(apf::MeshEntity* e)
@@ -696,7 +840,7 @@ double Quality2D::getQuality(apf::MeshEntity* e)
   minAcceptable = -1e10;
   bool quality = true;
   getJacDetBySubdivisionMatrices(apf::Mesh::TRIANGLE,2*(order-1),
-      0,subdivisionCoeffs[2],nodes,minJ,maxJ,done,quality);
+      0,subdivisionCoeffs[2],&nodes[0],&work[0],minJ,maxJ,done,quality);
   done = false;
   minAcceptable = oldAcceptable;
   maxAdaptiveIter = oldIter;
@@ -719,8 +863,6 @@ double Quality3D::getQuality(apf::MeshEntity* e)
   //  }
   //  apf::destroyElement(elem);
   // getTetJacDetNodes(order,elemNodes,nodes);
-  apf::NewArray<double> nodes(n);
-
   /* This part is optional, if we use the validity tag,
    * we can decide the entity is invalid, and just return some
    * negative number. While not a true assessment of quality,
@@ -729,7 +871,7 @@ double Quality3D::getQuality(apf::MeshEntity* e)
    * There is some downside to this, I'm sure.
    */
   int validityTag =
-      computeJacDetNodes(e,nodes,false);
+      computeJacDetNodes(e,detNodes,false);
 
   if (validityTag > 1)
     return -1e-10;
@@ -743,7 +885,7 @@ double Quality3D::getQuality(apf::MeshEntity* e)
   minAcceptable = -1e10;
   bool quality = true;
   getJacDetBySubdivisionMatrices(apf::Mesh::TET,3*(order-1),
-      0,subdivisionCoeffs[3],nodes,minJ,maxJ,done,quality);
+      0,subdivisionCoeffs[3],&detNodes[0],&work[0],minJ,maxJ,done,quality);
   done = false;
   minAcceptable = oldAcceptable;
   maxAdaptiveIter = oldIter;
@@ -46,8 +46,10 @@ void displace(apf::Mesh2* m, apf::Field* df,
   smoother->preprocess(m, fixed, moving);
   smoother->smooth(df, fixed, moving);
   smoother->cleanup();
-  while (!tryToDisplace(m, df))
+  while (!tryToDisplace(m, df)) {
     adapter->adapt(m);
+    smoother->invalidate();
+  }
 }
 
 apf::Field* applyRigidMotion(apf::Mesh* m, Boundary& moving,
@@ -26,6 +26,10 @@ void Smoother::cleanup()
 {
 }
 
+void Smoother::invalidate()
+{
+}
+
 class LaplacianSmoother : public Smoother {
 public:
   void smooth(apf::Field* df, Boundary& fixed, Boundary& moving)
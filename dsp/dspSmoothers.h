@@ -14,7 +14,18 @@ class Smoother {
     virtual void preprocess(apf::Mesh* m, Boundary& fixed, Boundary& moving);
     virtual void smooth(apf::Field* df, Boundary& fixed, Boundary& moving) = 0;
     virtual void cleanup();
+    /* called after the mesh topology changes, so that smoothers
+       holding on to mesh entities rebuild what they keep */
+    virtual void invalidate();
     static Smoother* makeLaplacian();
+    /* assembles the edge graph Laplacian once and solves for the
+       interior displacement with Jacobi-preconditioned CG across
+       parts. the assembled system holds mesh entities and is kept
+       between calls on the same mesh and boundary sets until
+       invalidate() is called, which callers must do after any
+       change to the mesh topology. */
+    static Smoother* makeSparseLaplacian(double tolerance = 1e-10,
+        int maxIterations = 10000);
     static Smoother* makeEmpty();
 };
 
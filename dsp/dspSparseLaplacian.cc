@@ -0,0 +1,278 @@
+#include "dspSmoothers.h"
+#include <apf.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <lionPrint.h>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace dsp {
+
+/* the graph Laplacian of the mesh edges, stored in CSR form over
+   local vertices. each edge contributes only on the part that owns
+   it, so summing rows over all copies of a shared vertex gives the
+   global row. */
+struct Laplacian {
+  std::vector<apf::MeshEntity*> verts;
+  std::vector<int> offsets;
+  std::vector<int> neighbors;
+  /* assembled vertex degree, the Jacobi preconditioner */
+  std::vector<double> degree;
+  /* 1 for vertices whose displacement is prescribed */
+  std::vector<char> dirichlet;
+  /* counts each vertex once across parts in dot products */
+  std::vector<char> owned;
+};
+
+/* the vertex exchange pattern between neighboring parts.
+   both sides of a link list the shared vertices in the same order,
+   so values can be packed and unpacked as plain arrays. */
+struct Halo {
+  std::vector<int> peers;
+  std::map<int, int> peerIndex;
+  std::vector<std::vector<int> > sends;
+  std::vector<std::vector<int> > recvs;
+};
+
+static void buildHalo(apf::Mesh* m, apf::MeshTag* ids,
+    std::vector<apf::MeshEntity*> const& verts, Halo& h)
+{
+  PCU_Comm_Begin();
+  apf::FlatCopies remotes;
+  for (size_t i = 0; i < verts.size(); ++i) {
+    if (!m->isShared(verts[i]))
+      continue;
+    m->getFlatRemotes(verts[i], remotes);
+    for (unsigned j = 0; j < remotes.size(); ++j) {
+      int peer = remotes[j].peer;
+      if (!h.peerIndex.count(peer)) {
+        h.peerIndex[peer] = h.peers.size();
+        h.peers.push_back(peer);
+        h.sends.push_back(std::vector<int>());
+        h.recvs.push_back(std::vector<int>());
+      }
+      h.sends[h.peerIndex[peer]].push_back(i);
+      PCU_COMM_PACK(peer, remotes[j].entity);
+    }
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    int peer = PCU_Comm_Sender();
+    PCU_ALWAYS_ASSERT(h.peerIndex.count(peer));
+    std::vector<int>& recv = h.recvs[h.peerIndex[peer]];
+    while (!PCU_Comm_Unpacked()) {
+      apf::MeshEntity* v;
+      PCU_COMM_UNPACK(v);
+      int i;
+      m->getIntTag(v, ids, &i);
+      recv.push_back(i);
+    }
+  }
+}
+
+/* sums the partial per-vertex values held by all copies,
+   leaving every copy with the assembled value */
+template <class T>
+static void accumulate(Halo const& h, std::vector<T>& x)
+{
+  PCU_Comm_Begin();
+  std::vector<T> buf;
+  for (size_t p = 0; p < h.peers.size(); ++p) {
+    std::vector<int> const& send = h.sends[p];
+    buf.resize(send.size());
+    for (size_t i = 0; i < send.size(); ++i)
+      buf[i] = x[send[i]];
+    PCU_Comm_Pack(h.peers[p], &buf[0], buf.size() * sizeof(T));
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    std::vector<int> const& recv =
+      h.recvs[h.peerIndex.find(PCU_Comm_Sender())->second];
+    buf.resize(recv.size());
+    PCU_Comm_Unpack(&buf[0], buf.size() * sizeof(T));
+    for (size_t i = 0; i < recv.size(); ++i)
+      x[recv[i]] = x[recv[i]] + buf[i];
+  }
+}
+
+static void assemble(apf::Mesh* m, Boundary& fixed, Boundary& moving,
+    Laplacian& a, Halo& h)
+{
+  apf::MeshTag* ids = m->createIntTag("dsp_laplacian_id", 1);
+  apf::MeshIterator* it = m->begin(0);
+  apf::MeshEntity* v;
+  while ((v = m->iterate(it))) {
+    int i = a.verts.size();
+    m->setIntTag(v, ids, &i);
+    a.verts.push_back(v);
+    apf::ModelEntity* me = m->toModel(v);
+    a.dirichlet.push_back(fixed.count(me) || moving.count(me));
+    a.owned.push_back(m->isOwned(v));
+  }
+  m->end(it);
+  int nv = a.verts.size();
+  std::vector<int> ends;
+  it = m->begin(1);
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    if (!m->isOwned(e))
+      continue;
+    apf::MeshEntity* ev[2];
+    m->getDownward(e, 0, ev);
+    for (int j = 0; j < 2; ++j) {
+      int i;
+      m->getIntTag(ev[j], ids, &i);
+      ends.push_back(i);
+    }
+  }
+  m->end(it);
+  a.offsets.assign(nv + 1, 0);
+  for (size_t i = 0; i < ends.size(); ++i)
+    ++a.offsets[ends[i] + 1];
+  for (int i = 0; i < nv; ++i)
+    a.offsets[i + 1] += a.offsets[i];
+  a.neighbors.resize(ends.size());
+  std::vector<int> fill(a.offsets.begin(), a.offsets.end() - 1);
+  for (size_t i = 0; i < ends.size(); i += 2) {
+    a.neighbors[fill[ends[i]]++] = ends[i + 1];
+    a.neighbors[fill[ends[i + 1]]++] = ends[i];
+  }
+  buildHalo(m, ids, a.verts, h);
+  apf::removeTagFromDimension(m, ids, 0);
+  m->destroyTag(ids);
+  a.degree.resize(nv);
+  for (int i = 0; i < nv; ++i)
+    a.degree[i] = a.offsets[i + 1] - a.offsets[i];
+  accumulate(h, a.degree);
+}
+
+/* y = L x restricted to the unknown rows, assembled across parts */
+static void multiply(Laplacian const& a, Halo const& h,
+    std::vector<apf::Vector3> const& x, std::vector<apf::Vector3>& y)
+{
+  int nv = a.verts.size();
+  for (int i = 0; i < nv; ++i) {
+    apf::Vector3 s = x[i] * (a.offsets[i + 1] - a.offsets[i]);
+    for (int j = a.offsets[i]; j < a.offsets[i + 1]; ++j)
+      s = s - x[a.neighbors[j]];
+    y[i] = s;
+  }
+  accumulate(h, y);
+  for (int i = 0; i < nv; ++i)
+    if (a.dirichlet[i])
+      y[i] = apf::Vector3(0,0,0);
+}
+
+/* per-component dot products over owned vertices,
+   one for each displacement direction */
+static apf::Vector3 dot(Laplacian const& a,
+    std::vector<apf::Vector3> const& x, std::vector<apf::Vector3> const& y)
+{
+  double d[3] = {0,0,0};
+  for (size_t i = 0; i < x.size(); ++i)
+    if (a.owned[i])
+      for (int j = 0; j < 3; ++j)
+        d[j] += x[i][j] * y[i][j];
+  PCU_Add_Doubles(d, 3);
+  return apf::Vector3(d);
+}
+
+static double norm(Laplacian const& a, std::vector<apf::Vector3> const& x)
+{
+  apf::Vector3 d = dot(a, x, x);
+  return sqrt(d[0] + d[1] + d[2]);
+}
+
+class SparseLaplacianSmoother : public Smoother {
+public:
+  SparseLaplacianSmoother(double t, int n):
+    mesh(0),
+    tolerance(t),
+    maxIterations(n)
+  {
+  }
+  /* the assembled system survives cleanup() and is only rebuilt
+     for a different mesh or boundary sets, or after invalidate(),
+     so repeated displacement steps on the same topology reuse it */
+  void preprocess(apf::Mesh* m, Boundary& fixed, Boundary& moving)
+  {
+    if (m == mesh && fixed == fixedCache && moving == movingCache)
+      return;
+    mesh = m;
+    fixedCache = fixed;
+    movingCache = moving;
+    laplacian = Laplacian();
+    halo = Halo();
+    assemble(m, fixed, moving, laplacian, halo);
+  }
+  void smooth(apf::Field* df, Boundary& fixed, Boundary& moving)
+  {
+    apf::Mesh* m = apf::getMesh(df);
+    preprocess(m, fixed, moving);
+    Laplacian const& a = laplacian;
+    int nv = a.verts.size();
+    std::vector<apf::Vector3> u(nv);
+    for (int i = 0; i < nv; ++i)
+      apf::getVector(df, a.verts[i], 0, u[i]);
+    std::vector<apf::Vector3> r(nv), z(nv), p(nv), q(nv);
+    multiply(a, halo, u, r);
+    for (int i = 0; i < nv; ++i) {
+      r[i] = r[i] * -1.0;
+      z[i] = r[i] / a.degree[i];
+      p[i] = z[i];
+    }
+    apf::Vector3 rz = dot(a, r, z);
+    double r0 = norm(a, r);
+    int iter = 0;
+    for (; iter < maxIterations; ++iter) {
+      double rn = norm(a, r);
+      if (rn <= tolerance * r0 || rn == 0)
+        break;
+      multiply(a, halo, p, q);
+      apf::Vector3 pq = dot(a, p, q);
+      apf::Vector3 alpha;
+      for (int j = 0; j < 3; ++j)
+        alpha[j] = pq[j] ? rz[j] / pq[j] : 0;
+      for (int i = 0; i < nv; ++i)
+        for (int j = 0; j < 3; ++j) {
+          u[i][j] += alpha[j] * p[i][j];
+          r[i][j] -= alpha[j] * q[i][j];
+          z[i][j] = r[i][j] / a.degree[i];
+        }
+      apf::Vector3 rz1 = dot(a, r, z);
+      for (int j = 0; j < 3; ++j) {
+        double beta = rz[j] ? rz1[j] / rz[j] : 0;
+        for (int i = 0; i < nv; ++i)
+          p[i][j] = z[i][j] + beta * p[i][j];
+      }
+      rz = rz1;
+    }
+    if (!PCU_Comm_Self())
+      lion_oprint(1, "dsp: Laplacian CG took %d iterations\n", iter);
+    for (int i = 0; i < nv; ++i)
+      if (!a.dirichlet[i])
+        apf::setVector(df, a.verts[i], 0, u[i]);
+  }
+  void invalidate()
+  {
+    mesh = 0;
+    laplacian = Laplacian();
+    halo = Halo();
+  }
+private:
+  apf::Mesh* mesh;
+  Boundary fixedCache;
+  Boundary movingCache;
+  Laplacian laplacian;
+  Halo halo;
+  double tolerance;
+  int maxIterations;
+};
+
+Smoother* Smoother::makeSparseLaplacian(double tolerance, int maxIterations)
+{
+  return new SparseLaplacianSmoother(tolerance, maxIterations);
+}
+
+}
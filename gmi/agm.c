@@ -57,6 +57,7 @@ struct agm {
   struct uses uses;
   struct bdrys bdrys;
   struct agm_tags tags;
+  int shared;
 };
 
 struct agm* agm_new(void)
@@ -115,6 +116,7 @@ static void free_bdrys(struct bdrys* b)
 
 void agm_free(struct agm* m)
 {
+  PCU_ALWAYS_ASSERT(!m->shared);
   free_ents(&m->ents);
   free_uses(&m->uses);
   free_bdrys(&m->bdrys);
@@ -125,6 +127,7 @@ void agm_free(struct agm* m)
 // seol
 void agm_free_tags(struct agm* m)
 {
+  PCU_ALWAYS_ASSERT(!m->shared);
   free_tags(&m->tags);
 }
 
@@ -173,6 +176,7 @@ void agm_reserve(struct agm* m, enum agm_ent_type t, int n)
 {
   struct ents* e;
   e = &m->ents;
+  PCU_ALWAYS_ASSERT(!m->shared);
   PCU_ALWAYS_ASSERT(e->n[t] <= n);
   resize(&e->first_use[t], n);
   resize(&e->first_bdry[t], n);
@@ -187,6 +191,7 @@ struct agm_ent agm_add_ent(struct agm* m, enum agm_ent_type t)
   struct agm_ent ent;
   e = &m->ents;
   ent.type = t;
+  PCU_ALWAYS_ASSERT(!m->shared);
   if (e->n[t] == e->cap[t]) {
     grow(&e->cap[t]);
     agm_reserve(m, t, e->cap[t]);
@@ -213,6 +218,7 @@ struct agm_bdry agm_add_bdry(struct agm* m, struct agm_ent e)
   enum agm_bdry_type t;
   b = &m->bdrys;
   bdry.type = t = ent_bdry_types[e.type];
+  PCU_ALWAYS_ASSERT(!m->shared);
   if (b->n[t] == b->cap[t]) {
     grow(&b->cap[t]);
     resize(&b->next_bdry[t], b->cap[t]);
@@ -266,6 +272,7 @@ struct agm_use agm_add_use(struct agm* m, struct agm_bdry b, struct agm_ent of)
   u = &m->uses;
   use.type = t = bdry_use_types[b.type];
   PCU_ALWAYS_ASSERT(of.type == use_ent_types[use.type]);
+  PCU_ALWAYS_ASSERT(!m->shared);
   if (u->n[t] == u->cap[t]) {
     grow(&u->cap[t]);
     resize(&u->used[t], u->cap[t]);
@@ -506,6 +513,83 @@ void* agm_tag_at(struct agm_tag* t, enum agm_obj_type o,
   return *data + t->bytes * index;
 }
 
+static int get_count(struct agm* m, enum agm_obj_type o, int subtype)
+{
+  switch (o) {
+    case AGM_ENTITY:
+      return m->ents.n[subtype];
+    case AGM_USE:
+      return m->uses.n[subtype];
+    case AGM_BOUNDARY:
+      return m->bdrys.n[subtype];
+    default:
+      PCU_ALWAYS_ASSERT(!"bad obj type");
+  }
+  return 0;
+}
+
+static int const subtype_counts[AGM_OBJ_TYPES] = {
+  AGM_ENT_TYPES,
+  AGM_USE_TYPES,
+  AGM_BDRY_TYPES
+};
+
+static void visit_ints(int** a, int n, agm_array_op op, void* u)
+{
+  void* p = *a;
+  op(&p, n * sizeof(int), u);
+  *a = p;
+}
+
+void agm_visit_arrays(struct agm* m, agm_array_op op, void* u)
+{
+  int t;
+  int o;
+  struct agm_tag* tag;
+  void* p;
+  for (t = 0; t < AGM_ENT_TYPES; ++t) {
+    visit_ints(&m->ents.first_use[t], m->ents.n[t], op, u);
+    visit_ints(&m->ents.first_bdry[t], m->ents.n[t], op, u);
+    visit_ints(&m->ents.last_bdry[t], m->ents.n[t], op, u);
+  }
+  for (t = 0; t < AGM_USE_TYPES; ++t) {
+    visit_ints(&m->uses.used[t], m->uses.n[t], op, u);
+    visit_ints(&m->uses.next_use_of[t], m->uses.n[t], op, u);
+    visit_ints(&m->uses.next_use_by[t], m->uses.n[t], op, u);
+    visit_ints(&m->uses.user[t], m->uses.n[t], op, u);
+  }
+  for (t = 0; t < AGM_BDRY_TYPES; ++t) {
+    visit_ints(&m->bdrys.next_bdry[t], m->bdrys.n[t], op, u);
+    visit_ints(&m->bdrys.first_use[t], m->bdrys.n[t], op, u);
+    visit_ints(&m->bdrys.last_use[t], m->bdrys.n[t], op, u);
+    visit_ints(&m->bdrys.bounds[t], m->bdrys.n[t], op, u);
+  }
+  for (tag = m->tags.first; tag; tag = tag->next)
+    for (o = 0; o < AGM_OBJ_TYPES; ++o)
+      for (t = 0; t < subtype_counts[o]; ++t) {
+        p = tag->data[o][t];
+        op(&p, (size_t)tag->bytes * get_count(m, o, t), u);
+        tag->data[o][t] = p;
+      }
+}
+
+void agm_fit(struct agm* m)
+{
+  int t;
+  PCU_ALWAYS_ASSERT(!m->shared);
+  for (t = 0; t < AGM_ENT_TYPES; ++t)
+    m->ents.cap[t] = m->ents.n[t];
+  for (t = 0; t < AGM_USE_TYPES; ++t)
+    m->uses.cap[t] = m->uses.n[t];
+  for (t = 0; t < AGM_BDRY_TYPES; ++t)
+    m->bdrys.cap[t] = m->bdrys.n[t];
+}
+
+void agm_set_shared(struct agm* m, int shared)
+{
+  m->shared = shared;
+}
+
 /* yes, these tables are the identity map for now,
    but we will cause trouble later if we just
    cast back and forth everywhere */
@@ -11,6 +11,8 @@
 #ifndef AGM_H
 #define AGM_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -107,6 +109,16 @@ struct agm_tag* agm_new_tag(struct agm* m, int bytes);
 void* agm_tag_at(struct agm_tag* t, enum agm_obj_type o,
     int subtype, int index);
 
+/* called on each array that holds part of the topology or its
+   tags, with its size in bytes, so that it can be moved */
+typedef void (*agm_array_op)(void** array, size_t bytes, void* u);
+void agm_visit_arrays(struct agm* m, agm_array_op op, void* u);
+/* sets every capacity to the current count, so that the
+   arrays agm_visit_arrays gives hold exactly that many */
+void agm_fit(struct agm* m);
+/* while set, the arrays are not this rank's to grow or free */
+void agm_set_shared(struct agm* m, int shared);
+
 enum agm_ent_type agm_type_from_dim(int dim);
 int agm_dim_from_type(enum agm_ent_type t);
 
@@ -320,6 +320,7 @@ static struct gmi_model_ops ops = {
   .tag      = gmi_base_tag,
   .find     = gmi_base_find,
   .adjacent = gmi_base_adjacent,
+  .is_in_closure_of = gmi_base_is_in_closure_of,
   .eval     = eval,
   .reparam  = reparam,
   .periodic = periodic,
@@ -9,7 +9,10 @@
 *******************************************************************************/
 #include "gmi_base.h"
 #include "gmi_lookup.h"
+#include "gmi_closure.h"
 #include "agm.h"
+#include <pcu_shm.h>
+#include <pcu_util.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -21,6 +24,7 @@ struct gmi_model_ops gmi_base_ops = {
   .tag      = gmi_base_tag,
   .find     = gmi_base_find,
   .adjacent = gmi_base_adjacent,
+  .is_in_closure_of = gmi_base_is_in_closure_of,
   .destroy  = gmi_base_destroy
 };
 
@@ -161,12 +165,29 @@ static struct gmi_set* get_down(struct agm* topo, struct agm_ent e)
   return s;
 }
 
+static struct gmi_set* copy_set(struct gmi_ent* const* ents, int n)
+{
+  struct gmi_set* s;
+  s = gmi_make_set(n);
+  memcpy(s->e, ents, n * sizeof(*ents));
+  return s;
+}
+
 struct gmi_set* gmi_base_adjacent(struct gmi_model* m, struct gmi_ent* e,
     int dim)
 {
   int from_dim;
   struct agm_ent a;
+  struct gmi_closure* c;
+  struct gmi_ent* const* ents;
+  int n;
   a = agm_from_gmi(e);
+  c = to_base(m)->closure;
+  if (c) {
+    ents = gmi_closure_adjacent(c, a, dim, &n);
+    if (ents)
+      return copy_set(ents, n);
+  }
   from_dim = agm_dim_from_type(a.type);
   if (dim == from_dim - 1)
     return get_down(to_base(m)->topo, a);
@@ -176,10 +197,31 @@ struct gmi_set* gmi_base_adjacent(struct gmi_model* m, struct gmi_ent* e,
   return 0;
 }
 
+int gmi_base_is_in_closure_of(struct gmi_model* m, struct gmi_ent* e,
+    struct gmi_ent* et)
+{
+  struct gmi_base* b;
+  struct agm_ent a;
+  struct agm_ent at;
+  struct agm_use path[4];
+  b = to_base(m);
+  a = agm_from_gmi(e);
+  at = agm_from_gmi(et);
+  if (b->closure)
+    return gmi_closure_contains(b->closure, a, at);
+  if (a.type > at.type)
+    return 0;
+  return agm_find_path(b->topo, a, at, path) != -1;
+}
+
 void gmi_base_destroy(struct gmi_model* m)
 {
   struct gmi_base* b;
   b = to_base(m);
+  if (b->shm)
+    gmi_fail("gmi_destroy: the model is still node-shared, "
+        "call gmi_base_unshare on every rank first");
+  gmi_free_closure(b->closure);
   gmi_free_lookup(b->lookup);
   agm_free(b->topo);
   free(b);
@@ -189,6 +231,8 @@ void gmi_base_init(struct gmi_base* m)
 {
   m->topo = agm_new();
   m->lookup = gmi_new_lookup(m->topo);
+  m->closure = 0;
+  m->shm = 0;
 }
 
 void gmi_base_reserve(struct gmi_base* m, int dim, int n)
@@ -204,13 +248,110 @@ void gmi_base_freeze(struct gmi_model* m)
   b = to_base(m);
   for (i = 0; i <= 3; ++i)
     gmi_freeze_lookup(b->lookup, i);
+  gmi_base_build_closure(m);
 }
 
 void gmi_base_unfreeze(struct gmi_model* m)
 {
   struct gmi_base* b;
   b = to_base(m);
+  PCU_ALWAYS_ASSERT(!b->shm);
   gmi_unfreeze_lookups(b->lookup);
+  gmi_free_closure(b->closure);
+  b->closure = 0;
+}
+
+void gmi_base_build_closure(struct gmi_model* m)
+{
+  struct gmi_base* b;
+  b = to_base(m);
+  PCU_ALWAYS_ASSERT(!b->shm);
+  gmi_free_closure(b->closure);
+  b->closure = gmi_build_closure(b->topo);
+}
+
+enum {
+  /* only measure the block */
+  MOVE_MEASURE,
+  /* copy each array into the block */
+  MOVE_PACK,
+  /* free each array and point it into the block,
+     which holds its bytes already */
+  MOVE_ADOPT,
+  /* point each array to a private copy of itself */
+  MOVE_UNSHARE
+};
+
+struct mover {
+  char* block;
+  size_t at;
+  int mode;
+};
+
+/* lays the arrays out in one block at 8 byte alignment.
+   empty and missing arrays stay where they are */
+static void move_array(void** array, size_t bytes, void* u)
+{
+  struct mover* m = u;
+  void* p;
+  if (!*array || !bytes)
+    return;
+  m->at = (m->at + 7) & ~((size_t)7);
+  if (m->mode == MOVE_PACK)
+    memcpy(m->block + m->at, *array, bytes);
+  else if (m->mode == MOVE_ADOPT) {
+    free(*array);
+    *array = m->block + m->at;
+  } else if (m->mode == MOVE_UNSHARE) {
+    p = malloc(bytes);
+    memcpy(p, *array, bytes);
+    *array = p;
+  }
+  m->at += bytes;
+}
+
+static size_t move_arrays(struct gmi_base* b, char* block, int mode)
+{
+  struct mover m;
+  m.block = block;
+  m.at = 0;
+  m.mode = mode;
+  agm_visit_arrays(b->topo, move_array, &m);
+  gmi_visit_lookup_arrays(b->lookup, move_array, &m);
+  gmi_visit_closure_arrays(b->closure, move_array, &m);
+  return m.at;
+}
+
+void gmi_base_share(struct gmi_model* m)
+{
+  struct gmi_base* b;
+  size_t size;
+  char* packed;
+  void* copy;
+  b = to_base(m);
+  PCU_ALWAYS_ASSERT(b->closure);
+  if (b->shm)
+    return;
+  agm_fit(b->topo);
+  size = move_arrays(b, 0, MOVE_MEASURE);
+  packed = malloc(size + 1);
+  move_arrays(b, packed, MOVE_PACK);
+  b->shm = pcu_shm_share(packed, size, &copy);
+  free(packed);
+  move_arrays(b, copy, MOVE_ADOPT);
+  agm_set_shared(b->topo, 1);
+}
+
+void gmi_base_unshare(struct gmi_model* m)
+{
+  struct gmi_base* b;
+  b = to_base(m);
+  if (!b->shm)
+    return;
+  move_arrays(b, 0, MOVE_UNSHARE);
+  pcu_shm_close(b->shm);
+  b->shm = 0;
+  agm_set_shared(b->topo, 0);
 }
 
 void gmi_base_set_tag(struct gmi_model* m, struct gmi_ent* e, int tag)
@@ -18,6 +18,8 @@ extern "C" {
 #endif
 
 struct gmi_lookup;
+struct gmi_closure;
+struct pcu_shm;
 
 /* base struct for all the internal gmi structures:
    mesh, null, analytic, etc. */
@@ -26,6 +28,12 @@ struct gmi_base {
   struct gmi_model model;
   struct agm* topo;
   struct gmi_lookup* lookup;
+  /* frozen topology for fast queries, zero until
+     gmi_base_build_closure is called */
+  struct gmi_closure* closure;
+  /* set while the arrays of topo, lookup and closure
+     live in node-shared memory, see gmi_base_share */
+  struct pcu_shm* shm;
 };
 
 struct gmi_ent* gmi_from_agm(struct agm_ent e);
@@ -43,9 +51,29 @@ int gmi_base_tag(struct gmi_model* m, struct gmi_ent* e);
 struct gmi_ent* gmi_base_find(struct gmi_model* m, int dim, int tag);
 struct gmi_set* gmi_base_adjacent(struct gmi_model* m, struct gmi_ent* e,
     int dim);
+int gmi_base_is_in_closure_of(struct gmi_model* m, struct gmi_ent* e,
+    struct gmi_ent* et);
 
+/* freezes the tag lookups and builds the topology closure.
+   the topology must not change until gmi_base_unfreeze */
 void gmi_base_freeze(struct gmi_model* m);
 void gmi_base_unfreeze(struct gmi_model* m);
+/* builds only the topology closure, for models whose
+   lookups were frozen one dimension at a time */
+void gmi_base_build_closure(struct gmi_model* m);
+/* moves the arrays of the topology, its tags, the frozen tag
+   lookups and the closure into memory shared by the ranks of each
+   compute node, keeping one copy per node, so that only small
+   headers stay with each rank. collective over the PCU
+   communicator, on a model with a closure that every rank loaded
+   the same way. the model must not change while it is shared,
+   and gmi_destroy fails on it until gmi_base_unshare */
+void gmi_base_share(struct gmi_model* m);
+/* gives this rank a private copy of a shared model again and
+   releases the node copy. collective over the communicator
+   gmi_base_share ran on, so call it while all those ranks are
+   together. does nothing to a model that is not shared */
+void gmi_base_unshare(struct gmi_model* m);
 
 int gmi_base_index(struct gmi_ent* e);
 struct gmi_ent* gmi_base_identify(int dim, int idx);
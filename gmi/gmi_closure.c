@@ -0,0 +1,282 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include "gmi_closure.h"
+#include "gmi_base.h"
+#include <stdlib.h>
+
+struct adjacency {
+  int* offsets;
+  struct gmi_ent** ents;
+};
+
+struct ids {
+  int* offsets;
+  int* ids;
+};
+
+struct gmi_closure {
+  int n[4];
+  /* up[d] lists the entities of dimension d + 1 around each
+     entity of dimension d, and down[d] those of dimension d - 1 */
+  struct adjacency up[3];
+  struct adjacency down[4];
+  /* closure[d][c] lists the sorted indices of the entities
+     of dimension c in the closure of each entity of dimension d */
+  struct ids closure[4][3];
+};
+
+static int count_up(struct agm* topo, struct agm_ent e)
+{
+  return agm_use_count_of(topo, e);
+}
+
+static int fill_up(struct agm* topo, struct agm_ent e, struct gmi_ent** out)
+{
+  struct agm_use u;
+  int i = 0;
+  for (u = agm_first_use_of(topo, e);
+       !agm_use_null(u);
+       u = agm_next_use_of(topo, u))
+    out[i++] = gmi_from_agm(agm_bounds(topo, agm_user(topo, u)));
+  return i;
+}
+
+static int count_down(struct agm* topo, struct agm_ent e)
+{
+  return agm_down_count(topo, e);
+}
+
+static int fill_down(struct agm* topo, struct agm_ent e,
+    struct gmi_ent** out)
+{
+  struct agm_bdry b;
+  struct agm_use u;
+  int i = 0;
+  for (b = agm_first_bdry_of(topo, e);
+       !agm_bdry_null(b);
+       b = agm_next_bdry_of(topo, b))
+    for (u = agm_first_use_by(topo, b);
+         !agm_use_null(u);
+         u = agm_next_use_by(topo, u))
+      out[i++] = gmi_from_agm(agm_used(topo, u));
+  return i;
+}
+
+/* a count pass and a fill pass over the entities of one dimension */
+static void build_adjacency(struct agm* topo, int dim, struct adjacency* a,
+    int (*count)(struct agm*, struct agm_ent),
+    int (*fill)(struct agm*, struct agm_ent, struct gmi_ent**))
+{
+  struct agm_ent e;
+  int n;
+  int i;
+  n = agm_ent_count(topo, agm_type_from_dim(dim));
+  a->offsets = malloc((n + 1) * sizeof(int));
+  a->offsets[0] = 0;
+  e.type = agm_type_from_dim(dim);
+  for (i = 0; i < n; ++i) {
+    e.id = i;
+    a->offsets[i + 1] = a->offsets[i] + count(topo, e);
+  }
+  a->ents = malloc((a->offsets[n] + 1) * sizeof(struct gmi_ent*));
+  for (i = 0; i < n; ++i) {
+    e.id = i;
+    fill(topo, e, a->ents + a->offsets[i]);
+  }
+}
+
+static void free_adjacency(struct adjacency* a)
+{
+  free(a->offsets);
+  free(a->ents);
+}
+
+static int compare_ints(const void* va, const void* vb)
+{
+  int a = *(const int*)va;
+  int b = *(const int*)vb;
+  return (a > b) - (a < b);
+}
+
+struct builder {
+  struct ids* out;
+  int* seen;
+  int size;
+  int cap;
+};
+
+static void add_id(struct builder* b, int id, int stamp)
+{
+  if (b->seen[id] == stamp)
+    return;
+  b->seen[id] = stamp;
+  if (b->size == b->cap) {
+    b->cap *= 2;
+    b->out->ids = realloc(b->out->ids, b->cap * sizeof(int));
+  }
+  b->out->ids[b->size++] = id;
+}
+
+/* the closure of an entity in dimension to is the union of
+   the closures of the entities one level down, which were
+   built before it */
+static void build_ids(struct gmi_closure* c, int dim, int to)
+{
+  struct builder b;
+  struct adjacency* down;
+  struct ids* below;
+  int i;
+  int j;
+  int k;
+  int y;
+  down = &c->down[dim];
+  below = (to < dim - 1) ? &c->closure[dim - 1][to] : 0;
+  b.out = &c->closure[dim][to];
+  b.seen = malloc((c->n[to] + 1) * sizeof(int));
+  for (i = 0; i < c->n[to]; ++i)
+    b.seen[i] = -1;
+  b.size = 0;
+  b.cap = c->n[dim] + 1;
+  b.out->ids = malloc(b.cap * sizeof(int));
+  b.out->offsets = malloc((c->n[dim] + 1) * sizeof(int));
+  for (i = 0; i < c->n[dim]; ++i) {
+    b.out->offsets[i] = b.size;
+    for (j = down->offsets[i]; j < down->offsets[i + 1]; ++j) {
+      y = gmi_base_index(down->ents[j]);
+      if (!below)
+        add_id(&b, y, i);
+      else
+        for (k = below->offsets[y]; k < below->offsets[y + 1]; ++k)
+          add_id(&b, below->ids[k], i);
+    }
+    qsort(b.out->ids + b.out->offsets[i], b.size - b.out->offsets[i],
+        sizeof(int), compare_ints);
+  }
+  b.out->offsets[c->n[dim]] = b.size;
+  free(b.seen);
+}
+
+struct gmi_closure* gmi_build_closure(struct agm* topo)
+{
+  struct gmi_closure* c;
+  int d;
+  int to;
+  c = calloc(1, sizeof(*c));
+  for (d = 0; d < 4; ++d)
+    c->n[d] = agm_ent_count(topo, agm_type_from_dim(d));
+  for (d = 0; d < 3; ++d)
+    build_adjacency(topo, d, &c->up[d], count_up, fill_up);
+  for (d = 1; d < 4; ++d)
+    build_adjacency(topo, d, &c->down[d], count_down, fill_down);
+  for (d = 1; d < 4; ++d)
+    for (to = d - 1; to >= 0; --to)
+      build_ids(c, d, to);
+  return c;
+}
+
+void gmi_free_closure(struct gmi_closure* c)
+{
+  int d;
+  int to;
+  if (!c)
+    return;
+  for (d = 0; d < 3; ++d)
+    free_adjacency(&c->up[d]);
+  for (d = 1; d < 4; ++d) {
+    free_adjacency(&c->down[d]);
+    for (to = 0; to < d; ++to) {
+      free(c->closure[d][to].offsets);
+      free(c->closure[d][to].ids);
+    }
+  }
+  free(c);
+}
+
+static void visit_adjacency(struct adjacency* a, int n,
+    agm_array_op op, void* u)
+{
+  void* p;
+  p = a->offsets;
+  op(&p, (n + 1) * sizeof(int), u);
+  a->offsets = p;
+  p = a->ents;
+  op(&p, a->offsets[n] * sizeof(struct gmi_ent*), u);
+  a->ents = p;
+}
+
+static void visit_ids(struct ids* l, int n, agm_array_op op, void* u)
+{
+  void* p;
+  p = l->offsets;
+  op(&p, (n + 1) * sizeof(int), u);
+  l->offsets = p;
+  p = l->ids;
+  op(&p, l->offsets[n] * sizeof(int), u);
+  l->ids = p;
+}
+
+void gmi_visit_closure_arrays(struct gmi_closure* c, agm_array_op op,
+    void* u)
+{
+  int d;
+  int to;
+  for (d = 0; d < 4; ++d) {
+    if (d < 3)
+      visit_adjacency(&c->up[d], c->n[d], op, u);
+    if (d > 0)
+      visit_adjacency(&c->down[d], c->n[d], op, u);
+    for (to = 0; to < d; ++to)
+      visit_ids(&c->closure[d][to], c->n[d], op, u);
+  }
+}
+
+struct gmi_ent* const* gmi_closure_adjacent(struct gmi_closure* c,
+    struct agm_ent e, int dim, int* n)
+{
+  struct adjacency* a;
+  int from;
+  from = agm_dim_from_type(e.type);
+  if (dim == from + 1 && from < 3)
+    a = &c->up[from];
+  else if (dim == from - 1 && from > 0)
+    a = &c->down[from];
+  else {
+    *n = 0;
+    return 0;
+  }
+  *n = a->offsets[e.id + 1] - a->offsets[e.id];
+  return a->ents + a->offsets[e.id];
+}
+
+int gmi_closure_contains(struct gmi_closure* c, struct agm_ent e,
+    struct agm_ent et)
+{
+  struct ids* l;
+  int d;
+  int to;
+  int lo;
+  int hi;
+  int mid;
+  d = agm_dim_from_type(et.type);
+  to = agm_dim_from_type(e.type);
+  if (to > d)
+    return 0;
+  if (to == d)
+    return e.id == et.id;
+  l = &c->closure[d][to];
+  lo = l->offsets[et.id];
+  hi = l->offsets[et.id + 1];
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (l->ids[mid] < e.id)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo < l->offsets[et.id + 1] && l->ids[lo] == e.id;
+}
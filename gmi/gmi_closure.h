@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef GMI_CLOSURE_H
+#define GMI_CLOSURE_H
+
+#include "gmi.h"
+#include "agm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* an immutable copy of the topology of an agm model,
+   taken once the model is complete. It holds the one-level
+   adjacencies in the order gmi_base_adjacent gives them, and
+   the sorted closure of every entity in each lower dimension,
+   so queries neither walk the agm structures nor allocate */
+struct gmi_closure;
+
+struct gmi_closure* gmi_build_closure(struct agm* topo);
+void gmi_free_closure(struct gmi_closure* c);
+/* its arrays, see agm_visit_arrays */
+void gmi_visit_closure_arrays(struct gmi_closure* c, agm_array_op op,
+    void* u);
+
+/* the entities of dimension dim one level above or below e,
+   pointing into the closure */
+struct gmi_ent* const* gmi_closure_adjacent(struct gmi_closure* c,
+    struct agm_ent e, int dim, int* n);
+
+/* whether e is et itself or bounds it, directly or not */
+int gmi_closure_contains(struct gmi_closure* c, struct agm_ent e,
+    struct agm_ent et);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -124,6 +124,7 @@ void gmi_base_read_dmg(struct gmi_base* m, FILE* f)
     }
   }
   gmi_freeze_lookup(m->lookup, 3);
+  gmi_base_build_closure(&m->model);
 }
 
 static int starts_with(char const* with, char const* s)
@@ -219,4 +220,5 @@ void gmi_base_read_tess(struct gmi_base* m, FILE* f)
     }
   }
   gmi_freeze_lookup(m->lookup, 3);
+  gmi_base_build_closure(&m->model);
 }
@@ -99,6 +99,17 @@ void gmi_unfreeze_lookups(struct gmi_lookup* l)
   }
 }
 
+void gmi_visit_lookup_arrays(struct gmi_lookup* l, agm_array_op op, void* u)
+{
+  enum agm_ent_type t;
+  void* p;
+  for (t = 0; t < AGM_ENT_TYPES; ++t) {
+    p = l->sorted[t];
+    op(&p, agm_ent_count(l->topo, t) * sizeof(struct entry), u);
+    l->sorted[t] = p;
+  }
+}
+
 void gmi_free_lookup(struct gmi_lookup* l)
 {
   gmi_unfreeze_lookups(l);
@@ -26,6 +26,9 @@ int gmi_get_lookup(struct gmi_lookup* l, struct agm_ent e);
 struct agm_ent gmi_look_up(struct gmi_lookup* l, enum agm_ent_type t, int tag);
 void gmi_freeze_lookup(struct gmi_lookup* l, enum agm_ent_type t);
 void gmi_unfreeze_lookups(struct gmi_lookup* l);
+/* the frozen sorted tables, see agm_visit_arrays.
+   the tags themselves are an agm tag of the topology */
+void gmi_visit_lookup_arrays(struct gmi_lookup* l, agm_array_op op, void* u);
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -20,6 +20,7 @@ set(SOURCES
    gmi_base.c
    gmi_file.c
    gmi_lookup.c
+   gmi_closure.c
    gmi_mesh.c
    gmi_null.c
    gmi_analytic.c)
@@ -29,6 +30,7 @@ set(HEADERS
    agm.h
    gmi_base.h
    gmi_lookup.h
+   gmi_closure.h
    gmi_mesh.h
    gmi_null.h
    gmi_analytic.h)
@@ -33,7 +33,7 @@ void adapt(Input* in)
     print("iteration %d",i);
     coarsen(a);
     coarsenLayer(a);
-    midBalance(a);
+    refineBalance(a);
     refine(a);
     snap(a);
   }
@@ -65,7 +65,7 @@ void adaptVerbose(Input* in, bool verbose)
     if (verbose && in->shouldCoarsen)
       ma_dbg::dumpMeshWithQualities(a,i,"after_coarsen");
     coarsenLayer(a);
-    midBalance(a);
+    refineBalance(a);
     refine(a);
     if (verbose)
       ma_dbg::dumpMeshWithQualities(a,i,"after_refine");
@@ -1,6 +1,7 @@
 #include <PCU.h>
 #include "maBalance.h"
 #include "maAdapt.h"
+#include "maTables.h"
 #include <parma.h>
 #include <apfZoltan.h>
 
@@ -90,22 +91,132 @@ Tag* getElementWeights(Adapt* a)
   return weights;
 }
 
-static void runBalancer(Adapt* a, apf::Balancer* b)
+/* the number of elements each simplex refinement template
+   makes, by template index. the tet templates that cut out
+   prisms (3_4 and 4_2) can fall into the centroid case, which
+   is decided by diagonals made during the split; they are
+   counted by their usual case. */
+static int const tri_template_elements[tri_edge_code_count] =
+{1,2,3,4};
+static int const tet_template_elements[tet_edge_code_count] =
+{1,2,3,4,4,5,5,4,6,6,7,8};
+
+static bool willSplit(Adapt* a, Entity* edge)
+{
+  if (getFlags(a,edge) & (DONT_SPLIT | NEED_NOT_SPLIT))
+    return false;
+  return a->sizeField->shouldSplit(edge);
+}
+
+static bool willCollapse(Adapt* a, Entity* edge)
+{
+  if (getFlags(a,edge) & (DONT_COLLAPSE | NEED_NOT_COLLAPSE))
+    return false;
+  return a->sizeField->shouldCollapse(edge);
+}
+
+/* boundary layer elements are refined in whole stacks, so
+   they keep the size field estimate, limited to what one
+   refinement or coarsening pass can do to them */
+static double getPredictedLayerWeight(Adapt* a, Entity* e, int type)
+{
+  double max = pow(2.0, a->mesh->getDimension());
+  double weight = clamp(getSizeWeight(a, e, type), max, 1.0 / 4.0);
+  weight = clampForLayerPermissions(a, type, weight);
+  return accountForTets(a, type, weight);
+}
+
+/* the number of elements this element will become in the
+   next refinement, found the same way refine marks edges
+   and matches templates. every weight counts elements after
+   that one pass: triangles and tets count their template
+   exactly, unsplit elements with a short edge count the
+   one-iteration coarsening estimate of clampForIterations
+   if another coarsening pass is coming, and layer elements
+   use getPredictedLayerWeight */
+double getPredictedWeight(Adapt* a, Entity* e)
 {
   Mesh* m = a->mesh;
-  Input* in = a->input;
-  Tag* weights = getElementWeights(a);
-  b->balance(weights,in->maximumImbalance);
-  delete b;
+  int type = m->getType(e);
+  if (type != apf::Mesh::TRIANGLE && type != apf::Mesh::TET)
+    return getPredictedLayerWeight(a,e,type);
+  Downward edges;
+  int ne = m->getDownward(e,1,edges);
+  int code = 0;
+  bool isShort = false;
+  for (int i=0; i < ne; ++i)
+    if (willSplit(a,edges[i]))
+      code |= (1<<i);
+    else if (willCollapse(a,edges[i]))
+      isShort = true;
+  if ( ! code) {
+    if (isShort && a->input->shouldCoarsen && a->coarsensLeft > 0)
+      return 1.0 / 4.0;
+    return 1.0;
+  }
+  int index = code_match[type][code].code_index;
+  if (type == apf::Mesh::TRIANGLE)
+    return tri_template_elements[index];
+  return tet_template_elements[index];
+}
+
+/* predicted or current weights, also summing the weights of
+   this part and of the elements touching its part boundary */
+static Tag* getWeights(Adapt* a, bool predict,
+    double& total, double& boundary)
+{
+  Mesh* m = a->mesh;
+  Tag* weights = m->createDoubleTag("ma_weight",1);
+  total = boundary = 0;
+  Entity* e;
+  Iterator* it = m->begin(m->getDimension());
+  while ((e = m->iterate(it)))
+  {
+    double weight = predict ? getPredictedWeight(a,e)
+                            : getElementWeight(a,e);
+    m->setDoubleTag(e,weights,&weight);
+    total += weight;
+    Downward verts;
+    int nv = m->getDownward(e,0,verts);
+    for (int i=0; i < nv; ++i)
+      if (m->isShared(verts[i])) {
+        boundary += weight;
+        break;
+      }
+  }
+  m->end(it);
+  return weights;
+}
+
+static void destroyWeights(Mesh* m, Tag* weights)
+{
   removeTagFromDimension(m,weights,m->getDimension());
   m->destroyTag(weights);
 }
 
-void runZoltan(Adapt* a, int method=apf::GRAPH)
+static void runBalancer(Adapt* a, apf::Balancer* b, Tag* weights)
+{
+  b->balance(weights,a->input->maximumImbalance);
+  delete b;
+}
+
+static void runBalancer(Adapt* a, apf::Balancer* b)
+{
+  Tag* weights = getElementWeights(a);
+  runBalancer(a, b, weights);
+  destroyWeights(a->mesh, weights);
+}
+
+static apf::Balancer* makeZoltan(Adapt* a, int method=apf::GRAPH)
 {
-  runBalancer(a, apf::makeZoltanBalancer(
+  return apf::makeZoltanBalancer(
         a->mesh, method, apf::REPARTITION,
-        /* debug = */ false));
+        /* debug = */ false);
+}
+
+void runZoltan(Adapt* a, int method=apf::GRAPH)
+{
+  runBalancer(a, makeZoltan(a, method));
 }
 
 void runParma(Adapt* a)
@@ -113,6 +224,49 @@ void runParma(Adapt* a)
   runBalancer(a, Parma_MakeElmBalancer(a->mesh));
 }
 
+/* the largest fraction of the total weight that diffusion
+   is asked to migrate. parma moves elements one part
+   boundary at a time, so past this a global repartition
+   costs less than the diffusive steps */
+static double const maxDiffusiveMigration = 0.05;
+
+/* diffusion moves elements from part boundaries to their
+   neighbors, so it is chosen when every heavy part can shed
+   its excess out of the elements on its part boundary and
+   the weight to migrate is a small part of the total.
+   otherwise the parts are repartitioned globally.
+   the weights are predicted for the refinement that follows,
+   and are the usual size field weights elsewhere */
+static void runPredictive(Adapt* a, bool beforeRefine)
+{
+  double t0 = PCU_Time();
+  Mesh* m = a->mesh;
+  double local, boundary;
+  Tag* weights = getWeights(a, beforeRefine, local, boundary);
+  double total = PCU_Add_Double(local);
+  double average = total / PCU_Comm_Peers();
+  double imbalance = PCU_Max_Double(local) / average;
+  double excess = std::max(0.0, local - average);
+  double migration = PCU_Add_Double(excess);
+  bool canDiffuse = PCU_Min_Int(excess <= boundary) &&
+    migration <= maxDiffusiveMigration * total;
+  if (beforeRefine)
+    print("predicted %.0f elements after refinement, "
+          "imbalance %.0f%% of average, %.0f to migrate",
+          total, (imbalance - 1) * 100, migration);
+  if (imbalance > a->input->maximumImbalance) {
+    if (canDiffuse)
+      runBalancer(a, Parma_MakeElmBalancer(m), weights);
+    else
+      runBalancer(a, makeZoltan(a), weights);
+    double t1 = PCU_Time();
+    print("%s balanced %s weights in %f seconds",
+          canDiffuse ? "parma" : "zoltan",
+          beforeRefine ? "predicted" : "element", t1 - t0);
+  }
+  destroyWeights(m, weights);
+}
+
 void printEntityImbalance(Mesh* m)
 {
   double imbalance[4];
@@ -134,17 +288,31 @@ void preBalance(Adapt* a)
     runParma(a);
 }
 
-void midBalance(Adapt* a)
+static void midBalance(Adapt* a, bool beforeRefine)
 {
   if (PCU_Comm_Peers()==1)
     return;
   Input* in = a->input;
+  if (in->shouldRunMidPredictive) {
+    runPredictive(a, beforeRefine);
+    return;
+  }
   if (in->shouldRunMidZoltan)
     runZoltan(a);
   if (in->shouldRunMidParma)
     runParma(a);
 }
 
+void midBalance(Adapt* a)
+{
+  midBalance(a, false);
+}
+
+void refineBalance(Adapt* a)
+{
+  midBalance(a, true);
+}
+
 void postBalance(Adapt* a)
 {
   if (PCU_Comm_Peers()==1)
@@ -1,13 +1,20 @@
 #ifndef MA_BALANCE
 #define MA_BALANCE
 
+#include "maMesh.h"
+
 namespace ma {
 
 class Adapt;
 
 void preBalance(Adapt* a);
 void midBalance(Adapt* a);
+/* midBalance right before refine, where the predictive
+   balancer may weigh elements by what refine will make */
+void refineBalance(Adapt* a);
 void postBalance(Adapt* a);
+/* the number of elements e will become in the next refinement */
+double getPredictedWeight(Adapt* a, Entity* e);
 
 }
 
@@ -13,6 +13,7 @@
 #include "maShapeHandler.h"
 #include "maSnap.h"
 #include <cstdio>
+#include <cfloat>
 #include <pcu_util.h>
 
 namespace ma {
@@ -581,6 +582,7 @@ class SwapCavity
       mesh = a->mesh;
       loop.init(a);
       tempTet.init(a);
+      canScore = shape->isLinear();
     }
     bool setFromEdge(Entity* edge)
     {
@@ -636,10 +638,11 @@ class SwapCavity
         return false;
       return checkTet(true,tv) && checkTet(false,tv);
     }
-    void acceptTriangle(int unique_i, int local_i)
+    void acceptTriangle(int const* ti, int local_i)
     {
       Entity* tv[3];
-      getTriVerts(unique_i,tv);
+      for (int j=0; j < 3; ++j)
+        tv[j] = loop.getVert(ti[j]);
       Entity* tet = buildTopTet(tv);
       this->tets[2*local_i] = tet;
       tet = buildBottomTet(tv);
@@ -670,6 +673,94 @@ class SwapCavity
           return false;
       return true;
     }
+    void chooseTriangulation()
+    {
+      chosenCount = triangulation.getSize();
+      for (int i=0; i < chosenCount; ++i)
+        for (int j=0; j < 3; ++j)
+          chosen[i][j] = triangles[loop.getSize()][triangulation[i]][j];
+    }
+/* the rest of this class scores candidates without building
+   them, which is possible when quality is measured on straight
+   sided tets. the cavity vertices are numbered with the loop
+   first and then the bottom and top edge vertices, and each
+   gets its position and metric transform once. */
+    void prepareScoring()
+    {
+      SizeField* sf = adapter->sizeField;
+      int n = loop.getSize();
+      for (int i=0; i < n + 2; ++i)
+      {
+        Entity* v = (i < n) ? loop.getVert(i) : loop.getEdgeVert(i - n);
+        points[i] = getPosition(mesh,v);
+        apf::MeshElement* me = apf::createMeshElement(mesh,v);
+        sf->getTransform(me,Vector(0,0,0),transforms[i]);
+        apf::destroyMeshElement(me);
+        determinants[i] = apf::getJacobianDeterminant(transforms[i],3);
+      }
+    }
+/* the same measure as measureTetQuality: the metric of the
+   vertex with the largest determinant maps the whole tet */
+    double scoreTet(int const* tv)
+    {
+      int m = tv[0];
+      for (int i=1; i < 4; ++i)
+        if (determinants[tv[i]] > determinants[m])
+          m = tv[i];
+      Matrix qt = apf::transpose(transforms[m]);
+      Vector y[4];
+      for (int i=0; i < 4; ++i)
+        y[i] = qt * points[tv[i]];
+      return measureLinearTetQuality(y);
+    }
+    double scoreTriangle(int a, int b, int c)
+    {
+      int n = loop.getSize();
+      Entity* tv[3] = {loop.getVert(a),loop.getVert(b),loop.getVert(c)};
+      if (findElement(mesh, apf::Mesh::TRIANGLE, tv))
+        return -DBL_MAX;
+      int top[4] = {a,b,c,n+1};
+      int bottom[4] = {a,c,b,n};
+      return std::min(scoreTet(top),scoreTet(bottom));
+    }
+/* the triangulation of the loop whose worst tet is best,
+   by dynamic programming over the sub-polygons i..j */
+    double findBestTriangulation()
+    {
+      int n = loop.getSize();
+      for (int span=2; span < n; ++span)
+        for (int i=0; i + span < n; ++i)
+        {
+          int j = i + span;
+          best[i][j] = -DBL_MAX;
+          for (int k=i+1; k < j; ++k)
+          {
+            double q = scoreTriangle(i,k,j);
+            if (k - i > 1)
+              q = std::min(q,best[i][k]);
+            if (j - k > 1)
+              q = std::min(q,best[k][j]);
+            if (q > best[i][j])
+            {
+              best[i][j] = q;
+              choice[i][j] = k;
+            }
+          }
+        }
+      return best[0][n-1];
+    }
+    void collectTriangles(int i, int j)
+    {
+      if (j - i < 2)
+        return;
+      int k = choice[i][j];
+      chosen[chosenCount][0] = i;
+      chosen[chosenCount][1] = k;
+      chosen[chosenCount][2] = j;
+      ++chosenCount;
+      collectTriangles(i,k);
+      collectTriangles(k,j);
+    }
     bool findGoodTriangulation(double q, Upward& ot)
     {
       if (loop.getSize() < 3)
@@ -677,6 +768,15 @@ class SwapCavity
       if (loop.getSize() > MAX_VERTS)
         return false;
       qualityToBeat = std::max(q,adapter->input->validQuality);
+      if (canScore)
+      {
+        prepareScoring();
+        if ( ! (findBestTriangulation() > qualityToBeat))
+          return false;
+        chosenCount = 0;
+        collectTriangles(0,loop.getSize()-1);
+        return true;
+      }
       oldTets = &ot;
       int unique_count = unique_triangle_count[loop.getSize()];
       triangleOk.setSize(unique_count);
@@ -686,14 +786,17 @@ class SwapCavity
       triangulation.setSize(triangulation_size[loop.getSize()]);
       for (int i=0; i < triangulation_count[loop.getSize()]; ++i)
         if (tryTriangulation(i))
+        {
+          chooseTriangulation();
           return true;
+        }
       return false;
     }
     void acceptTriangulation()
     {
-      tets.setSize(2*(triangulation.getSize()));
-      for (size_t i=0; i < triangulation.getSize(); ++i)
-        acceptTriangle(triangulation[i],i);
+      tets.setSize(2*chosenCount);
+      for (int i=0; i < chosenCount; ++i)
+        acceptTriangle(chosen[i],i);
     }
     EntityArray& getNewTets() {return tets;}
   private:
@@ -708,6 +811,14 @@ class SwapCavity
     double qualityToBeat;
     Cavity tempTet;
     Upward* oldTets;
+    bool canScore;
+    Vector points[MAX_VERTS+2];
+    Matrix transforms[MAX_VERTS+2];
+    double determinants[MAX_VERTS+2];
+    double best[MAX_VERTS][MAX_VERTS];
+    int choice[MAX_VERTS][MAX_VERTS];
+    int chosen[MAX_VERTS-2][3];
+    int chosenCount;
 };
 
 class EdgeSwap3D : public EdgeSwap
@@ -59,6 +59,7 @@ void setDefaultValues(Input* in)
   in->shouldRunPreParma = false;
   in->shouldRunMidZoltan = false;
   in->shouldRunMidParma = false;
+  in->shouldRunMidPredictive = false;
   in->shouldRunPostZoltan = false;
   in->shouldRunPostZoltanRib = false;
   in->shouldRunPostParma = false;
@@ -67,6 +68,8 @@ void setDefaultValues(Input* in)
   in->shouldRefineLayer = false;
   in->shouldCoarsenLayer = false;
   in->splitAllLayerEdges = false;
+  in->shouldRefineUniformly = false;
+  in->shouldSmooth = false;
   in->userDefinedLayerTagName = "";
   in->shapeHandler = 0;
 }
@@ -202,6 +205,7 @@ Input* configureUniformRefine(Mesh* m, int n, SolutionTransfer* s)
   in->maximumIterations = n;
   in->shouldRefineLayer = true;
   in->splitAllLayerEdges = true;
+  in->shouldRefineUniformly = true;
   return in;
 }
 
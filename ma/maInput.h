@@ -84,6 +84,14 @@ class Input
     bool shouldRunMidZoltan;
 /** \brief whether to run parma during adaptation (default false)*/
     bool shouldRunMidParma;
+/** \brief whether to balance during adaptation by the number of elements
+   each element will become in the next refinement, using parma when
+   part boundary elements can carry the excess and the predicted
+   migration is under 5% of the total weight, and zoltan otherwise.
+   balancing that no refinement follows, as in shape correction, uses
+   the usual size field weights instead. this overrides the other
+   options for balancing during adaptation (default false) */
+    bool shouldRunMidPredictive;
 /** \brief whether to run zoltan after adapting (default false) */
     bool shouldRunPostZoltan;
 /** \brief whether to run zoltan RIB after adapting (default false) */
@@ -103,6 +111,22 @@ class Input
     bool shouldCoarsenLayer;
 /** \brief set to true during UR to get splits in the normal direction */
     bool splitAllLayerEdges;
+/** \brief whether refinement splits every edge in one bulk pass
+    without consulting the size field (default false)
+    \details set by ma::configureUniformRefine. Every edge is split
+    whatever the size field asks for, but new vertices still go
+    through the build callback and get interpolated sizes, so other
+    size fields may be used. Meshes with layers, matching or curved
+    coordinates take the general path instead */
+    bool shouldRefineUniformly;
+/** \brief whether to smooth the interior vertices before
+    shape correction (default false)
+    \details vertices classified on model regions are moved
+    along the gradient of the metric mean ratio of their tets,
+    never making their worst tet worse. Only linear tet
+    elements are smoothed, and fields are not transferred
+    to the new vertex positions */
+    bool shouldSmooth;
 /** \brief the name of the (user defined) INT tag specifying the boundary
     layer elements. Use the value of 0 for non-layer elements and a non-zero value
     for layer elements. (default "") */
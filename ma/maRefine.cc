@@ -19,7 +19,9 @@
 #include "maSnap.h"
 #include "maLayer.h"
 #include <apf.h>
+#include <apfShape.h>
 #include <pcu_util.h>
+#include <vector>
 
 namespace ma {
 
@@ -119,6 +121,7 @@ Refine::Refine(Adapt* a)
   adapt = a;
   Mesh* m = a->mesh;
   numberTag = m->createIntTag("ma_refine_number",1);
+  builder = 0;
 }
 
 Refine::~Refine()
@@ -159,6 +162,8 @@ Entity* buildSplitElement(
 {
   Adapt* a = r->adapt;
   Mesh* m = a->mesh;
+  if (r->builder)
+    return r->builder->build(m->toModel(parent),type,verts);
   return buildElement(a,m->toModel(parent),type,verts);
 }
 
@@ -314,11 +319,16 @@ void collectForTransfer(Refine* r)
 }
 
 void splitElements(Refine* r)
+{
+  splitElements(r,1);
+}
+
+void splitElements(Refine* r, int from)
 {
   Adapt* a = r->adapt;
   Mesh* m = a->mesh;
   NewEntities cb;
-  for (int d=1; d <= m->getDimension(); ++d)
+  for (int d=from; d <= m->getDimension(); ++d)
   {
     bool shouldCollect = r->shouldCollect[d];
     if (shouldCollect)
@@ -417,8 +427,167 @@ void cleanupAfter(Refine* r)
   forgetNewEntities(r);
 }
 
+static bool canRefineUniformly(Adapt* a)
+{
+  Mesh* m = a->mesh;
+  return a->input->shouldRefineUniformly &&
+         ( ! a->hasLayer) &&
+         ( ! a->input->shouldHandleMatching) &&
+         m->getShape()->getOrder() == 1;
+}
+
+/* every entity of dimension one and up is split, so the
+   arrays are filled straight from the iterators. the
+   entities are also counted by type, which gives the
+   number of new entities ahead of time */
+static long addAllEdges(Refine* r, std::size_t types[apf::Mesh::TYPES])
+{
+  Adapt* a = r->adapt;
+  Mesh* m = a->mesh;
+  long owned = 0;
+  for (int d=1; d <= m->getDimension(); ++d)
+  {
+    r->toSplit[d].setSize(m->count(d));
+    Iterator* it = m->begin(d);
+    Entity* e;
+    int n = 0;
+    while ((e = m->iterate(it)))
+    {
+      r->toSplit[d][n] = e;
+      m->setIntTag(e,r->numberTag,&n);
+      ++(types[m->getType(e)]);
+      if (d == 1)
+      {
+        setFlag(a,e,SPLIT);
+        if (m->isOwned(e))
+          ++owned;
+      }
+      ++n;
+    }
+    m->end(it);
+  }
+  return PCU_Add_Long(owned);
+}
+
+/* the simplex and quad templates make a known number of
+   entities; other types grow their storage as needed */
+static void reserveUniform(Mesh* m, std::size_t const types[apf::Mesh::TYPES])
+{
+  std::size_t edges = types[apf::Mesh::EDGE];
+  std::size_t tris = types[apf::Mesh::TRIANGLE];
+  std::size_t quads = types[apf::Mesh::QUAD];
+  std::size_t tets = types[apf::Mesh::TET];
+  std::size_t counts[apf::Mesh::TYPES] = {0};
+  counts[apf::Mesh::VERTEX] = edges + quads;
+  counts[apf::Mesh::EDGE] = 2 * edges + 3 * tris + 4 * quads + tets;
+  counts[apf::Mesh::TRIANGLE] = 4 * tris + 8 * tets;
+  counts[apf::Mesh::QUAD] = 4 * quads;
+  counts[apf::Mesh::TET] = 8 * tets;
+  m->reserve(counts);
+}
+
+/* the midpoint of a straight edge is the mean of its
+   vertices, so all of them are computed on threads before
+   the vertices are created, and the solution is transferred
+   to all of them in one call. otherwise each midpoint is
+   made like makeSplitVert makes it */
+static void splitAllEdges(Refine* r)
+{
+  Adapt* a = r->adapt;
+  Mesh* m = a->mesh;
+  EntityArray& edges = r->toSplit[1];
+  int n = edges.getSize();
+  std::vector<Vector> points(n);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (int i=0; i < n; ++i)
+  {
+    Entity* ev[2];
+    m->getDownward(edges[i],0,ev);
+    points[i] = (getPosition(m,ev[0]) + getPosition(m,ev[1])) / 2;
+  }
+  EntityArray midpoints(n);
+  r->newEntities[1].setSize(n);
+  SizeField* sf = a->sizeField;
+  Vector xi(0,0,0);
+  for (int i=0; i < n; ++i)
+  {
+    Entity* edge = edges[i];
+    Vector param(0,0,0);
+    if (a->input->shouldTransferParametric)
+      transferParametricOnEdgeSplit(m,edge,0.5,param);
+    if (a->input->shouldTransferToClosestPoint)
+      transferToClosestPointOnEdgeSplit(m,edge,0.5,param);
+    Entity* sv = buildVertex(a,m->toModel(edge),points[i],param);
+    apf::MeshElement* me = apf::createMeshElement(m,edge);
+    sf->interpolate(me,xi,sv);
+    apf::destroyMeshElement(me);
+    midpoints[i] = sv;
+    Entity* ev[2];
+    m->getDownward(edge,0,ev);
+    EntityArray& made = r->newEntities[1][i];
+    made.setSize(3);
+    made[0] = sv;
+    Entity* hv[2];
+    hv[0] = ev[0]; hv[1] = sv;
+    made[1] = buildSplitElement(r,edge,apf::Mesh::EDGE,hv);
+    hv[0] = sv; hv[1] = ev[1];
+    made[2] = buildSplitElement(r,edge,apf::Mesh::EDGE,hv);
+  }
+  a->solutionTransfer->onMidpoints(m,edges,midpoints);
+}
+
+/* splitElements changes the build callback between
+   dimensions, so the builder forwards to whichever is set */
+struct AdaptCallback : public apf::BuildCallback
+{
+  AdaptCallback(Adapt* a_):a(a_) {}
+  void call(Entity* e)
+  {
+    if (a->buildCallback)
+      a->buildCallback->call(e);
+  }
+  Adapt* a;
+};
+
+/* uniform refinement skips the size field and the marking
+   passes, creates the new entities through a bulk builder
+   with storage reserved up front, and links remote copies
+   once at the end like general refinement does */
+static bool refineUniformly(Adapt* a)
+{
+  double t0 = PCU_Time();
+  --(a->refinesLeft);
+  Mesh* m = a->mesh;
+  Refine* r = a->refine;
+  std::size_t types[apf::Mesh::TYPES] = {0};
+  long count = addAllEdges(r,types);
+  if ( ! count)
+    return false;
+  resetCollection(r);
+  collectForTransfer(r);
+  reserveUniform(m,types);
+  {
+    AdaptCallback cb(a);
+    apf::BulkBuilder builder(m,&cb);
+    r->builder = &builder;
+    splitAllEdges(r);
+    splitElements(r,2);
+    r->builder = 0;
+  }
+  processNewElements(r);
+  destroySplitElements(r);
+  forgetNewEntities(r);
+  double t1 = PCU_Time();
+  print("uniformly refined %li edges in %f seconds",count,t1-t0);
+  return true;
+}
+
 bool refine(Adapt* a)
 {
+  if (canRefineUniformly(a))
+    return refineUniformly(a);
   double t0 = PCU_Time();
   --(a->refinesLeft);
   setupLayerForSplit(a);
@@ -27,6 +27,9 @@ class Refine
     EntityArray toSplit[4];
     apf::DynamicArray<EntityArray> newEntities[4];
     bool shouldCollect[4];
+    /* when set, split elements are built through this
+       instead of searching for existing entities one by one */
+    apf::BulkBuilder* builder;
 };
 
 /** \name Methods for adding edges
@@ -60,6 +63,8 @@ void forgetNewEntities(Refine* r);
 void destroySplitElements(Refine* r);
 
 void splitElements(Refine* r);
+/** \brief split the entities of dimension from and up */
+void splitElements(Refine* r, int from);
 void processNewElements(Refine* r);
 void cleanupAfter(Refine* r);
 
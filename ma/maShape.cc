@@ -20,6 +20,7 @@
 #include "maFaceSplitCollapse.h"
 #include "maShortEdgeRemover.h"
 #include "maShapeHandler.h"
+#include "maSmooth.h"
 #include "maBalance.h"
 #include "maDBG.h"
 #include <pcu_util.h>
@@ -811,6 +812,7 @@ double improveQualities(Adapt* a)
 
 void fixElementShapes(Adapt* a)
 {
+  smooth(a);
   if ( ! a->input->shouldFixShape)
     return;
   double t0 = PCU_Time();
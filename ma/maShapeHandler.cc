@@ -28,6 +28,10 @@ class LinearHandler : public ShapeHandler
     {
       return measureElementQuality(mesh, sizeField, e);
     }
+    virtual bool isLinear()
+    {
+      return true;
+    }
     virtual bool hasNodesOn(int dimension)
     {
       return dimension == 0;
@@ -11,6 +11,10 @@ class ShapeHandler : public SolutionTransfer
 {
   public:
     virtual double getQuality(Entity* e) = 0;
+    /* true if getQuality measures straight-sided elements from
+       their vertex positions and the size field, so candidate
+       elements can be scored without building them */
+    virtual bool isLinear() {return false;}
 };
 
 ShapeHandler* getShapeHandler(Adapt* a);
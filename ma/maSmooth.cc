@@ -0,0 +1,623 @@
+#include "maSmooth.h"
+#include "maAdapt.h"
+#include "maShapeHandler.h"
+#include "maSize.h"
+#include <apf.h>
+#include <apfCSR.h>
+#include <PCU.h>
+#include <algorithm>
+#include <cfloat>
+#include <vector>
+
+namespace ma {
+
+/* the number of passes over all vertices, and the number of
+   step lengths tried for each vertex: a quarter of the distance
+   to its nearest neighbor, then an eighth, and so on */
+enum { SWEEPS = 4, STEPS = 4 };
+
+/* even permutations of a tet that put vertex i last */
+static int const tet_rotations[4][4] =
+{{1,3,2,0}
+,{0,2,3,1}
+,{0,3,1,2}
+,{0,1,2,3}};
+
+/* the same measure as measureLinearTetQuality, along with
+   its gradient with respect to y[3] when the tet is valid */
+static double measureTet(Vector const y[4], Vector& dq)
+{
+  Vector n = apf::cross(y[1] - y[0], y[2] - y[0]);
+  double V = (n * (y[3] - y[0])) / 6;
+  double s = 0;
+  for (int i = 0; i < 6; ++i) {
+    int const* ev = apf::tet_edge_verts[i];
+    Vector d = y[ev[1]] - y[ev[0]];
+    s += d * d;
+  }
+  double q = 15552*(V*V)/(s*s*s);
+  if (V <= 0)
+    return -q;
+  Vector ds = y[3] * 3 - y[0] - y[1] - y[2];
+  dq = (n * (1 / (3 * V)) - ds * (6 / s)) * q;
+  return q;
+}
+
+/* the sums over the local elements around a vertex,
+   added up over all copies of part boundary vertices.
+   f is the sum of inverse qualities that smoothing lowers,
+   h is the distance to the nearest neighbor */
+struct Sums
+{
+  double f;
+  double minq;
+  double h;
+  Vector g;
+};
+
+struct Steps
+{
+  Vector x[STEPS];
+};
+
+struct Trials
+{
+  double f[STEPS];
+  double minq[STEPS];
+};
+
+static void add(Sums& a, Sums const& b)
+{
+  a.f += b.f;
+  a.minq = std::min(a.minq, b.minq);
+  a.h = std::min(a.h, b.h);
+  a.g = a.g + b.g;
+}
+
+/* a step is taken only if it lowers the sum of inverse
+   qualities without making the worst element any worse */
+static bool accepts(Sums const& s, double f, double minq)
+{
+  return minq > 0 && minq >= s.minq && f < s.f;
+}
+
+static unsigned hashGlobal(long g)
+{
+  unsigned x = g;
+  x = ((x >> 16) ^ x) * 0x45d9f3b;
+  x = ((x >> 16) ^ x) * 0x45d9f3b;
+  return (x >> 16) ^ x;
+}
+
+static int firstFree(std::vector<int>& taken)
+{
+  std::sort(taken.begin(), taken.end());
+  int c = 0;
+  for (size_t i = 0; i < taken.size(); ++i)
+    if (taken[i] == c)
+      ++c;
+    else if (taken[i] > c)
+      break;
+  return c;
+}
+
+static void addToColor(std::vector<std::vector<int> >& colors,
+    int c, int i)
+{
+  if (c >= int(colors.size()))
+    colors.resize(c + 1);
+  colors[c].push_back(i);
+}
+
+/* works on the flat arrays of apf::exportMeshArrays.
+   vertices of one color share no element, so each color
+   is smoothed by threads in place. Vertices on part
+   boundaries are colored and moved in a separate stage
+   where their owners combine the gradients and trial
+   qualities of all copies. */
+class Smoother
+{
+  public:
+    Smoother(Adapt* a)
+    {
+      mesh = a->mesh;
+      apf::exportMeshArrays(mesh, arrays,
+          apf::EXPORT_COORDS | apf::EXPORT_VERT_VERT);
+      int nv = arrays.verts.size();
+      ids = mesh->createIntTag("ma_smooth_id", 1);
+      for (int i = 0; i < nv; ++i)
+        mesh->setIntTag(arrays.verts[i], ids, &i);
+      moved.assign(nv, 0);
+      slots.assign(nv, -1);
+      getVertElems();
+      getMetrics(a->sizeField);
+      findMovable();
+      colorInterior();
+      colorShared();
+    }
+    ~Smoother()
+    {
+      apf::removeTagFromDimension(mesh, ids, 0);
+      mesh->destroyTag(ids);
+    }
+    long run()
+    {
+      int sharedCount = PCU_Max_Int(sharedColors.size());
+      std::vector<int> none;
+      long total = 0;
+      for (int sweep = 0; sweep < SWEEPS; ++sweep) {
+        long count = 0;
+        for (size_t c = 0; c < interiorColors.size(); ++c)
+          count += smoothInterior(interiorColors[c]);
+        for (int c = 0; c < sharedCount; ++c)
+          count += smoothShared(
+              c < int(sharedColors.size()) ? sharedColors[c] : none);
+        count = PCU_Add_Long(count);
+        total += count;
+        if (!count)
+          break;
+      }
+      return total;
+    }
+/* copies the new coordinates into the mesh and drops the
+   cached qualities of the elements that changed shape */
+    void finish(Adapt* a)
+    {
+      for (size_t i = 0; i < arrays.verts.size(); ++i) {
+        if (!moved[i])
+          continue;
+        Entity* v = arrays.verts[i];
+        mesh->setPoint(v, 0, Vector(&arrays.coords[i * 3]));
+        for (int d = 2; d <= 3; ++d) {
+          apf::Adjacent adjacent;
+          mesh->getAdjacent(v, d, adjacent);
+          for (size_t j = 0; j < adjacent.getSize(); ++j)
+            if (mesh->hasTag(adjacent[j], a->qualityCache))
+              mesh->removeTag(adjacent[j], a->qualityCache);
+        }
+      }
+    }
+  private:
+    void getVertElems()
+    {
+      apf::CSR const& ev = arrays.elemVerts;
+      int nv = arrays.verts.size();
+      vertElems.offsets.assign(nv + 1, 0);
+      for (size_t i = 0; i < ev.items.size(); ++i)
+        ++vertElems.offsets[ev.items[i] + 1];
+      for (int i = 0; i < nv; ++i)
+        vertElems.offsets[i + 1] += vertElems.offsets[i];
+      vertElems.items.resize(ev.items.size());
+      std::vector<int> fill(vertElems.offsets.begin(),
+          vertElems.offsets.end() - 1);
+      for (int e = 0; e < ev.rows(); ++e)
+        for (int i = ev.offsets[e]; i < ev.offsets[e + 1]; ++i)
+          vertElems.items[fill[ev.items[i]]++] = e;
+    }
+/* the metric is frozen at the vertices for the whole pass,
+   and each element uses the one with the largest determinant
+   among its vertices, as measureTetQuality does */
+    void getMetrics(SizeField* sf)
+    {
+      int nv = arrays.verts.size();
+      metrics.resize(nv);
+      transposed.resize(nv);
+      std::vector<double> determinants(nv);
+      for (int i = 0; i < nv; ++i) {
+        apf::MeshElement* me =
+          apf::createMeshElement(mesh, arrays.verts[i]);
+        sf->getTransform(me, Vector(0,0,0), metrics[i]);
+        apf::destroyMeshElement(me);
+        transposed[i] = apf::transpose(metrics[i]);
+        determinants[i] = apf::getJacobianDeterminant(metrics[i], 3);
+      }
+      apf::CSR const& ev = arrays.elemVerts;
+      elemMetrics.resize(ev.rows());
+      for (int e = 0; e < ev.rows(); ++e) {
+        int best = ev.items[ev.offsets[e]];
+        for (int i = ev.offsets[e] + 1; i < ev.offsets[e + 1]; ++i)
+          if (determinants[ev.items[i]] > determinants[best])
+            best = ev.items[i];
+        elemMetrics[e] = best;
+      }
+    }
+/* vertices classified on model boundaries, touching
+   elements other than tets, or involved in ghosting stay
+   where they are. A part boundary vertex moves only if
+   it can move on all of its copies. */
+    void findMovable()
+    {
+      int nv = arrays.verts.size();
+      movable.assign(nv, 0);
+      shared.assign(nv, 0);
+      owners.assign(nv, PCU_Comm_Self());
+      ownerCopies.assign(nv, 0);
+      for (int i = 0; i < nv; ++i) {
+        Entity* v = arrays.verts[i];
+        movable[i] = mesh->getModelType(mesh->toModel(v)) == 3 &&
+                     !mesh->isGhost(v) && !mesh->isGhosted(v);
+        shared[i] = mesh->isShared(v);
+        if (shared[i] && i >= arrays.ownedVerts) {
+          owners[i] = mesh->getOwner(v);
+          apf::Copies remotes;
+          mesh->getRemotes(v, remotes);
+          ownerCopies[i] = remotes[owners[i]];
+        }
+      }
+      apf::CSR const& ev = arrays.elemVerts;
+      for (int e = 0; e < ev.rows(); ++e)
+        if (arrays.elemTypes[e] != apf::Mesh::TET)
+          for (int i = ev.offsets[e]; i < ev.offsets[e + 1]; ++i)
+            movable[ev.items[i]] = 0;
+      PCU_Comm_Begin();
+      for (int i = arrays.ownedVerts; i < nv; ++i)
+        if (shared[i])
+          packToOwner(i, movable[i]);
+      PCU_Comm_Send();
+      while (PCU_Comm_Receive()) {
+        int i = unpackVert();
+        char can;
+        PCU_COMM_UNPACK(can);
+        movable[i] = movable[i] && can;
+      }
+      PCU_Comm_Begin();
+      for (int i = 0; i < arrays.ownedVerts; ++i)
+        if (shared[i])
+          packToCopies(i, movable[i]);
+      PCU_Comm_Send();
+      while (PCU_Comm_Receive()) {
+        int i = unpackVert();
+        PCU_COMM_UNPACK(movable[i]);
+      }
+    }
+    void colorInterior()
+    {
+      int nv = arrays.verts.size();
+      std::vector<int> colors(nv, -1);
+      std::vector<int> taken;
+      apf::CSR const& vv = arrays.vertVerts;
+      for (int i = 0; i < nv; ++i) {
+        if (!movable[i] || shared[i])
+          continue;
+        taken.clear();
+        for (int j = vv.offsets[i]; j < vv.offsets[i + 1]; ++j)
+          if (colors[vv.items[j]] >= 0)
+            taken.push_back(colors[vv.items[j]]);
+        colors[i] = firstFree(taken);
+        addToColor(interiorColors, colors[i], i);
+      }
+    }
+    bool outranks(int i, int j)
+    {
+      long gi = arrays.vertGlobals[i];
+      long gj = arrays.vertGlobals[j];
+      unsigned hi = hashGlobal(gi);
+      unsigned hj = hashGlobal(gj);
+      if (hi != hj)
+        return hi > hj;
+      return gi > gj;
+    }
+/* true if no uncolored neighbor on this part outranks
+   vertex i, in which case the colors of the neighbors
+   are added to taken */
+    bool isReady(int i, std::vector<int> const& colors,
+        std::vector<int>& taken)
+    {
+      apf::CSR const& vv = arrays.vertVerts;
+      for (int j = vv.offsets[i]; j < vv.offsets[i + 1]; ++j) {
+        int k = vv.items[j];
+        if (!movable[k] || !shared[k])
+          continue;
+        if (colors[k] >= 0)
+          taken.push_back(colors[k]);
+        else if (outranks(k, i))
+          return false;
+      }
+      return true;
+    }
+/* a distributed greedy coloring that gives all copies of
+   a part boundary vertex the same color: once none of its
+   uncolored neighbors on any part outranks it, the owner
+   gives it the smallest color its neighbors do not have */
+    void colorShared()
+    {
+      int nv = arrays.verts.size();
+      std::vector<int> colors(nv, -1);
+      std::vector<int> todo;
+      for (int i = 0; i < nv; ++i)
+        if (movable[i] && shared[i])
+          todo.push_back(i);
+      while (PCU_Or(!todo.empty())) {
+        int n = todo.size();
+        std::vector<char> ready(n);
+        std::vector<std::vector<int> > taken(n);
+        for (int k = 0; k < n; ++k) {
+          slots[todo[k]] = k;
+          ready[k] = isReady(todo[k], colors, taken[k]);
+        }
+        PCU_Comm_Begin();
+        for (int k = 0; k < n; ++k) {
+          int i = todo[k];
+          if (i < arrays.ownedVerts)
+            continue;
+          packToOwner(i, ready[k]);
+          int count = taken[k].size();
+          PCU_COMM_PACK(owners[i], count);
+          if (count)
+            PCU_Comm_Pack(owners[i], &taken[k][0], count * sizeof(int));
+        }
+        PCU_Comm_Send();
+        while (PCU_Comm_Receive()) {
+          int k = slots[unpackVert()];
+          char r;
+          PCU_COMM_UNPACK(r);
+          ready[k] = ready[k] && r;
+          int count;
+          PCU_COMM_UNPACK(count);
+          for (int j = 0; j < count; ++j) {
+            int c;
+            PCU_COMM_UNPACK(c);
+            taken[k].push_back(c);
+          }
+        }
+        PCU_Comm_Begin();
+        for (int k = 0; k < n; ++k) {
+          int i = todo[k];
+          if (i >= arrays.ownedVerts || !ready[k])
+            continue;
+          colors[i] = firstFree(taken[k]);
+          packToCopies(i, colors[i]);
+        }
+        PCU_Comm_Send();
+        while (PCU_Comm_Receive()) {
+          int i = unpackVert();
+          PCU_COMM_UNPACK(colors[i]);
+        }
+        int left = 0;
+        for (int k = 0; k < n; ++k) {
+          int i = todo[k];
+          slots[i] = -1;
+          if (colors[i] < 0)
+            todo[left++] = i;
+          else
+            addToColor(sharedColors, colors[i], i);
+        }
+        todo.resize(left);
+      }
+    }
+    template <class T>
+    void packToOwner(int i, T const& data)
+    {
+      PCU_COMM_PACK(owners[i], ownerCopies[i]);
+      PCU_COMM_PACK(owners[i], data);
+    }
+    template <class T>
+    void packToCopies(int i, T const& data)
+    {
+      apf::FlatCopies copies;
+      mesh->getFlatRemotes(arrays.verts[i], copies);
+      for (size_t j = 0; j < copies.size(); ++j) {
+        PCU_COMM_PACK(copies[j].peer, copies[j].entity);
+        PCU_COMM_PACK(copies[j].peer, data);
+      }
+    }
+    int unpackVert()
+    {
+      Entity* v;
+      PCU_COMM_UNPACK(v);
+      int i;
+      mesh->getIntTag(v, ids, &i);
+      return i;
+    }
+    Vector getPoint(int i)
+    {
+      return Vector(&arrays.coords[i * 3]);
+    }
+    void move(int i, Vector const& x)
+    {
+      x.toArray(&arrays.coords[i * 3]);
+      moved[i] = 1;
+    }
+/* the sum of inverse qualities of the local elements around
+   vertex i when it is placed at x, and their worst quality.
+   The gradient of the sum is added to grad when given. */
+    double evaluate(int i, Vector const& x, double& minq, Vector* grad)
+    {
+      apf::CSR const& ev = arrays.elemVerts;
+      double f = 0;
+      minq = DBL_MAX;
+      for (int j = vertElems.offsets[i]; j < vertElems.offsets[i + 1]; ++j) {
+        int e = vertElems.items[j];
+        int const* tv = &ev.items[ev.offsets[e]];
+        int const* r = tet_rotations[std::find(tv, tv + 4, i) - tv];
+        Matrix const& qt = transposed[elemMetrics[e]];
+        Vector y[4];
+        for (int k = 0; k < 3; ++k)
+          y[k] = qt * getPoint(tv[r[k]]);
+        y[3] = qt * x;
+        Vector dq;
+        double q = measureTet(y, dq);
+        minq = std::min(minq, q);
+        if (q <= 0)
+          continue;
+        f += 1 / q;
+        if (grad)
+          *grad = *grad - (metrics[elemMetrics[e]] * dq) / (q * q);
+      }
+      return f;
+    }
+    void sum(int i, Sums& s)
+    {
+      Vector x = getPoint(i);
+      s.g = Vector(0,0,0);
+      s.f = evaluate(i, x, s.minq, &s.g);
+      s.h = DBL_MAX;
+      apf::CSR const& vv = arrays.vertVerts;
+      for (int j = vv.offsets[i]; j < vv.offsets[i + 1]; ++j)
+        s.h = std::min(s.h, (getPoint(vv.items[j]) - x).getLength());
+    }
+/* trial positions along the steepest descent direction,
+   or false if the vertex should stay */
+    bool getSteps(int i, Sums const& s, Steps& steps)
+    {
+      double l = s.g.getLength();
+      if (!(s.minq > 0) || !(l > 0))
+        return false;
+      Vector x = getPoint(i);
+      double t = s.h / 4;
+      for (int k = 0; k < STEPS; ++k) {
+        steps.x[k] = x - s.g * (t / l);
+        t /= 2;
+      }
+      return true;
+    }
+    bool smoothVertex(int i)
+    {
+      Sums s;
+      sum(i, s);
+      Steps steps;
+      if (!getSteps(i, s, steps))
+        return false;
+      for (int k = 0; k < STEPS; ++k) {
+        double minq;
+        double f = evaluate(i, steps.x[k], minq, 0);
+        if (accepts(s, f, minq)) {
+          move(i, steps.x[k]);
+          return true;
+        }
+      }
+      return false;
+    }
+    long smoothInterior(std::vector<int> const& verts)
+    {
+      int n = verts.size();
+      long count = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:count) schedule(dynamic, 64)
+#endif
+      for (int k = 0; k < n; ++k)
+        if (smoothVertex(verts[k]))
+          ++count;
+      return count;
+    }
+/* the owners add up the sums of all copies, send the same
+   trial positions to every copy, add up their trial results
+   and send back the first position that all copies accept */
+    long smoothShared(std::vector<int> const& verts)
+    {
+      int n = verts.size();
+      std::vector<Sums> sums(n);
+      for (int k = 0; k < n; ++k)
+        slots[verts[k]] = k;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (int k = 0; k < n; ++k)
+        sum(verts[k], sums[k]);
+      PCU_Comm_Begin();
+      for (int k = 0; k < n; ++k)
+        if (verts[k] >= arrays.ownedVerts)
+          packToOwner(verts[k], sums[k]);
+      PCU_Comm_Send();
+      while (PCU_Comm_Receive()) {
+        int k = slots[unpackVert()];
+        Sums s;
+        PCU_COMM_UNPACK(s);
+        add(sums[k], s);
+      }
+      std::vector<Steps> steps(n);
+      std::vector<char> active(n, 0);
+      PCU_Comm_Begin();
+      for (int k = 0; k < n; ++k) {
+        int i = verts[k];
+        if (i < arrays.ownedVerts && getSteps(i, sums[k], steps[k])) {
+          active[k] = 1;
+          packToCopies(i, steps[k]);
+        }
+      }
+      PCU_Comm_Send();
+      while (PCU_Comm_Receive()) {
+        int k = slots[unpackVert()];
+        PCU_COMM_UNPACK(steps[k]);
+        active[k] = 1;
+      }
+      std::vector<Trials> trials(n);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+      for (int k = 0; k < n; ++k)
+        if (active[k])
+          for (int j = 0; j < STEPS; ++j)
+            trials[k].f[j] = evaluate(verts[k], steps[k].x[j],
+                trials[k].minq[j], 0);
+      PCU_Comm_Begin();
+      for (int k = 0; k < n; ++k)
+        if (active[k] && verts[k] >= arrays.ownedVerts)
+          packToOwner(verts[k], trials[k]);
+      PCU_Comm_Send();
+      while (PCU_Comm_Receive()) {
+        int k = slots[unpackVert()];
+        Trials t;
+        PCU_COMM_UNPACK(t);
+        for (int j = 0; j < STEPS; ++j) {
+          trials[k].f[j] += t.f[j];
+          trials[k].minq[j] = std::min(trials[k].minq[j], t.minq[j]);
+        }
+      }
+      long count = 0;
+      PCU_Comm_Begin();
+      for (int k = 0; k < n; ++k) {
+        int i = verts[k];
+        if (i >= arrays.ownedVerts || !active[k])
+          continue;
+        for (int j = 0; j < STEPS; ++j)
+          if (accepts(sums[k], trials[k].f[j], trials[k].minq[j])) {
+            move(i, steps[k].x[j]);
+            packToCopies(i, steps[k].x[j]);
+            ++count;
+            break;
+          }
+      }
+      PCU_Comm_Send();
+      while (PCU_Comm_Receive()) {
+        int i = unpackVert();
+        Vector x;
+        PCU_COMM_UNPACK(x);
+        move(i, x);
+      }
+      for (int k = 0; k < n; ++k)
+        slots[verts[k]] = -1;
+      return count;
+    }
+    Mesh* mesh;
+    Tag* ids;
+    apf::MeshArrays arrays;
+    apf::CSR vertElems;
+    std::vector<Matrix> metrics;
+    std::vector<Matrix> transposed;
+    std::vector<int> elemMetrics;
+    std::vector<char> movable;
+    std::vector<char> shared;
+    std::vector<char> moved;
+    std::vector<int> owners;
+    std::vector<Entity*> ownerCopies;
+    std::vector<int> slots;
+    std::vector<std::vector<int> > interiorColors;
+    std::vector<std::vector<int> > sharedColors;
+};
+
+void smooth(Adapt* a)
+{
+  if ( ! a->input->shouldSmooth)
+    return;
+  if (a->mesh->getDimension() != 3 || ! a->shape->isLinear())
+    return;
+  double t0 = PCU_Time();
+  Smoother smoother(a);
+  long count = smoother.run();
+  smoother.finish(a);
+  double t1 = PCU_Time();
+  print("smoothed %li vertex positions in %f seconds", count, t1 - t0);
+}
+
+}
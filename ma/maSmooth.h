@@ -0,0 +1,15 @@
+#ifndef MA_SMOOTH_H
+#define MA_SMOOTH_H
+
+namespace ma {
+
+class Adapt;
+
+/* moves the interior vertices of a linear tet mesh to
+   improve the metric mean ratio of their elements.
+   runs only when ma::Input::shouldSmooth is set */
+void smooth(Adapt* a);
+
+}
+
+#endif
@@ -12,6 +12,7 @@
 #include <apfShape.h>
 #include <apfNumbering.h>
 #include <float.h>
+#include <vector>
 
 namespace ma {
 
@@ -26,6 +27,20 @@ void SolutionTransfer::onVertex(
 {
 }
 
+void SolutionTransfer::onMidpoints(
+    Mesh* m,
+    EntityArray& edges,
+    EntityArray& midpoints)
+{
+  Vector xi(0,0,0);
+  for (size_t i = 0; i < edges.getSize(); ++i)
+  {
+    apf::MeshElement* me = apf::createMeshElement(m,edges[i]);
+    onVertex(me,xi,midpoints[i]);
+    apf::destroyMeshElement(me);
+  }
+}
+
 void SolutionTransfer::onRefine(
     Entity*,
     EntityArray&)
@@ -89,6 +104,50 @@ class LinearTransfer : public FieldTransfer
       apf::setComponents(field,vert,0,&(value[0]));
       apf::destroyElement(e);
     }
+    /* the midpoint value is the same combination of the two
+       edge nodes for every edge, so the weights are computed
+       once and the values on threads. they are stored
+       afterwards because setting values is not thread-safe */
+    virtual void onMidpoints(
+        Mesh* m,
+        EntityArray& edges,
+        EntityArray& midpoints)
+    {
+      apf::EntityShape* es = shape->getEntityShape(apf::Mesh::EDGE);
+      if (es->countNodes() != 2)
+      {
+        SolutionTransfer::onMidpoints(m,edges,midpoints);
+        return;
+      }
+      int n = edges.getSize();
+      if ( ! n)
+        return;
+      apf::NewArray<double> w;
+      es->getValues(m, edges[0], Vector(0,0,0), w);
+      int nc = apf::countComponents(field);
+      std::vector<double> values(n * nc);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+        apf::NewArray<double> other(nc);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (int i = 0; i < n; ++i)
+        {
+          Entity* ev[2];
+          m->getDownward(edges[i],0,ev);
+          double* out = &values[i * nc];
+          apf::getComponents(field,ev[0],0,out);
+          apf::getComponents(field,ev[1],0,&(other[0]));
+          for (int j = 0; j < nc; ++j)
+            out[j] = w[0] * out[j] + w[1] * other[j];
+        }
+      }
+      for (int i = 0; i < n; ++i)
+        apf::setComponents(field,midpoints[i],0,&values[i * nc]);
+    }
 };
 
 class CavityTransfer : public FieldTransfer
@@ -148,6 +207,13 @@ class HighOrderTransfer : public SolutionTransfer
     {
       verts.onVertex(parent,xi,vert);
     }
+    virtual void onMidpoints(
+        Mesh* m,
+        EntityArray& edges,
+        EntityArray& midpoints)
+    {
+      verts.onMidpoints(m,edges,midpoints);
+    }
     virtual void onRefine(
         Entity* parent,
         EntityArray& newEntities)
@@ -208,6 +274,15 @@ void SolutionTransfers::onVertex(
     transfers[i]->onVertex(parent,xi,vert);
 }
 
+void SolutionTransfers::onMidpoints(
+    Mesh* m,
+    EntityArray& edges,
+    EntityArray& midpoints)
+{
+  for (size_t i = 0; i < transfers.size(); ++i)
+    transfers[i]->onMidpoints(m,edges,midpoints);
+}
+
 void SolutionTransfers::onRefine(
     Entity* parent,
     EntityArray& newEntities)
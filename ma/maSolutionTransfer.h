@@ -46,6 +46,17 @@ class SolutionTransfer
         apf::MeshElement* parent,
         Vector const& xi, 
         Entity* vert);
+    /** \brief perform solution transfer on many edge midpoints
+      \details used by uniform refinement, where every edge
+               is split at its midpoint at once. midpoints[i]
+               was created at the middle of edges[i].
+               The default calls onVertex for each vertex;
+               override this when the transfer can be done
+               in bulk. */
+    virtual void onMidpoints(
+        Mesh* m,
+        EntityArray& edges,
+        EntityArray& midpoints);
     /** \brief perform solution transfer on refined entities
       \details when there are nodes on entities other
                than vertices, it becomes necessary to transfer
@@ -94,6 +105,10 @@ class SolutionTransfers : public SolutionTransfer
         apf::MeshElement* parent,
         Vector const& xi, 
         Entity* vert);
+    virtual void onMidpoints(
+        Mesh* m,
+        EntityArray& edges,
+        EntityArray& midpoints);
     virtual void onRefine(
         Entity* parent,
         EntityArray& newEntities);
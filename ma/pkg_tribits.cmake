@@ -44,6 +44,7 @@ set(SOURCES
   maLayerSnap.cc
   maMap.cc
   maReposition.cc
+  maSmooth.cc
   maExtrude.cc
   maDBG.cc
   maStats.cc
@@ -0,0 +1,84 @@
+#include "maAdapt.h"
+#include "maBalance.h"
+#include "maRefine.h"
+#include "maSize.h"
+#include <ma.h>
+#include <apf.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <cstdlib>
+#include <set>
+
+/* the predictive balancer weighs each element by the number of
+   elements its refinement template makes. this checks that the
+   predicted weights add up to the element count after one
+   refinement of a triangle and a tet box, with a graded size
+   field so that most templates are used */
+
+class Graded : public ma::IsotropicFunction
+{
+  public:
+    Graded(int n):h(1.0 / n) {}
+    virtual double getValue(ma::Entity* v)
+    {
+      ma::Vector x = ma::getPosition(mesh, v);
+      return h * (0.4 + x[0] * x[1] + 0.5 * x[2]);
+    }
+    ma::Mesh* mesh;
+  private:
+    double h;
+};
+
+static void check(int n, int dim)
+{
+  apf::Mesh2* m = apf::makeMdsBoxOnParts(n, n, dim == 3 ? n : 0,
+      1, 1, 1, true);
+  Graded graded(n);
+  graded.mesh = m;
+  ma::Input* in = ma::configure(m, &graded);
+  in->shouldCoarsen = false;
+  in->maximumIterations = 1;
+  ma::validateInput(in);
+  ma::Adapt* a = new ma::Adapt(in);
+  double predicted = 0;
+  std::set<double> weights;
+  ma::Entity* e;
+  ma::Iterator* it = m->begin(dim);
+  while ((e = m->iterate(it))) {
+    double w = ma::getPredictedWeight(a, e);
+    predicted += w;
+    weights.insert(w);
+  }
+  m->end(it);
+  predicted = PCU_Add_Double(predicted);
+  long before = PCU_Add_Long(m->count(dim));
+  ma::refine(a);
+  long after = PCU_Add_Long(m->count(dim));
+  long kinds = PCU_Max_Int(weights.size());
+  if (!PCU_Comm_Self())
+    lion_oprint(1, "%dD: %ld elements, %.0f predicted, %ld made, "
+        "%ld template sizes\n", dim, before, predicted, after, kinds);
+  PCU_ALWAYS_ASSERT(after > before);
+  /* all four triangle templates and most tet ones show up */
+  PCU_ALWAYS_ASSERT(kinds >= (dim == 2 ? 4 : 6));
+  PCU_ALWAYS_ASSERT(predicted == after);
+  delete a;
+  delete in;
+  m->destroyNative();
+  apf::destroyMesh(m);
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  int n = argc > 1 ? atoi(argv[1]) : 6;
+  check(n, 2);
+  check(n, 3);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
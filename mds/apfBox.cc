@@ -2,6 +2,7 @@
 
 #include "apfMDS.h"
 #include <gmi_lookup.h>
+#include <PCU.h>
 #include <pcu_util.h>
 #include <lionPrint.h>
 #include <cstdlib>
@@ -173,6 +174,7 @@ gmi_model* BoxBuilder::buildModel()
         addModelUse(gb, ab, di);
       }
   }
+  gmi_base_build_closure(&gb->model);
   return &gb->model;
 }
 
@@ -335,4 +337,37 @@ Mesh2* makeMdsBox(
   return bb.m;
 }
 
+Mesh2* makeMdsBoxOnParts(
+    int nex, int ney, int nez,
+    double wx, double wy, double wz, bool is)
+{
+  Mesh2* m = makeMdsBox(nex, ney, nez, wx, wy, wz, is);
+  int dim = m->getDimension();
+  if (PCU_Comm_Self())
+    for (int d = dim; d >= 0; --d) {
+      std::vector<MeshEntity*> ents;
+      MeshEntity* e;
+      MeshIterator* it = m->begin(d);
+      while ((e = m->iterate(it)))
+        ents.push_back(e);
+      m->end(it);
+      for (size_t i = 0; i < ents.size(); ++i)
+        m->destroy(ents[i]);
+    }
+  m->acceptChanges();
+  Migration* plan = new Migration(m);
+  MeshEntity* e;
+  MeshIterator* it = m->begin(dim);
+  while ((e = m->iterate(it))) {
+    int to = getLinearCentroid(m, e).x() / wx * PCU_Comm_Peers();
+    if (to >= PCU_Comm_Peers())
+      to = PCU_Comm_Peers() - 1;
+    if (to)
+      plan->send(e, to);
+  }
+  m->end(it);
+  m->migrate(plan);
+  return m;
+}
+
 }
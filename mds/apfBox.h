@@ -73,6 +73,15 @@ struct BoxBuilder
 Mesh2* makeMdsBox(
     int nx, int ny, int nz, double wx, double wy, double wz, bool is);
 
+/** \brief create the box of makeMdsBox on part 0 and spread it
+           over all parts
+  \details collective. each part gets the elements whose centroids
+  lie in its slab of the box along x, so parts share boundaries
+  with their neighbours. meant for tests that need a small
+  distributed mesh without mesh files */
+Mesh2* makeMdsBoxOnParts(
+    int nx, int ny, int nz, double wx, double wy, double wz, bool is);
+
 }
 
 #endif
@@ -9,6 +9,7 @@
 *******************************************************************************/
 
 #include <PCU.h>
+#include <pcu_io.h>
 #include <lionPrint.h>
 #include "apfMDS.h"
 #include "mds_apf.h"
@@ -19,12 +20,15 @@
 #include <apfNumbering.h>
 #include <apfPartition.h>
 #include <apfFile.h>
+#include <algorithm>
 #include <cstring>
 #include <pcu_util.h>
 #include <cstdlib>
 #include <stdint.h>
 #include <limits>
 #include <deque>
+#include <map>
+#include <vector>
 
 extern "C" {
 
@@ -106,6 +110,14 @@ static mds_id fromEnt(MeshEntity* e)
   return (reinterpret_cast<char*>(e) - ((char*)1));
 }
 
+/* mds keeps copies sorted by part, like apf::Copies */
+static void flatten(mds_copies* c, FlatCopies& to)
+{
+  to.reserve(c->n);
+  for (int i = 0; i < c->n; ++i)
+    to.push_back(Copy(c->c[i].p, toEnt(c->c[i].e)));
+}
+
 static MeshIterator* makeIter()
 {
   mds_id* p = new mds_id;
@@ -399,6 +411,31 @@ class MeshMDS : public Mesh2
       for (size_t i = 0; i < p->ids.size(); ++i)
         residence.insert(p->ids[i]);
     }
+    void getFlatRemotes(MeshEntity* e, FlatCopies& remotes)
+    {
+      remotes.clear();
+      if (!isShared(e))
+        return;
+      mds_copies* c = mds_get_copies(&mesh->remotes, fromEnt(e));
+      PCU_ALWAYS_ASSERT(c != NULL);
+      flatten(c, remotes);
+    }
+    void getFlatGhosts(MeshEntity* e, FlatCopies& ghosts)
+    {
+      ghosts.clear();
+      mds_copies* c = mds_get_copies(&mesh->ghosts, fromEnt(e));
+      if (c)
+        flatten(c, ghosts);
+    }
+    void getFlatResidence(MeshEntity* e, FlatParts& residence)
+    {
+      void* vp = mds_get_part(mesh, fromEnt(e));
+      PME* p = static_cast<PME*>(vp);
+      residence.clear();
+      residence.reserve(p->ids.size());
+      for (size_t i = 0; i < p->ids.size(); ++i)
+        residence.push_back(p->ids[i]);
+    }
     MeshTag* createDoubleTag(const char* name, int size)
     {
       mds_tag* tag;
@@ -571,6 +608,9 @@ class MeshMDS : public Mesh2
     void acceptChanges()
     {
       updateOwners(this, pmodel);
+      mds_compact_net(&mesh->remotes, &mesh->mds);
+      mds_compact_net(&mesh->ghosts, &mesh->mds);
+      mds_compact_net(&mesh->matches, &mesh->mds);
     }
 
     void migrate(Migration* plan)
@@ -614,7 +654,7 @@ class MeshMDS : public Mesh2
       mds_id id = fromEnt(e);
       if (!remotes.size())
         return mds_set_copies(&mesh->remotes, &mesh->mds, id, NULL);
-      mds_copies* c = mds_make_copies(remotes.size());
+      mds_copies* c = mds_make_copies(&mesh->remotes, remotes.size());
       c->n = 0;
       APF_ITERATE(Copies, remotes, it) {
         c->c[c->n].p = it->first;
@@ -628,7 +668,7 @@ class MeshMDS : public Mesh2
       mds_copy c;
       c.e = fromEnt(r);
       c.p = p;
-      mds_add_copy(&mesh->remotes, &mesh->mds, fromEnt(e), c);
+      mds_set_copy(&mesh->remotes, &mesh->mds, fromEnt(e), c);
     }
 
 //seol
@@ -642,7 +682,7 @@ class MeshMDS : public Mesh2
       mds_copy c;
       c.e = fromEnt(r);
       c.p = p;
-      mds_add_copy(&mesh->ghosts, &mesh->mds, fromEnt(e), c);
+      mds_set_copy(&mesh->ghosts, &mesh->mds, fromEnt(e), c);
     }
 
     void setResidence(MeshEntity* e, Parts& residence)
@@ -671,6 +711,13 @@ class MeshMDS : public Mesh2
     {
       return toEnt(fromIter(it));
     }
+    void reserve(std::size_t const counts[TYPES])
+    {
+      mds_id cap[MDS_TYPES];
+      for (int t = 0; t < TYPES; ++t)
+        cap[apf2mds(t)] = mesh->mds.n[apf2mds(t)] + counts[t];
+      mds_apf_reserve(mesh, cap);
+    }
     MeshEntity* createVert_(ModelEntity* c)
     {
       return createEntity_(VERTEX,c,0);
@@ -1300,6 +1347,43 @@ void hackMdsAdjacency(Mesh2* in, MeshEntity* up, int i, MeshEntity* down)
   mds_hack_adjacent(&m->mesh->mds, fromEnt(up), i, fromEnt(down));
 }
 
+void getMdsMemory(Mesh2* in, MdsMemory& memory)
+{
+  mds_apf* m = static_cast<MeshMDS*>(in)->mesh;
+  memory.topology = mds_bytes(&m->mds);
+  memory.geometry = m->mds.cap[MDS_VERTEX] * (sizeof(*m->point) +
+      sizeof(*m->param));
+  for (int t = 0; t < MDS_TYPES; ++t)
+    memory.geometry += m->mds.cap[t] * (sizeof(*m->model[t]) +
+        sizeof(*m->parts[t]));
+  memory.tags = mds_tags_bytes(&m->tags, &m->mds);
+  memory.remotes = mds_net_bytes(&m->remotes, &m->mds);
+  memory.ghosts = mds_net_bytes(&m->ghosts, &m->mds);
+  memory.matches = mds_net_bytes(&m->matches, &m->mds);
+}
+
+void printMdsMemory(Mesh2* in)
+{
+  MdsMemory mem;
+  getMdsMemory(in, mem);
+  static char const* const names[6] =
+  {"topology","geometry","tags","remotes","ghosts","matches"};
+  double total[6] = {double(mem.topology), double(mem.geometry),
+    double(mem.tags), double(mem.remotes), double(mem.ghosts),
+    double(mem.matches)};
+  double max[6];
+  for (int i = 0; i < 6; ++i)
+    max[i] = total[i];
+  PCU_Add_Doubles(total, 6);
+  PCU_Max_Doubles(max, 6);
+  if (PCU_Comm_Self())
+    return;
+  lion_oprint(1,"MDS memory: subsystem, total MB, max MB per part\n");
+  for (int i = 0; i < 6; ++i)
+    lion_oprint(1,"  %-8s %12.3f %12.3f\n", names[i],
+        total[i] / (1024 * 1024), max[i] / (1024 * 1024));
+}
+
 Mesh2* loadMdsPart(gmi_model* model, const char* meshfile)
 {
   MeshMDS* m = new MeshMDS();
@@ -1317,6 +1401,733 @@ void writeMdsPart(Mesh2* in, const char* meshfile)
   m->mesh = mds_write_smb(m->mesh, meshfile, 1, m);
 }
 
+void writeMdsCheckpoint(Mesh2* in, const char* path)
+{
+  double t0 = PCU_Time();
+  MeshMDS* m = static_cast<MeshMDS*>(in);
+  int zip;
+  path = mds_path_codec(path, &zip);
+  char* data;
+  size_t size;
+  m->mesh = mds_write_smb_image(m->mesh, &data, &size, zip, m);
+  pcu_write_sections(path, data, size);
+  free(data);
+  if (!PCU_Comm_Self())
+    lion_oprint(1,"checkpoint %s written in %f seconds\n",
+        path, PCU_Time() - t0);
+}
+
+static Mesh2* loadMdsImage(gmi_model* model, char* data, size_t size,
+    int parts)
+{
+  MeshMDS* m = new MeshMDS();
+  m->init(apf::getLagrange(1));
+  m->mesh = mds_read_smb_image(model, data, size, parts, 0, m);
+  m->isMatched = PCU_Or(!mds_net_empty(&m->mesh->matches));
+  m->ownsModel = true;
+  initResidence(m, m->getDimension());
+  stitchMesh(m);
+  m->acceptChanges();
+  return m;
+}
+
+/* N-to-M restart. Rank r of M reads the contiguous range of
+   parts [r*N/M, (r+1)*N/M) when M < N, or shares one part with
+   the other ranks that divide it when M > N, and copies what it
+   read into one part of its own. A vertex is known across the
+   file by its copy on the lowest part, so copies merged onto
+   one rank become one vertex, and the remote links between
+   ranks are rebuilt with one rendezvous at the rank that holds
+   that lowest part. */
+
+enum { RESTART_PART, RESTART_INDEX, RESTART_SHARED, RESTART_ID_SIZE };
+
+typedef std::pair<int, int> RestartId;
+typedef std::map<RestartId, MeshEntity*> RestartVerts;
+typedef std::vector<std::pair<MeshTag*, MeshTag*> > TagPairs;
+
+struct Restart
+{
+  gmi_model* model;
+  int parts;
+  int peers;
+  int first;
+  int count;
+  int slice;
+  int slices;
+  Mesh2* mesh;
+  RestartVerts shared;
+};
+
+struct RestartPiece
+{
+  MeshMDS* mesh;
+  mds_links links;
+  MeshTag* ids;
+  TagPairs tags;
+  std::vector<MeshEntity*> made[MDS_TYPES];
+};
+
+/* a rank that reads the given part of the file */
+static int getRestartHome(Restart const& r, int part)
+{
+  return ((long)(part + 1) * r.peers - 1) / r.parts;
+}
+
+static long divideUp(long a, long b)
+{
+  return (a + b - 1) / b;
+}
+
+/* the ranks [first, end) that read a part of the file */
+static void getRestartReaders(Restart const& r, int part, int& first,
+    int& end)
+{
+  if (r.peers < r.parts) {
+    first = getRestartHome(r, part);
+    end = first + 1;
+  } else {
+    first = divideUp((long)part * r.peers, r.parts);
+    end = divideUp((long)(part + 1) * r.peers, r.parts);
+  }
+}
+
+static void getRestartRange(Restart& r)
+{
+  long self = PCU_Comm_Self();
+  r.first = self * r.parts / r.peers;
+  if (r.peers < r.parts) {
+    r.count = (self + 1) * r.parts / r.peers - r.first;
+    r.slice = 0;
+    r.slices = 1;
+  } else {
+    long lo = divideUp((long)r.first * r.peers, r.parts);
+    long hi = divideUp((long)(r.first + 1) * r.peers, r.parts);
+    r.count = 1;
+    r.slice = self - lo;
+    r.slices = hi - lo;
+  }
+}
+
+/* the stored links of a part only list its own vertices, in the
+   order its peers list theirs, so one reader of each part sends
+   them to all readers of each peer, which pair them up with
+   their own lists to find the remote copies */
+static void linkRestartPieces(Restart& r, std::vector<RestartPiece>& pieces)
+{
+  PCU_Comm_Begin();
+  for (int i = 0; i < r.count && !r.slice; ++i) {
+    mds_links& ln = pieces[i].links;
+    int part = r.first + i;
+    for (unsigned j = 0; j < ln.np; ++j) {
+      int first, end;
+      getRestartReaders(r, ln.p[j], first, end);
+      for (int to = first; to < end; ++to) {
+        PCU_COMM_PACK(to, ln.p[j]);
+        PCU_COMM_PACK(to, part);
+        PCU_COMM_PACK(to, ln.n[j]);
+        PCU_Comm_Pack(to, ln.l[j], ln.n[j] * sizeof(unsigned));
+      }
+    }
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    unsigned part;
+    mds_copy c;
+    unsigned n;
+    PCU_COMM_UNPACK(part);
+    PCU_COMM_UNPACK(c.p);
+    PCU_COMM_UNPACK(n);
+    unsigned* in = static_cast<unsigned*>(PCU_Comm_Extract(
+          n * sizeof(unsigned)));
+    RestartPiece& p = pieces[part - r.first];
+    mds_links& ln = p.links;
+    unsigned j = 0;
+    while (j < ln.np && ln.p[j] != (unsigned)c.p)
+      ++j;
+    PCU_ALWAYS_ASSERT(j < ln.np && ln.n[j] == n);
+    for (unsigned k = 0; k < n; ++k) {
+      c.e = mds_identify(MDS_VERTEX, in[k]);
+      mds_add_copy(&p.mesh->mesh->remotes, &p.mesh->mesh->mds,
+          mds_identify(MDS_VERTEX, ln.l[j][k]), c);
+    }
+  }
+  for (int i = 0; i < r.count; ++i)
+    mds_free_links(&pieces[i].links);
+}
+
+/* tags each vertex with its copy on the lowest part and whether
+   it has copies at all, since reordering drops the remote links */
+static void tagRestartIds(RestartPiece& p, int part)
+{
+  p.ids = p.mesh->createIntTag("apf_restart_id", RESTART_ID_SIZE);
+  MeshIterator* it = p.mesh->begin(0);
+  MeshEntity* v;
+  while ((v = p.mesh->iterate(it))) {
+    int id[RESTART_ID_SIZE];
+    id[RESTART_PART] = part;
+    id[RESTART_INDEX] = mds_index(fromEnt(v));
+    id[RESTART_SHARED] = 0;
+    mds_copies* c = mds_get_copies(&p.mesh->mesh->remotes, fromEnt(v));
+    if (c) {
+      id[RESTART_SHARED] = 1;
+      for (int i = 0; i < c->n; ++i)
+        if (c->c[i].p < id[RESTART_PART]) {
+          id[RESTART_PART] = c->c[i].p;
+          id[RESTART_INDEX] = mds_index(c->c[i].e);
+        }
+    }
+    p.mesh->setIntTag(v, p.ids, id);
+  }
+  p.mesh->end(it);
+}
+
+static MeshTag* cloneTag(Mesh* from, MeshTag* t, Mesh2* to)
+{
+  const char* name = from->getTagName(t);
+  MeshTag* out = to->findTag(name);
+  if (out)
+    return out;
+  int size = from->getTagSize(t);
+  switch (from->getTagType(t)) {
+    case Mesh::DOUBLE:
+      return to->createDoubleTag(name, size);
+    case Mesh::INT:
+      return to->createIntTag(name, size);
+    case Mesh::LONG:
+      return to->createLongTag(name, size);
+  }
+  return 0;
+}
+
+/* declares the shape, fields, numberings, and tags of a piece on
+   the output, where fields and numberings come first so that
+   their data is found in the tags that they create */
+static void cloneRestartData(RestartPiece& p, Mesh2* m)
+{
+  if (m->getShape() != p.mesh->getShape())
+    changeMeshShape(m, p.mesh->getShape(), false);
+  for (int i = 0; i < p.mesh->countFields(); ++i) {
+    Field* f = p.mesh->getField(i);
+    if (!m->findField(getName(f)))
+      cloneField(f, m);
+  }
+  for (int i = 0; i < p.mesh->countNumberings(); ++i) {
+    Numbering* n = p.mesh->getNumbering(i);
+    if (!m->findNumbering(getName(n)))
+      createNumbering(m, getName(n), getShape(n), countComponents(n));
+  }
+  DynamicArray<MeshTag*> tags;
+  p.mesh->getTags(tags);
+  for (int i = tags.getSize() - 1; i >= 0; --i)
+    if (tags[i] != p.ids)
+      p.tags.push_back(std::make_pair(tags[i], cloneTag(p.mesh, tags[i], m)));
+}
+
+static void copyRestartTags(RestartPiece& p, Mesh2* m, MeshEntity* from,
+    MeshEntity* to)
+{
+  for (size_t i = 0; i < p.tags.size(); ++i) {
+    MeshTag* in = p.tags[i].first;
+    MeshTag* out = p.tags[i].second;
+    if (!p.mesh->hasTag(from, in))
+      continue;
+    int size = p.mesh->getTagSize(in);
+    switch (p.mesh->getTagType(in)) {
+      case Mesh::DOUBLE: {
+        std::vector<double> d(size);
+        p.mesh->getDoubleTag(from, in, &d[0]);
+        m->setDoubleTag(to, out, &d[0]);
+        break;
+      }
+      case Mesh::INT: {
+        std::vector<int> d(size);
+        p.mesh->getIntTag(from, in, &d[0]);
+        m->setIntTag(to, out, &d[0]);
+        break;
+      }
+      case Mesh::LONG: {
+        std::vector<long> d(size);
+        p.mesh->getLongTag(from, in, &d[0]);
+        m->setLongTag(to, out, &d[0]);
+        break;
+      }
+    }
+  }
+}
+
+static MeshEntity* restoreVertex(Restart& r, RestartPiece& p, MeshEntity* v)
+{
+  int id[RESTART_ID_SIZE];
+  p.mesh->getIntTag(v, p.ids, id);
+  RestartId key(id[RESTART_PART], id[RESTART_INDEX]);
+  if (id[RESTART_SHARED]) {
+    RestartVerts::iterator it = r.shared.find(key);
+    if (it != r.shared.end())
+      return it->second;
+  }
+  Vector3 x;
+  Vector3 xi;
+  p.mesh->getPoint(v, 0, x);
+  p.mesh->getParam(v, xi);
+  MeshEntity* nv = r.mesh->createVertex(p.mesh->toModel(v), x, xi);
+  if (id[RESTART_SHARED])
+    r.shared[key] = nv;
+  return nv;
+}
+
+/* copies an entity and its closure. Only entities on the
+   boundary between two merged parts can already exist */
+static MeshEntity* restoreEntity(Restart& r, RestartPiece& p, MeshEntity* e)
+{
+  mds_id id = fromEnt(e);
+  MeshEntity*& made = p.made[mds_type(id)][mds_index(id)];
+  if (made)
+    return made;
+  int type = p.mesh->getType(e);
+  int dim = Mesh::typeDimension[type];
+  if (type == Mesh::VERTEX)
+    made = restoreVertex(r, p, e);
+  else {
+    Downward down;
+    int nd = p.mesh->getDownward(e, dim - 1, down);
+    for (int i = 0; i < nd; ++i)
+      down[i] = restoreEntity(r, p, down[i]);
+    if (r.count > 1 && dim < p.mesh->getDimension())
+      made = findUpward(r.mesh, type, down);
+    if (!made)
+      made = r.mesh->createEntity(type, p.mesh->toModel(e), down);
+  }
+  copyRestartTags(p, r.mesh, e, made);
+  return made;
+}
+
+/* keeps a contiguous range of elements after ordering them by a
+   breadth-first traversal, and marks the vertices of the others
+   as shared since they may bound another rank's slice */
+static void restoreSlice(Restart& r, RestartPiece& p)
+{
+  p.mesh->mesh = mds_reorder(p.mesh->mesh, 1,
+      mds_number_verts_bfs(p.mesh->mesh));
+  int dim = p.mesh->getDimension();
+  std::vector<MeshEntity*> elems;
+  elems.reserve(p.mesh->count(dim));
+  MeshIterator* it = p.mesh->begin(dim);
+  MeshEntity* e;
+  while ((e = p.mesh->iterate(it)))
+    elems.push_back(e);
+  p.mesh->end(it);
+  long n = elems.size();
+  long lo = n * r.slice / r.slices;
+  long hi = n * (r.slice + 1) / r.slices;
+  for (long i = 0; i < n; ++i) {
+    if (lo <= i && i < hi)
+      continue;
+    Downward dv;
+    int nv = p.mesh->getDownward(elems[i], 0, dv);
+    for (int j = 0; j < nv; ++j) {
+      int id[RESTART_ID_SIZE];
+      p.mesh->getIntTag(dv[j], p.ids, id);
+      id[RESTART_SHARED] = 1;
+      p.mesh->setIntTag(dv[j], p.ids, id);
+    }
+  }
+  for (long i = lo; i < hi; ++i)
+    restoreEntity(r, p, elems[i]);
+}
+
+static void restorePiece(Restart& r, RestartPiece& p)
+{
+  for (int t = 0; t < MDS_TYPES; ++t)
+    p.made[t].assign(p.mesh->mesh->mds.end[t], 0);
+  cloneRestartData(p, r.mesh);
+  if (r.slices > 1) {
+    restoreSlice(r, p);
+    return;
+  }
+  for (int d = 0; d <= p.mesh->getDimension(); ++d) {
+    MeshIterator* it = p.mesh->begin(d);
+    MeshEntity* e;
+    while ((e = p.mesh->iterate(it)))
+      restoreEntity(r, p, e);
+    p.mesh->end(it);
+  }
+}
+
+/* every rank that made a shared vertex tells the home rank of
+   its lowest-part copy, which answers each of them with all
+   the others */
+static void linkRestartVerts(Restart& r)
+{
+  PCU_Comm_Begin();
+  APF_ITERATE(RestartVerts, r.shared, it) {
+    int to = getRestartHome(r, it->first.first);
+    PCU_COMM_PACK(to, it->first.first);
+    PCU_COMM_PACK(to, it->first.second);
+    PCU_COMM_PACK(to, it->second);
+  }
+  PCU_Comm_Send();
+  typedef std::map<RestartId, std::vector<Copy> > Rendezvous;
+  Rendezvous copies;
+  while (PCU_Comm_Receive()) {
+    RestartId key;
+    MeshEntity* v;
+    PCU_COMM_UNPACK(key.first);
+    PCU_COMM_UNPACK(key.second);
+    PCU_COMM_UNPACK(v);
+    copies[key].push_back(Copy(PCU_Comm_Sender(), v));
+  }
+  PCU_Comm_Begin();
+  APF_ITERATE(Rendezvous, copies, it) {
+    std::vector<Copy> const& c = it->second;
+    int n = c.size() - 1;
+    if (!n)
+      continue;
+    for (size_t i = 0; i < c.size(); ++i) {
+      PCU_COMM_PACK(c[i].peer, c[i].entity);
+      PCU_COMM_PACK(c[i].peer, n);
+      for (size_t j = 0; j < c.size(); ++j)
+        if (j != i) {
+          PCU_COMM_PACK(c[i].peer, c[j].peer);
+          PCU_COMM_PACK(c[i].peer, c[j].entity);
+        }
+    }
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    MeshEntity* v;
+    int n;
+    PCU_COMM_UNPACK(v);
+    PCU_COMM_UNPACK(n);
+    for (int i = 0; i < n; ++i) {
+      int peer;
+      MeshEntity* e;
+      PCU_COMM_UNPACK(peer);
+      PCU_COMM_UNPACK(e);
+      r.mesh->addRemote(v, peer, e);
+    }
+  }
+}
+
+static Mesh2* restartMdsCheckpoint(gmi_model* model, const char* path,
+    int parts)
+{
+  Restart r;
+  r.model = model;
+  r.parts = parts;
+  r.peers = PCU_Comm_Peers();
+  getRestartRange(r);
+  std::vector<size_t> starts(r.count);
+  std::vector<size_t> sizes(r.count);
+  char* data = static_cast<char*>(pcu_read_sections(path, r.first,
+        r.count, &starts[0], &sizes[0]));
+  std::vector<RestartPiece> pieces(r.count);
+  for (int i = 0; i < r.count; ++i) {
+    RestartPiece& p = pieces[i];
+    p.mesh = new MeshMDS();
+    p.mesh->init(getLagrange(1));
+    mds_links ln = MDS_LINKS_INIT;
+    p.links = ln;
+    p.mesh->mesh = mds_read_smb_image(model, data + starts[i], sizes[i],
+        0, &p.links, p.mesh);
+  }
+  free(data);
+  linkRestartPieces(r, pieces);
+  r.mesh = makeEmptyMdsMesh(model, pieces[0].mesh->getDimension(), false);
+  for (int i = 0; i < r.count; ++i) {
+    RestartPiece& p = pieces[i];
+    tagRestartIds(p, r.first + i);
+    restorePiece(r, p);
+    p.mesh->destroyNative();
+    delete p.mesh;
+  }
+  linkRestartVerts(r);
+  stitchMesh(r.mesh);
+  r.mesh->acceptChanges();
+  return r.mesh;
+}
+
+/* Skilling's transposed Hilbert index of a point on a grid
+   of 2^21 cells per axis, interleaved into one key */
+static uint64_t getHilbertKey(uint32_t x[3])
+{
+  int const bits = 21;
+  uint32_t const top = 1u << (bits - 1);
+  for (uint32_t q = top; q > 1; q >>= 1) {
+    uint32_t p = q - 1;
+    for (int i = 0; i < 3; ++i)
+      if (x[i] & q)
+        x[0] ^= p;
+      else {
+        uint32_t t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+  }
+  for (int i = 1; i < 3; ++i)
+    x[i] ^= x[i - 1];
+  uint32_t t = 0;
+  for (uint32_t q = top; q > 1; q >>= 1)
+    if (x[2] & q)
+      t ^= q - 1;
+  for (int i = 0; i < 3; ++i)
+    x[i] ^= t;
+  uint64_t key = 0;
+  for (int b = bits - 1; b >= 0; --b)
+    for (int i = 0; i < 3; ++i)
+      key = (key << 1) | ((x[i] >> b) & 1);
+  return key;
+}
+
+/* tags each element with the piece of the part it goes to,
+   cutting the Hilbert curve through the element centroids
+   into pieces of equal element counts */
+static void splitAlongCurve(Mesh2* m, int factor, MeshTag* pieces)
+{
+  double const big = std::numeric_limits<double>::max();
+  Vector3 lo(big, big, big);
+  Vector3 hi(-big, -big, -big);
+  MeshEntity* e;
+  MeshIterator* it = m->begin(0);
+  while ((e = m->iterate(it))) {
+    Vector3 x;
+    m->getPoint(e, 0, x);
+    for (int i = 0; i < 3; ++i) {
+      lo[i] = std::min(lo[i], x[i]);
+      hi[i] = std::max(hi[i], x[i]);
+    }
+  }
+  m->end(it);
+  double const cells = (1 << 21) - 1;
+  int dim = m->getDimension();
+  std::vector<std::pair<uint64_t, MeshEntity*> > curve;
+  curve.reserve(m->count(dim));
+  it = m->begin(dim);
+  while ((e = m->iterate(it))) {
+    Vector3 c = getLinearCentroid(m, e);
+    uint32_t x[3];
+    for (int i = 0; i < 3; ++i)
+      if (hi[i] > lo[i])
+        x[i] = static_cast<uint32_t>((c[i] - lo[i]) / (hi[i] - lo[i]) * cells);
+      else
+        x[i] = 0;
+    curve.push_back(std::make_pair(getHilbertKey(x), e));
+  }
+  m->end(it);
+  std::sort(curve.begin(), curve.end());
+  size_t n = curve.size();
+  for (size_t i = 0; i < n; ++i) {
+    int piece = i * factor / n;
+    m->setIntTag(curve[i].second, pieces, &piece);
+  }
+}
+
+/* the sorted pieces that hold an entity */
+static void getPieces(Mesh2* m, MeshTag* pieces, MeshEntity* e,
+    std::vector<int>& to)
+{
+  to.clear();
+  int dim = m->getDimension();
+  int piece;
+  if (getDimension(m, e) == dim) {
+    m->getIntTag(e, pieces, &piece);
+    to.push_back(piece);
+    return;
+  }
+  Adjacent elements;
+  m->getAdjacent(e, dim, elements);
+  for (size_t i = 0; i < elements.getSize(); ++i) {
+    m->getIntTag(elements[i], pieces, &piece);
+    to.push_back(piece);
+  }
+  std::sort(to.begin(), to.end());
+  to.erase(std::unique(to.begin(), to.end()), to.end());
+}
+
+typedef std::map<MeshEntity*, std::vector<int> > SplitParts;
+
+/* one round gives each shared vertex the new parts of all its copies */
+static void getSplitParts(Mesh2* m, MeshTag* pieces, int factor,
+    SplitParts& shared)
+{
+  int first = PCU_Comm_Self() * factor;
+  std::vector<int> local;
+  PCU_Comm_Begin();
+  MeshEntity* v;
+  MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    if (!m->isShared(v))
+      continue;
+    getPieces(m, pieces, v, local);
+    std::vector<int>& parts = shared[v];
+    for (size_t i = 0; i < local.size(); ++i)
+      parts.push_back(first + local[i]);
+    int n = parts.size();
+    if (!n)
+      continue;
+    FlatCopies remotes;
+    m->getFlatRemotes(v, remotes);
+    for (size_t i = 0; i < remotes.size(); ++i) {
+      PCU_COMM_PACK(remotes[i].peer, remotes[i].entity);
+      PCU_COMM_PACK(remotes[i].peer, n);
+      PCU_Comm_Pack(remotes[i].peer, &parts[0], n * sizeof(int));
+    }
+  }
+  m->end(it);
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    PCU_COMM_UNPACK(v);
+    int n;
+    PCU_COMM_UNPACK(n);
+    std::vector<int>& parts = shared[v];
+    PCU_ALWAYS_ASSERT(n > 0);
+    size_t at = parts.size();
+    parts.resize(at + n);
+    PCU_Comm_Unpack(&parts[at], n * sizeof(int));
+  }
+  APF_ITERATE(SplitParts, shared, sit)
+    std::sort(sit->second.begin(), sit->second.end());
+}
+
+/* every copy of a vertex knows its owner copy, so sorting by
+   this key lists the vertices two new parts share in one order */
+typedef std::pair<int, long> SplitKey;
+
+static SplitKey getSplitKey(Mesh2* m, MeshEntity* v)
+{
+  int owner = m->getOwner(v);
+  MeshEntity* copy = v;
+  if (owner != PCU_Comm_Self()) {
+    FlatCopies remotes;
+    m->getFlatRemotes(v, remotes);
+    copy = findCopy(remotes, owner);
+  }
+  return SplitKey(owner, mds_index(fromEnt(copy)));
+}
+
+typedef std::vector<std::pair<SplitKey, unsigned> > SplitLinks;
+typedef std::map<int, SplitLinks> SplitPeers;
+
+static void writeSplitPiece(MeshMDS* m, MeshTag* pieces, MeshTag* copies,
+    SplitParts& shared, int factor, int piece, const char* meshfile)
+{
+  int first = PCU_Comm_Self() * factor;
+  int part = first + piece;
+  int dim = m->getDimension();
+  Mesh2* out = makeEmptyMdsMesh(m->getModel(), dim, false);
+  disownMdsModel(out);
+  SplitPeers links;
+  std::vector<int> in;
+  for (int d = 0; d <= dim; ++d) {
+    MeshEntity* e;
+    MeshIterator* it = m->begin(d);
+    while ((e = m->iterate(it))) {
+      getPieces(m, pieces, e, in);
+      if (!std::binary_search(in.begin(), in.end(), piece))
+        continue;
+      MeshEntity* copy;
+      if (d) {
+        Downward down;
+        int nd = m->getDownward(e, d - 1, down);
+        for (int i = 0; i < nd; ++i) {
+          long id;
+          m->getLongTag(down[i], copies, &id);
+          down[i] = toEnt(id);
+        }
+        copy = out->createEntity(m->getType(e), m->toModel(e), down);
+      } else {
+        Vector3 x;
+        Vector3 p(0,0,0);
+        m->getPoint(e, 0, x);
+        m->getParam(e, p);
+        copy = out->createVertex(m->toModel(e), x, p);
+        SplitKey key = getSplitKey(m, e);
+        unsigned index = mds_index(fromEnt(copy));
+        if (m->isShared(e))
+          in = shared[e];
+        else
+          for (size_t i = 0; i < in.size(); ++i)
+            in[i] += first;
+        for (size_t i = 0; i < in.size(); ++i)
+          if (in[i] != part)
+            links[in[i]].push_back(std::make_pair(key, index));
+      }
+      long id = fromEnt(copy);
+      m->setLongTag(e, copies, &id);
+    }
+    m->end(it);
+  }
+  mds_links ln = MDS_LINKS_INIT;
+  ln.np = links.size();
+  ln.p = static_cast<unsigned*>(malloc(ln.np * sizeof(unsigned)));
+  ln.n = static_cast<unsigned*>(malloc(ln.np * sizeof(unsigned)));
+  ln.l = static_cast<unsigned**>(malloc(ln.np * sizeof(unsigned*)));
+  unsigned i = 0;
+  APF_ITERATE(SplitPeers, links, lit) {
+    SplitLinks& l = lit->second;
+    std::sort(l.begin(), l.end());
+    ln.p[i] = lit->first;
+    ln.n[i] = l.size();
+    ln.l[i] = static_cast<unsigned*>(malloc(l.size() * sizeof(unsigned)));
+    for (size_t j = 0; j < l.size(); ++j)
+      ln.l[i][j] = l[j].second;
+    ++i;
+  }
+  MeshMDS* o = static_cast<MeshMDS*>(out);
+  mds_write_smb_part(o->mesh, meshfile, part, PCU_Comm_Peers() * factor,
+      &ln, o);
+  mds_free_links(&ln);
+  out->destroyNative();
+  destroyMesh(out);
+}
+
+void writeSplitMdsMesh(Mesh2* in, int factor, const char* meshfile)
+{
+  double t0 = PCU_Time();
+  MeshMDS* m = static_cast<MeshMDS*>(in);
+  PCU_ALWAYS_ASSERT(factor > 0);
+  PCU_ALWAYS_ASSERT(!m->hasMatching());
+  MeshTag* pieces = m->createIntTag("mds_split_piece", 1);
+  MeshTag* copies = m->createLongTag("mds_split_copy", 1);
+  splitAlongCurve(m, factor, pieces);
+  SplitParts shared;
+  getSplitParts(m, pieces, factor, shared);
+  for (int i = 0; i < factor; ++i)
+    writeSplitPiece(m, pieces, copies, shared, factor, i, meshfile);
+  for (int d = 0; d <= m->getDimension(); ++d) {
+    removeTagFromDimension(m, pieces, d);
+    removeTagFromDimension(m, copies, d);
+  }
+  m->destroyTag(pieces);
+  m->destroyTag(copies);
+  PCU_Barrier();
+  if (!PCU_Comm_Self())
+    lion_oprint(1,"mesh %s written as %d parts in %f seconds\n",
+        meshfile, PCU_Comm_Peers() * factor, PCU_Time() - t0);
+}
+
+Mesh2* loadMdsCheckpoint(gmi_model* model, const char* path)
+{
+  double t0 = PCU_Time();
+  int parts = pcu_count_sections(path);
+  int peers = PCU_Comm_Peers();
+  Mesh2* m;
+  if (parts == peers) {
+    size_t start;
+    size_t size;
+    char* data = static_cast<char*>(pcu_read_sections(path,
+          PCU_Comm_Self(), 1, &start, &size));
+    m = loadMdsImage(model, data + start, size, parts);
+    free(data);
+  } else
+    m = restartMdsCheckpoint(model, path, parts);
+  if (!PCU_Comm_Self())
+    lion_oprint(1,"checkpoint %s of %d parts loaded on %d ranks "
+        "in %f seconds\n", path, parts, peers, PCU_Time() - t0);
+  printStats(m);
+  return m;
+}
+
 
 }
 
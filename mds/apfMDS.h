@@ -31,6 +31,7 @@
   \brief Interface to the compact Mesh Data Structure */
 
 #include <map>
+#include <cstddef>
 
 struct gmi_model;
 
@@ -70,8 +71,11 @@ Mesh2* loadMdsMesh(const char* modelfile, const char* meshfile);
                   If the path is "something/", then the
                   file "something/N.smb" will be loaded.
                   For both of these cases, if the path is
-                  prepended with "bz2:", then it will be uncompressed
-                  using PCU file IO functions.
+                  prepended with "bz2:" or "zst:", then it will be
+                  uncompressed using PCU file IO functions, which
+                  need PCU_COMPRESS or PCU_ZSTD respectively.
+                  "bz2:" also reads the bzip2 streams of older
+                  versions.
                   Calling apf::Mesh::writeNative on the
                   resulting object will do the same in reverse. */
 Mesh2* loadMdsMesh(gmi_model* model, const char* meshfile);
@@ -219,6 +223,67 @@ void setMdsMatching(Mesh2* in, bool has);
 Mesh2* loadMdsPart(gmi_model* model, const char* meshfile);
 void writeMdsPart(Mesh2* m, const char* meshfile);
 
+/** \brief write the mesh and its fields as a single checkpoint file
+  \details each part serializes itself in the .smb format, then all
+  parts write their sections of one file collectively through MPI-IO,
+  with an index table at the start of the file.
+  Prefix the path with "bz2:" or "zst:" to compress each section
+  with bzip2 or zstd.
+  This is collective. */
+void writeMdsCheckpoint(Mesh2* m, const char* path);
+
+/** \brief load a checkpoint written by apf::writeMdsCheckpoint
+  \details the number of ranks need not match the number of parts
+  in the file. With fewer ranks, each rank reads a contiguous range
+  of parts and merges them. With more ranks, the ranks that share
+  a part each keep a contiguous slice of its elements in
+  breadth-first order. Either way the remote links are rebuilt
+  without migrating the mesh. Meshes with periodic matching
+  must be loaded on as many ranks as parts.
+  This is collective. */
+Mesh2* loadMdsCheckpoint(gmi_model* model, const char* path);
+
+/** \brief split every part and write the pieces as the files
+           of a partition with factor times as many parts
+  \details each part is cut into factor pieces of equal element
+  count along a Hilbert curve through its element centroids.
+  The pieces are built and written one at a time, so the parts
+  of the new partition are never all in memory and do not need
+  as many ranks. Piece i of part p becomes part p * factor + i,
+  which apf::loadMdsMesh reads on that many ranks.
+  Only the linear geometry, classification and partition links
+  are written; tags and fields are not, and periodic meshes are
+  not supported. This is collective. */
+void writeSplitMdsMesh(Mesh2* m, int factor, const char* meshfile);
+
+/** \brief bytes allocated by the parts of an MDS mesh
+  \details these count the arrays as allocated, including
+  room reserved for growth */
+struct MdsMemory
+{
+  /** \brief downward and upward adjacency arrays and free lists */
+  std::size_t topology;
+  /** \brief vertex coordinates and parameters,
+    classification and residence pointers */
+  std::size_t geometry;
+  /** \brief tag data and presence bits, which include field values */
+  std::size_t tags;
+  /** \brief remote copy lists */
+  std::size_t remotes;
+  /** \brief ghost copy lists */
+  std::size_t ghosts;
+  /** \brief matched copy lists */
+  std::size_t matches;
+};
+
+/** \brief get the memory use of the local MDS part */
+void getMdsMemory(Mesh2* in, MdsMemory& memory);
+
+/** \brief print the total and largest per-part
+  memory use of each MDS subsystem
+  \details this is collective */
+void printMdsMemory(Mesh2* in);
+
 }
 
 #endif
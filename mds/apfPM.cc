@@ -89,12 +89,32 @@ static void getAdjacentParts(apf::Mesh* m, PM& ps, apf::Parts& ids)
   ids.erase(m->getId());
 }
 
+/* ghost elements are left out so that ghosting
+   does not move the ownership of part boundary entities.
+   ghosts carry the tag Mesh::isGhost looks for, and a
+   mesh without it has none to leave out */
+static size_t countOwnElements(apf::Mesh* m)
+{
+  int d = m->getDimension();
+  size_t n = m->count(d);
+  apf::MeshTag* ghosts = m->findTag("ghost_tag");
+  if (!ghosts)
+    return n;
+  apf::MeshEntity* e;
+  apf::MeshIterator* it = m->begin(d);
+  while ((e = m->iterate(it)))
+    if (m->hasTag(e, ghosts))
+      --n;
+  m->end(it);
+  return n;
+}
+
 static void getCountMap(apf::Mesh* m, PM& ps, CountMap& mp)
 {
   apf::Parts peers;
   size_t n;
   getAdjacentParts(m, ps, peers);
-  n = m->count(m->getDimension());
+  n = countOwnElements(m);
   PCU_Comm_Begin();
   APF_ITERATE(apf::Parts, peers, it)
     PCU_COMM_PACK(*it, n);
@@ -289,6 +289,30 @@ void mds_destroy(struct mds* m)
   resize(m,old_cap);
 }
 
+/* bytes of the adjacency arrays and free lists,
+   following the sizes used by resize */
+size_t mds_bytes(struct mds* m)
+{
+  size_t n = 0;
+  int i,j,t;
+  for (t = 0; t < MDS_TYPES; ++t)
+    n += m->cap[t];
+  for (i = 0; i <= 3; ++i)
+  for (j = 0; j <= 3; ++j) {
+    if (!m->mrm[i][j])
+      continue;
+    for (t = 0; t < MDS_TYPES; ++t) {
+      if (i < j && mds_dim[t] == j)
+        n += ((size_t)m->cap[t]) * mds_degree[t][i];
+      else if (i < j && mds_dim[t] == i)
+        n += m->cap[t];
+      else if (i > j && mds_dim[t] == i)
+        n += ((size_t)m->cap[t]) * mds_degree[t][j];
+    }
+  }
+  return n * sizeof(mds_id);
+}
+
 #define ID(t,i) ((i)*MDS_TYPES + (t))
 #define TYPE(id) ((id) % MDS_TYPES)
 #define INDEX(id) ((id) / MDS_TYPES)
@@ -518,6 +542,22 @@ static void grow(struct mds* m, int t)
   resize(m,old_cap);
 }
 
+void mds_reserve(struct mds* m, mds_id cap[MDS_TYPES])
+{
+  int i;
+  int grown = 0;
+  mds_id old_cap[MDS_TYPES];
+  for (i = 0; i < MDS_TYPES; ++i) {
+    old_cap[i] = m->cap[i];
+    if (cap[i] > m->cap[i]) {
+      m->cap[i] = cap[i];
+      grown = 1;
+    }
+  }
+  if (grown)
+    resize(m,old_cap);
+}
+
 static mds_id fill_hole(struct mds* m, int t)
 {
   mds_id *head;
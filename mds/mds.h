@@ -12,6 +12,7 @@
 #define MDS_H
 
 #include "mds_config.h"
+#include <stddef.h>
 
 enum {
   MDS_VERTEX,
@@ -54,6 +55,8 @@ extern int const* mds_types[MDS_TYPES][4];
 
 void mds_create(struct mds* m, int d, mds_id cap[MDS_TYPES]);
 void mds_destroy(struct mds* m);
+/* raises the capacity of each type to at least cap[type] at once */
+void mds_reserve(struct mds* m, mds_id cap[MDS_TYPES]);
 mds_id mds_create_entity(struct mds* m, int type, mds_id *from);
 void mds_destroy_entity(struct mds* m, mds_id e);
 int mds_type(mds_id e);
@@ -71,5 +74,6 @@ int mds_has_up(struct mds* m, mds_id e);
 void mds_change_dimension(struct mds* m, int d);
 
 void mds_hack_adjacent(struct mds* m, mds_id up, int i, mds_id down);
+size_t mds_bytes(struct mds* m);
 
 #endif
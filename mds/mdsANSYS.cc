@@ -105,12 +105,14 @@ static Mesh2* parseElems(const char* elemfile, Nodes& nodes)
   apf::FieldShape* shape = 0;
   apf::FieldShape* prevShape = 0;
   apf::Numbering* enumbers = 0;
+  BulkBuilder* builder = 0;
   while (parseElem(f, en, type, id, shape)) {
     if (!m) {
       m = makeEmptyMdsMesh(gmi_load(".null"), Mesh::typeDimension[type], false);
       if (shape != m->getShape())
         changeMeshShape(m, shape, false);
       enumbers = createNumbering(m, "ansys_element", getConstant(m->getDimension()), 1);
+      builder = new BulkBuilder(m);
     }
     if (prevShape)
       PCU_ALWAYS_ASSERT(prevShape == shape);
@@ -132,7 +134,7 @@ static Mesh2* parseElems(const char* elemfile, Nodes& nodes)
       }
       ev[i] = verts[en[i]];
     }
-    MeshEntity* e = buildElement(m, 0, type, ev);
+    MeshEntity* e = builder->build(0, type, ev);
     for (int d = 1; d <= m->getDimension(); ++d) {
       if (!shape->hasNodesIn(d))
         continue;
@@ -148,6 +150,7 @@ static Mesh2* parseElems(const char* elemfile, Nodes& nodes)
     PCU_ALWAYS_ASSERT(i == nen);
     prevShape = shape;
   }
+  delete builder;
   return m;
 }
 
@@ -55,6 +55,7 @@ struct Reader {
   bool isQuadratic;
   std::map<long, Node> nodeMap;
   std::map<long, apf::MeshEntity*> entMap[4];
+  apf::BulkBuilder* builder;
 };
 
 void initReader(Reader* r, apf::Mesh2* m, const char* filename)
@@ -69,6 +70,7 @@ void initReader(Reader* r, apf::Mesh2* m, const char* filename)
   r->line[0] = '\0';
   r->linecap = 1;
   r->isQuadratic = false;
+  r->builder = 0;
 }
 
 void freeReader(Reader* r)
@@ -171,7 +173,7 @@ void readElement(Reader* r)
   if (dim != 0) {
     if (dim > r->mesh->getDimension())
       apf::changeMdsDimension(r->mesh, dim);
-    apf::MeshEntity* ent = apf::buildElement(r->mesh, g, apfType, verts);
+    apf::MeshEntity* ent = r->builder->build(g, apfType, verts);
     if (r->isQuadratic)
       r->entMap[dim][id] = ent;
   }
@@ -183,8 +185,11 @@ void readElements(Reader* r)
   seekMarker(r, "$Elements");
   long n = getLong(r);
   getLine(r);
+  apf::BulkBuilder builder(r->mesh);
+  r->builder = &builder;
   for (long i = 0; i < n; ++i)
     readElement(r);
+  r->builder = 0;
   checkMarker(r, "$EndElements");
 }
 
@@ -138,6 +138,9 @@ namespace {
     size_t cnt = h->nvtx*dim;
     double* xyz = (double*) calloc(cnt,sizeof(double));
     readDoubles(r->file, xyz, cnt, r->swapBytes);
+    std::size_t counts[apf::Mesh::TYPES] = {};
+    counts[apf::Mesh::VERTEX] = h->nvtx;
+    r->mesh->reserve(counts);
     for(long id=0; id<h->nvtx; id++) {
       apf::Vector3 p;
       for(unsigned j=0; j<dim; j++)
@@ -420,7 +423,8 @@ namespace {
     return ugrid_to_mds_verts[apfType-2][ugridIdx];
   }
 
-  void readElms(Reader* r, unsigned nelms, int apfType) {
+  void readElms(Reader* r, apf::BulkBuilder& b, unsigned nelms,
+      int apfType) {
     const unsigned nverts = apf::Mesh::adjacentCount[apfType][0];
     apf::ModelEntity* g = r->mesh->findModelEntity(3, 0);
     size_t cnt = nelms*nverts;
@@ -432,21 +436,28 @@ namespace {
         const unsigned mdsIdx = ugridToMdsElmIdx(apfType,j);
         verts[mdsIdx] = lookupVert(r, vtx[i*nverts+j]);
       }
-      apf::MeshEntity* elm =
-        apf::buildElement(r->mesh, g, apfType, verts);
+      apf::MeshEntity* elm = b.build(g, apfType, verts);
       PCU_ALWAYS_ASSERT(elm);
     }
     free(vtx);
   }
 
   void readElms(Reader* r, header* h) {
-    readElms(r,h->ntet,apf::Mesh::TET);
-    readElms(r,h->npyr,apf::Mesh::PYRAMID);
-    readElms(r,h->nprz,apf::Mesh::PRISM);
-    readElms(r,h->nhex,apf::Mesh::HEX);
-  }
-
-  void read2DElms(Reader* r, unsigned nelms, int apfType) {
+    std::size_t counts[apf::Mesh::TYPES] = {};
+    counts[apf::Mesh::TET] = h->ntet;
+    counts[apf::Mesh::PYRAMID] = h->npyr;
+    counts[apf::Mesh::PRISM] = h->nprz;
+    counts[apf::Mesh::HEX] = h->nhex;
+    r->mesh->reserve(counts);
+    apf::BulkBuilder b(r->mesh);
+    readElms(r,b,h->ntet,apf::Mesh::TET);
+    readElms(r,b,h->npyr,apf::Mesh::PYRAMID);
+    readElms(r,b,h->nprz,apf::Mesh::PRISM);
+    readElms(r,b,h->nhex,apf::Mesh::HEX);
+  }
+
+  void read2DElms(Reader* r, apf::BulkBuilder& b, unsigned nelms,
+      int apfType) {
     const unsigned nverts = apf::Mesh::adjacentCount[apfType][0];
     size_t cnt = nelms*nverts;
     unsigned* vtx = (unsigned*) calloc(cnt,sizeof(unsigned));
@@ -462,7 +473,7 @@ namespace {
         verts[mdsIdx] = lookupVert(r, vtx[i*nverts+j]);
       }
       apf::ModelEntity* g = r->mesh->findModelEntity(2, elm_model_id[i]);
-      apf::MeshEntity* elm = apf::buildElement(r->mesh, g, apfType, verts);
+      apf::MeshEntity* elm = b.build(g, apfType, verts);
       PCU_ALWAYS_ASSERT(elm);
 
       r->mesh->setModelEntity(elm, g);
@@ -472,8 +483,13 @@ namespace {
   }
 
   void read2DElms(Reader* r, header* h) {
-    read2DElms(r,h->ntri,apf::Mesh::TRIANGLE);
-    read2DElms(r,h->nquad,apf::Mesh::QUAD);
+    std::size_t counts[apf::Mesh::TYPES] = {};
+    counts[apf::Mesh::TRIANGLE] = h->ntri;
+    counts[apf::Mesh::QUAD] = h->nquad;
+    r->mesh->reserve(counts);
+    apf::BulkBuilder b(r->mesh);
+    read2DElms(r,b,h->ntri,apf::Mesh::TRIANGLE);
+    read2DElms(r,b,h->nquad,apf::Mesh::QUAD);
   }
 
   void freeReader(Reader* r) {
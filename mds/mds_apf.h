@@ -47,6 +47,9 @@ double* mds_apf_point(struct mds_apf* m, mds_id e);
 double* mds_apf_param(struct mds_apf* m, mds_id e);
 struct gmi_ent* mds_apf_model(struct mds_apf* m, mds_id e);
 void mds_apf_set_model(struct mds_apf* m, mds_id e, struct gmi_ent* model);
+/* room for at least cap[type] entities of each type, so that
+   bulk creation does not grow the arrays one step at a time */
+void mds_apf_reserve(struct mds_apf* m, mds_id cap[MDS_TYPES]);
 mds_id mds_apf_create_entity(
     struct mds_apf* m, int type, struct gmi_ent* model, mds_id* from);
 void mds_apf_destroy_entity(struct mds_apf* m, mds_id e);
@@ -62,10 +65,30 @@ struct gmi_ent* mds_find_model(struct mds_apf* m, int dim, int id);
 int mds_model_dim(struct mds_apf* m, struct gmi_ent* model);
 int mds_model_id(struct mds_apf* m, struct gmi_ent* model);
 
+/* a "bz2:" or "zst:" path prefix asks for bzip2 or zstd compression.
+   returns the path after any prefix, with the pcu codec it names */
+const char* mds_path_codec(const char* path, int* codec);
 struct mds_apf* mds_read_smb(struct gmi_model* model, const char* pathname,
     int ignore_peers, void* apf_mesh);
 struct mds_apf* mds_write_smb(struct mds_apf* m, const char* pathname,
     int ignore_peers, void* apf_mesh);
+/* writes the file of one part of a mesh of the given number of
+   parts without communication. links are the vertex links to
+   store, in the form mds_read_smb_image returns them, and the
+   mesh must have no gaps in its numbering */
+void mds_write_smb_part(struct mds_apf* m, const char* pathname,
+    int part, int parts, struct mds_links* links, void* apf_mesh);
+/* the same format in memory, used for single-file checkpoints.
+   parts is the partition count the image must have been written
+   with, or zero to accept any. zip is the pcu codec to compress with.
+   if remotes is not null, the image is read without communication
+   and its vertex links are returned there as stored: the local
+   indices shared with each peer part, in the order the peer
+   lists its own. periodic images can not be read this way. */
+struct mds_apf* mds_read_smb_image(struct gmi_model* model, void* data,
+    size_t size, int parts, struct mds_links* remotes, void* apf_mesh);
+struct mds_apf* mds_write_smb_image(struct mds_apf* m, char** data,
+    size_t* size, int zip, void* apf_mesh);
 
 void mds_verify(struct mds_apf* m);
 void mds_verify_residence(struct mds_apf* m, mds_id e);
@@ -14,6 +14,107 @@
 #include <stdlib.h>
 #include <pcu_util.h>
 
+/* blocks carved out of each slab */
+#define SLAB_BLOCKS 256
+
+struct mds_slab {
+  struct mds_slab* next;
+};
+
+static int pool_of(int n)
+{
+  int k = 0;
+  while ((1 << k) < n)
+    ++k;
+  return k;
+}
+
+/* bytes of a list with room for cap copies, padded
+   so that blocks in a slab stay pointer-aligned */
+static size_t block_bytes(int cap)
+{
+  size_t b = sizeof(struct mds_copies) + (cap - 1) * sizeof(struct mds_copy);
+  return (b + sizeof(void*) - 1) / sizeof(void*) * sizeof(void*);
+}
+
+static size_t list_bytes(int n)
+{
+  return sizeof(struct mds_copies) + (n - 1) * sizeof(struct mds_copy);
+}
+
+static void push_block(struct mds_pool* pool, void* b)
+{
+  memcpy(b, &pool->free, sizeof(void*));
+  pool->free = b;
+}
+
+static void* pop_block(struct mds_pool* pool)
+{
+  void* b = pool->free;
+  memcpy(&pool->free, b, sizeof(void*));
+  return b;
+}
+
+static void grow_pool(struct mds_pool* pool, int k)
+{
+  struct mds_slab* slab;
+  char* blocks;
+  size_t bytes;
+  int i;
+  bytes = block_bytes(1 << k);
+  slab = malloc(sizeof(*slab) + SLAB_BLOCKS * bytes);
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+  pool->capacity += SLAB_BLOCKS;
+  blocks = (char*)(slab + 1);
+  /* pushed backwards so that blocks are handed out in address order */
+  for (i = SLAB_BLOCKS - 1; i >= 0; --i)
+    push_block(pool, blocks + i * bytes);
+}
+
+static void free_slabs(struct mds_pool* pool)
+{
+  struct mds_slab* slab;
+  while (pool->slabs) {
+    slab = pool->slabs;
+    pool->slabs = slab->next;
+    free(slab);
+  }
+}
+
+static struct mds_copies* alloc_copies(struct mds_net* net, int n)
+{
+  struct mds_pool* pool;
+  int k;
+  k = pool_of(n);
+  if (k >= MDS_POOLS) {
+    net->large_bytes += block_bytes(1 << k);
+    return malloc(block_bytes(1 << k));
+  }
+  pool = &net->pools[k];
+  if (!pool->free)
+    grow_pool(pool, k);
+  ++pool->used;
+  return pop_block(pool);
+}
+
+static void free_copies(struct mds_net* net, struct mds_copies* c)
+{
+  struct mds_pool* pool;
+  int k;
+  if (!c)
+    return;
+  k = pool_of(c->n);
+  if (k >= MDS_POOLS) {
+    net->large_bytes -= block_bytes(1 << k);
+    free(c);
+    return;
+  }
+  pool = &net->pools[k];
+  --pool->used;
+  push_block(pool, c);
+}
+
 void mds_create_net(struct mds_net* net)
 {
   memset(net, 0, sizeof(*net));
@@ -22,19 +123,23 @@ void mds_create_net(struct mds_net* net)
 void mds_destroy_net(struct mds_net* net, struct mds* m)
 {
   int t;
+  int k;
   mds_id i;
   for (t = 0; t < MDS_TYPES; ++t) {
     if (net->data[t])
       for (i = 0; i < m->cap[t]; ++i)
-        free(net->data[t][i]);
+        if (net->data[t][i] && pool_of(net->data[t][i]->n) >= MDS_POOLS)
+          free(net->data[t][i]);
     free(net->data[t]);
   }
+  for (k = 0; k < MDS_POOLS; ++k)
+    free_slabs(&net->pools[k]);
 }
 
-struct mds_copies* mds_make_copies(int n)
+struct mds_copies* mds_make_copies(struct mds_net* net, int n)
 {
   struct mds_copies* c;
-  c = malloc(sizeof(struct mds_copies) + (n - 1) * sizeof(struct mds_copy));
+  c = alloc_copies(net, n);
   c->n = n;
   return c;
 }
@@ -59,7 +164,7 @@ void mds_set_copies(struct mds_net* net, struct mds* m, mds_id e,
     ++net->n[t];
   else if (*p && !c)
     --net->n[t];
-  free(*p);
+  free_copies(net, *p);
   *p = c;
   if (!net->n[t]) {
     free(net->data[t]);
@@ -104,28 +209,53 @@ void mds_add_copy(struct mds_net* net, struct mds* m, mds_id e,
     struct mds_copy c)
 {
   struct mds_copies* cs;
+  struct mds_copies* bigger;
   int t;
   int p;
+  int j;
   mds_id i;
   t = mds_type(e);
   i = mds_index(e);
   cs = mds_get_copies(net, e);
   if (cs) {
     p = find_place(cs, c.p);
-    cs = realloc(cs, sizeof(struct mds_copies) +
-        (cs->n) * sizeof(struct mds_copy));
+/* adding a copy that is already there changes nothing */
+    for (j = p - 1; j >= 0 && cs->c[j].p == c.p; --j)
+      if (cs->c[j].e == c.e)
+        return;
+    if (pool_of(cs->n + 1) != pool_of(cs->n)) {
+      bigger = alloc_copies(net, cs->n + 1);
+      memcpy(bigger, cs, list_bytes(cs->n));
+      free_copies(net, cs);
+      cs = bigger;
+    }
 /* insert sorted by moving greater items up by one */
     memmove(&cs->c[p + 1], &cs->c[p], (cs->n - p) * sizeof(struct mds_copy));
     cs->c[p] = c;
     ++cs->n;
     net->data[t][i] = cs;
   } else {
-    cs = mds_make_copies(1);
+    cs = mds_make_copies(net, 1);
     cs->c[0] = c;
     mds_set_copies(net, m, e, cs);
   }
 }
 
+void mds_set_copy(struct mds_net* net, struct mds* m, mds_id e,
+    struct mds_copy c)
+{
+  struct mds_copies* cs;
+  int i;
+  cs = mds_get_copies(net, e);
+  if (cs)
+    for (i = 0; i < cs->n; ++i)
+      if (cs->c[i].p == c.p) {
+        cs->c[i].e = c.e;
+        return;
+      }
+  mds_add_copy(net, m, e, c);
+}
+
 static int find_peer(struct mds_links* ln, unsigned p)
 {
   unsigned i;
@@ -289,6 +419,59 @@ int mds_net_empty(struct mds_net* net)
   return 1;
 }
 
+/* moves the pooled lists into fresh slabs in entity order,
+   releasing the slabs left sparse by migration. this is skipped
+   unless at least half of the pooled blocks, and at least one
+   slab worth of them, are free. */
+void mds_compact_net(struct mds_net* net, struct mds* m)
+{
+  struct mds_pool old[MDS_POOLS];
+  struct mds_copies* c;
+  struct mds_copies* moved;
+  size_t used = 0;
+  size_t capacity = 0;
+  int t;
+  int k;
+  mds_id i;
+  for (k = 0; k < MDS_POOLS; ++k) {
+    used += net->pools[k].used;
+    capacity += net->pools[k].capacity;
+  }
+  if (capacity - used < used || capacity - used < SLAB_BLOCKS)
+    return;
+  memcpy(old, net->pools, sizeof(old));
+  memset(net->pools, 0, sizeof(net->pools));
+  for (t = 0; t < MDS_TYPES; ++t) {
+    if (!net->data[t])
+      continue;
+    for (i = 0; i < m->end[t]; ++i) {
+      c = net->data[t][i];
+      if (!c || pool_of(c->n) >= MDS_POOLS)
+        continue;
+      moved = alloc_copies(net, c->n);
+      memcpy(moved, c, list_bytes(c->n));
+      net->data[t][i] = moved;
+    }
+  }
+  for (k = 0; k < MDS_POOLS; ++k)
+    free_slabs(&old[k]);
+}
+
+size_t mds_net_bytes(struct mds_net* net, struct mds* m)
+{
+  size_t bytes;
+  int t;
+  int k;
+  bytes = net->large_bytes;
+  for (t = 0; t < MDS_TYPES; ++t)
+    if (net->data[t])
+      bytes += m->cap[t] * sizeof(*(net->data[t]));
+  for (k = 0; k < MDS_POOLS; ++k)
+    bytes += (net->pools[k].capacity / SLAB_BLOCKS) *
+      (sizeof(struct mds_slab) + SLAB_BLOCKS * block_bytes(1 << k));
+  return bytes;
+}
+
 static void note_local_link(mds_id i, struct mds_copy c, void* u)
 {
   if (c.p == PCU_Comm_Self()) {
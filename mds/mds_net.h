@@ -12,6 +12,7 @@
 #define MDS_NET_H
 
 #include "mds.h"
+#include <stddef.h>
 
 struct mds_copy {
   mds_id e;
@@ -23,9 +24,26 @@ struct mds_copies {
   struct mds_copy c[1];
 };
 
+/* copy lists are carved out of slabs instead of being
+   allocated one by one. pool k holds the lists of more than
+   2^(k-1) and at most 2^k copies, so the capacity of a list
+   follows from its size. longer lists use plain malloc. */
+#define MDS_POOLS 6
+
+struct mds_slab;
+
+struct mds_pool {
+  struct mds_slab* slabs;
+  void* free;
+  size_t used;
+  size_t capacity;
+};
+
 struct mds_net {
   mds_id n[MDS_TYPES];
   struct mds_copies** data[MDS_TYPES];
+  struct mds_pool pools[MDS_POOLS];
+  size_t large_bytes;
 };
 
 struct mds_links {
@@ -38,7 +56,7 @@ struct mds_links {
 
 void mds_create_net(struct mds_net* net);
 void mds_destroy_net(struct mds_net* net, struct mds* m);
-struct mds_copies* mds_make_copies(int n);
+struct mds_copies* mds_make_copies(struct mds_net* net, int n);
 void mds_set_copies(struct mds_net* net, struct mds* m, mds_id e,
     struct mds_copies* c);
 struct mds_copies* mds_get_copies(struct mds_net* net, mds_id e);
@@ -49,6 +67,10 @@ void mds_grow_net(
 
 void mds_add_copy(struct mds_net* net, struct mds* m, mds_id e,
     struct mds_copy c);
+/* for nets with at most one copy per part, like remotes and ghosts:
+   the copy replaces any other copy on its part */
+void mds_set_copy(struct mds_net* net, struct mds* m, mds_id e,
+    struct mds_copy c);
 
 void mds_get_type_links(struct mds_net* net, struct mds* m,
     int t, struct mds_links* ln);
@@ -57,6 +79,8 @@ void mds_set_type_links(struct mds_net* net, struct mds* m,
 void mds_free_links(struct mds_links* ln);
 
 int mds_net_empty(struct mds_net* net);
+void mds_compact_net(struct mds_net* net, struct mds* m);
+size_t mds_net_bytes(struct mds_net* net, struct mds* m);
 
 void mds_get_local_matches(struct mds_net* net, struct mds* m,
                          int t, struct mds_links* ln);
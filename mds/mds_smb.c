@@ -116,8 +116,10 @@ static void write_links(struct pcu_file* f, struct mds_links* l)
     pcu_write_unsigneds(f, l->l[i], l->n[i]);
 }
 
+/* parts is the expected number of mesh partitions, or zero
+   if the partition count should not be checked */
 static void read_header(struct pcu_file* f, unsigned* version, unsigned* dim,
-    int ignore_peers)
+    int parts)
 {
   unsigned magic, np;
   PCU_READ_UNSIGNED(f, magic);
@@ -125,25 +127,19 @@ static void read_header(struct pcu_file* f, unsigned* version, unsigned* dim,
   PCU_ALWAYS_ASSERT(*version <= SMB_VERSION);
   PCU_READ_UNSIGNED(f, *dim);
   PCU_READ_UNSIGNED(f, np);
-  if (*version >= 1 && (!ignore_peers))
-  if (np != (unsigned)PCU_Comm_Peers())
+  if (*version >= 1 && parts)
+  if (np != (unsigned)parts)
     reel_fail("To whom it may concern\n"
         "the # of mesh partitions != the # of MPI ranks");
 }
 
-static void write_header(struct pcu_file* f, unsigned dim,
-    int ignore_peers)
+static void write_header(struct pcu_file* f, unsigned dim, unsigned np)
 {
   unsigned magic = 0;
   unsigned version = SMB_VERSION;
-  unsigned np;
   PCU_WRITE_UNSIGNED(f, magic);
   PCU_WRITE_UNSIGNED(f, version);
   PCU_WRITE_UNSIGNED(f, dim);
-  if (ignore_peers)
-    np = 1;
-  else
-    np = (unsigned)PCU_Comm_Peers();
   PCU_WRITE_UNSIGNED(f, np);
 }
 
@@ -210,10 +206,16 @@ static void write_conn(struct pcu_file* f, struct mds_apf* m)
   }
 }
 
+/* raw, if given, receives the vertex links as they are stored,
+   without the exchange that finds the copies on the peers */
 static void read_remotes(struct pcu_file* f, struct mds_apf* m,
-    int ignore_peers)
+    int ignore_peers, struct mds_links* raw)
 {
   struct mds_links ln = MDS_LINKS_INIT;
+  if (raw) {
+    read_links(f, raw);
+    return;
+  }
   read_links(f, &ln);
   if (!ignore_peers)
     mds_set_type_links(&m->remotes, &m->mds, MDS_VERTEX, &ln);
@@ -508,17 +510,20 @@ static void write_tags(struct pcu_file* f, struct mds_apf* m)
   free(sizes);
 }
 
-static void read_type_matches(struct pcu_file* f, struct mds_apf* m, int t,
+static int read_type_matches(struct pcu_file* f, struct mds_apf* m, int t,
     int ignore_peers)
 {
   struct mds_links ln = MDS_LINKS_INIT;
+  int found;
   read_links(f, &ln);
+  found = ln.np != 0;
   if (!ignore_peers)
     mds_set_local_matches(&m->matches, &m->mds, t, &ln);
   mds_free_local_links(&ln);
   if (!ignore_peers)
     mds_set_type_links(&m->matches, &m->mds, t, &ln);
   mds_free_links(&ln);
+  return found;
 }
 
 static void write_type_matches(struct pcu_file* f, struct mds_apf* m, int t,
@@ -533,20 +538,24 @@ static void write_type_matches(struct pcu_file* f, struct mds_apf* m, int t,
   mds_free_links(&ln);
 }
 
-static void read_matches_old(struct pcu_file* f, struct mds_apf* m,
+static int read_matches_old(struct pcu_file* f, struct mds_apf* m,
     int ignore_peers)
 {
   int t;
+  int found = 0;
   for (t = 0; t < MDS_HEXAHEDRON; ++t)
-    read_type_matches(f, m, t, ignore_peers);
+    found |= read_type_matches(f, m, t, ignore_peers);
+  return found;
 }
 
-static void read_matches_new(struct pcu_file* f, struct mds_apf* m,
+static int read_matches_new(struct pcu_file* f, struct mds_apf* m,
     int ignore_peers)
 {
   int t;
+  int found = 0;
   for (t = 0; t < SMB_TYPES; ++t)
-    read_type_matches(f, m, smb2mds(t), ignore_peers);
+    found |= read_type_matches(f, m, smb2mds(t), ignore_peers);
+  return found;
 }
 
 static void write_matches(struct pcu_file* f, struct mds_apf* m,
@@ -557,11 +566,11 @@ static void write_matches(struct pcu_file* f, struct mds_apf* m,
     write_type_matches(f, m, smb2mds(t), ignore_peers);
 }
 
-static struct mds_apf* read_smb(struct gmi_model* model, const char* filename,
-    int zip, int ignore_peers, void* apf_mesh)
+static struct mds_apf* read_smb_file(struct gmi_model* model,
+    struct pcu_file* f, int parts, int ignore_peers,
+    struct mds_links* raw, void* apf_mesh)
 {
   struct mds_apf* m;
-  struct pcu_file* f;
   unsigned version;
   unsigned dim;
   unsigned n[SMB_TYPES];
@@ -569,9 +578,8 @@ static struct mds_apf* read_smb(struct gmi_model* model, const char* filename,
   int i;
   unsigned tmp;
   unsigned pi, pj;
-  f = pcu_fopen(filename, 0, zip);
-  PCU_ALWAYS_ASSERT(f);
-  read_header(f, &version, &dim, ignore_peers);
+  int matched = 0;
+  read_header(f, &version, &dim, parts);
   pcu_read_unsigneds(f, n, SMB_TYPES);
   for (i = 0; i < MDS_TYPES; ++i) {
     tmp = n[mds2smb(i)];
@@ -590,15 +598,31 @@ static struct mds_apf* read_smb(struct gmi_model* model, const char* filename,
       for (pj = 0; pj < 2; ++pj) m->param[pi][pj] = 0.0;
     }
   }
-  read_remotes(f, m, ignore_peers);
+  read_remotes(f, m, ignore_peers, raw);
   read_class(f, m);
   read_tags(f, m);
+  if (raw)
+    ignore_peers = 1;
   if (version >= 4)
-    read_matches_new(f, m, ignore_peers);
+    matched = read_matches_new(f, m, ignore_peers);
   else if (version >= 3)
-    read_matches_old(f, m, ignore_peers);
+    matched = read_matches_old(f, m, ignore_peers);
+  if (raw && matched)
+    reel_fail("periodic checkpoints must be loaded on as many ranks as parts");
   if (version >= 5)
     mds_read_smb_meta(f, m, apf_mesh);
+  return m;
+}
+
+static struct mds_apf* read_smb(struct gmi_model* model, const char* filename,
+    int zip, int ignore_peers, void* apf_mesh)
+{
+  struct mds_apf* m;
+  struct pcu_file* f;
+  f = pcu_fopen(filename, 0, zip);
+  PCU_ALWAYS_ASSERT(f);
+  m = read_smb_file(model, f, ignore_peers ? 0 : PCU_Comm_Peers(),
+      ignore_peers, NULL, apf_mesh);
   pcu_fclose(f);
   return m;
 }
@@ -612,25 +636,43 @@ static void write_coords(struct pcu_file* f, struct mds_apf* m)
   pcu_write_doubles(f, &m->param[0][0], count);
 }
 
-static void write_smb(struct mds_apf* m, const char* filename,
-    int zip, int ignore_peers, void* apf_mesh)
+/* links, if given, are written as the vertex links
+   instead of those found from the remote copies */
+static void write_smb_part_file(struct mds_apf* m, struct pcu_file* f,
+    unsigned np, struct mds_links* links, int ignore_peers, void* apf_mesh)
 {
-  struct pcu_file* f;
   unsigned n[SMB_TYPES] = {0};
   int i;
-  f = pcu_fopen(filename, 1, zip);
-  PCU_ALWAYS_ASSERT(f);
-  write_header(f, m->mds.d, ignore_peers);
+  write_header(f, m->mds.d, np);
   for (i = 0; i < MDS_TYPES; ++i)
     n[mds2smb(i)] = m->mds.end[i];
   pcu_write_unsigneds(f, n, SMB_TYPES);
   write_conn(f, m);
   write_coords(f, m);
-  write_remotes(f, m, ignore_peers);
+  if (links)
+    write_links(f, links);
+  else
+    write_remotes(f, m, ignore_peers);
   write_class(f, m);
   write_tags(f, m);
   write_matches(f, m, ignore_peers);
   mds_write_smb_meta(f, apf_mesh);
+}
+
+static void write_smb_file(struct mds_apf* m, struct pcu_file* f,
+    int ignore_peers, void* apf_mesh)
+{
+  unsigned np = ignore_peers ? 1 : (unsigned)PCU_Comm_Peers();
+  write_smb_part_file(m, f, np, NULL, ignore_peers, apf_mesh);
+}
+
+static void write_smb(struct mds_apf* m, const char* filename,
+    int zip, int ignore_peers, void* apf_mesh)
+{
+  struct pcu_file* f;
+  f = pcu_fopen(filename, 1, zip);
+  PCU_ALWAYS_ASSERT(f);
+  write_smb_file(m, f, ignore_peers, apf_mesh);
   pcu_fclose(f);
 }
 
@@ -652,11 +694,20 @@ static int starts_with(const char* s, const char* w)
   return !strncmp(s, w, lw);
 }
 
-static void remove_prefix(char* s, const char* prefix)
+const char* mds_path_codec(const char* path, int* codec)
 {
-  int ls = strlen(s);
-  int lp = strlen(prefix);
-  memmove(s, s + lp, ls + 1 - lp);
+  static const char* bz2pre = "bz2:";
+  static const char* zstpre = "zst:";
+  if (starts_with(path, bz2pre)) {
+    *codec = PCU_CODEC_BZIP2;
+    return path + strlen(bz2pre);
+  }
+  if (starts_with(path, zstpre)) {
+    *codec = PCU_CODEC_ZSTD;
+    return path + strlen(zstpre);
+  }
+  *codec = PCU_NO_CODEC;
+  return path;
 }
 
 static void remove_ext(char* s, const char* ext)
@@ -686,38 +737,32 @@ static void safe_mkdir(const char* path, mode_t mode)
     reel_fail("MDS: could not create directory \"%s\"\n", path);
 }
 
-static char* handle_path(const char* in, int is_write, int* zip,
-    int ignore_peers)
+/* the file of part self out of peers. parts that write
+   without the others (sync = 0) each make the directories */
+static char* part_path(const char* in, int is_write, int* zip,
+    int self, int peers, int sync)
 {
-  static const char* zippre = "bz2:";
   static const char* smbext = ".smb";
   size_t bufsize;
   char* path;
   mode_t const dir_perm = S_IRWXU|S_IRGRP|S_IXGRP|S_IROTH|S_IXOTH;
-  int self = PCU_Comm_Self();
   bufsize = strlen(in) + 256;
   path = malloc(bufsize);
-  strcpy(path, in);
-  if (starts_with(path, zippre)) {
-    *zip = 1;
-    remove_prefix(path, zippre);
-  } else {
-    *zip = 0;
-  }
-  if (ignore_peers)
-    return path;
+  strcpy(path, mds_path_codec(in, zip));
   if (ends_with(path, "/")) {
     if (is_write) {
-      if (!self)
+      if (!self || !sync)
         safe_mkdir(path, dir_perm);
-      PCU_Barrier();
+      if (sync)
+        PCU_Barrier();
     }
-    if (PCU_Comm_Peers() > SMB_FANOUT) {
+    if (peers > SMB_FANOUT) {
       append(path, bufsize, "%d/", self / SMB_FANOUT);
       if (is_write) {
-        if (self % SMB_FANOUT == 0)
+        if (self % SMB_FANOUT == 0 || !sync)
           safe_mkdir(path, dir_perm);
-        PCU_Barrier();
+        if (sync)
+          PCU_Barrier();
       }
     }
   } else if (ends_with(path, smbext)) {
@@ -729,6 +774,19 @@ static char* handle_path(const char* in, int is_write, int* zip,
   return path;
 }
 
+static char* handle_path(const char* in, int is_write, int* zip,
+    int ignore_peers)
+{
+  char* path;
+  if (ignore_peers) {
+    in = mds_path_codec(in, zip);
+    path = malloc(strlen(in) + 1);
+    strcpy(path, in);
+    return path;
+  }
+  return part_path(in, is_write, zip, PCU_Comm_Self(), PCU_Comm_Peers(), 1);
+}
+
 struct mds_apf* mds_read_smb(struct gmi_model* model, const char* pathname,
     int ignore_peers, void* apf_mesh)
 {
@@ -750,12 +808,9 @@ static int is_compact(struct mds_apf* m)
   return 1;
 }
 
-struct mds_apf* mds_write_smb(struct mds_apf* m, const char* pathname,
-    int ignore_peers, void* apf_mesh)
+static struct mds_apf* make_compact(struct mds_apf* m, int ignore_peers)
 {
   const char* reorderWarning ="MDS: reordering before writing smb files\n";
-  char* filename;
-  int zip;
   if (ignore_peers && (!is_compact(m))) {
     if(!PCU_Comm_Self()) lion_eprint(1, "%s", reorderWarning);
     m = mds_reorder(m, 1, mds_number_verts_bfs(m));
@@ -764,9 +819,54 @@ struct mds_apf* mds_write_smb(struct mds_apf* m, const char* pathname,
     if(!PCU_Comm_Self()) lion_eprint(1, "%s", reorderWarning);
     m = mds_reorder(m, 0, mds_number_verts_bfs(m));
   }
+  return m;
+}
+
+struct mds_apf* mds_write_smb(struct mds_apf* m, const char* pathname,
+    int ignore_peers, void* apf_mesh)
+{
+  char* filename;
+  int zip;
+  m = make_compact(m, ignore_peers);
   filename = handle_path(pathname, 1, &zip, ignore_peers);
   write_smb(m, filename, zip, ignore_peers, apf_mesh);
   free(filename);
   return m;
 }
 
+void mds_write_smb_part(struct mds_apf* m, const char* pathname,
+    int part, int parts, struct mds_links* links, void* apf_mesh)
+{
+  char* filename;
+  int zip;
+  struct pcu_file* f;
+  PCU_ALWAYS_ASSERT(is_compact(m));
+  filename = part_path(pathname, 1, &zip, part, parts, 0);
+  f = pcu_fopen(filename, 1, zip);
+  PCU_ALWAYS_ASSERT(f);
+  write_smb_part_file(m, f, parts, links, 1, apf_mesh);
+  pcu_fclose(f);
+  free(filename);
+}
+
+struct mds_apf* mds_read_smb_image(struct gmi_model* model, void* data,
+    size_t size, int parts, struct mds_links* remotes, void* apf_mesh)
+{
+  struct mds_apf* m;
+  struct pcu_file* f;
+  f = pcu_mopen_read(data, size, pcu_is_block_compressed(data, size));
+  m = read_smb_file(model, f, parts, 0, remotes, apf_mesh);
+  pcu_fclose(f);
+  return m;
+}
+
+struct mds_apf* mds_write_smb_image(struct mds_apf* m, char** data,
+    size_t* size, int zip, void* apf_mesh)
+{
+  struct pcu_file* f;
+  m = make_compact(m, 0);
+  f = pcu_mopen_write(zip);
+  write_smb_file(m, f, 0, apf_mesh);
+  pcu_mclose_write(f, data, size);
+  return m;
+}
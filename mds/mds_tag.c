@@ -163,6 +163,20 @@ void mds_rename_tag(struct mds_tag* tag, const char* newName)
   strcpy(tag->name,newName);
 }
 
+/* presence is one bit per entity, data is only
+   allocated for types that have tagged entities */
+size_t mds_tags_bytes(struct mds_tags* ts, struct mds* m)
+{
+  struct mds_tag* tag;
+  size_t bytes = 0;
+  int t;
+  for (tag = ts->first; tag; tag = tag->next)
+    for (t = 0; t < MDS_TYPES; ++t)
+      if (tag->has[t])
+        bytes += (m->cap[t] / 8) + 1 + ((size_t)tag->bytes) * m->cap[t];
+  return bytes;
+}
+
 static struct mds_tag** find_prev(struct mds_tags* ts, struct mds_tag* t)
 {
   struct mds_tag* p;
@@ -12,6 +12,7 @@
 #define MDS_TAG_H
 
 #include "mds.h"
+#include <stddef.h>
 
 struct mds_tag {
   struct mds_tag* next;
@@ -44,6 +45,7 @@ int mds_has_tag(struct mds_tag* tag, mds_id e);
 void mds_give_tag(struct mds_tag* tag, struct mds* m, mds_id e);
 void mds_take_tag(struct mds_tag* tag, mds_id e);
 void mds_rename_tag(struct mds_tag* tag, const char* newName);
+size_t mds_tags_bytes(struct mds_tags* ts, struct mds* m);
 
 void mds_swap_tag_structs(struct mds_tags* as, struct mds_tag** a,
     struct mds_tags* bs, struct mds_tag** b);
@@ -1,6 +1,7 @@
 #include "apfOmega_h.h"
 
 #include <vector>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -16,105 +17,121 @@
 
 namespace apf {
 
+typedef std::vector<apf::MeshEntity*> Ents;
+
+static Ents ents_of_dim(apf::Mesh* am, int dim) {
+  Ents ents;
+  ents.reserve(am->count(dim));
+  auto it = am->begin(dim);
+  apf::MeshEntity* e;
+  while ((e = am->iterate(it)))
+    ents.push_back(e);
+  am->end(it);
+  return ents;
+}
+
 static void components_to_osh(
     apf::Field* f,
-    apf::MeshIterator* it,
+    Ents const& ents,
     osh::HostWrite<osh::Real> data) {
-  auto am = apf::getMesh(f);
   auto nc = apf::countComponents(f);
-  apf::MeshEntity* v;
-  int i = 0;
-  while ((v = am->iterate(it))) {
-    apf::getComponents(f, v, 0, data.data() + i * nc);
-    ++i;
-  }
+  for (size_t i = 0; i < ents.size(); ++i)
+    apf::getComponents(f, ents[i], 0, data.data() + i * nc);
 }
 
 static void components_from_osh(
     apf::Field* f,
-    apf::MeshIterator* it,
+    Ents const& ents,
     osh::HostRead<osh::Real> data) {
-  auto am = apf::getMesh(f);
   auto nc = apf::countComponents(f);
-  apf::MeshEntity* v;
-  int i = 0;
-  while ((v = am->iterate(it))) {
-    apf::setComponents(f, v, 0, data.data() + i * nc);
-    ++i;
-  }
+  for (size_t i = 0; i < ents.size(); ++i)
+    apf::setComponents(f, ents[i], 0, data.data() + i * nc);
 }
 
 static void vectors_to_osh(
     apf::Field* f,
-    apf::MeshIterator* it,
+    Ents const& ents,
     osh::HostWrite<osh::Real> data) {
-  auto am = apf::getMesh(f);
-  auto dim = am->getDimension();
-  apf::MeshEntity* v;
-  int i = 0;
-  while ((v = am->iterate(it))) {
+  auto dim = apf::getMesh(f)->getDimension();
+  for (size_t i = 0; i < ents.size(); ++i) {
     apf::Vector3 x;
-    apf::getVector(f, v, 0, x);
+    apf::getVector(f, ents[i], 0, x);
     for (int j = 0; j < dim; ++j) data[i * dim + j] = x[j];
-    ++i;
   }
 }
 
 static void vectors_from_osh(
     apf::Field* f,
-    apf::MeshIterator* it,
+    Ents const& ents,
     osh::HostRead<osh::Real> data) {
-  auto am = apf::getMesh(f);
-  auto dim = am->getDimension();
-  apf::MeshEntity* v;
-  int i = 0;
-  while ((v = am->iterate(it))) {
+  auto dim = apf::getMesh(f)->getDimension();
+  for (size_t i = 0; i < ents.size(); ++i) {
     apf::Vector3 x(0,0,0);
     for (int j = 0; j < dim; ++j) x[j] = data[i * dim + j];
-    apf::setVector(f, v, 0, x);
-    ++i;
+    apf::setVector(f, ents[i], 0, x);
   }
 }
 
 template <int dim>
 static void matrices_to_osh(
     apf::Field* f,
-    apf::MeshIterator* it,
+    Ents const& ents,
     osh::HostWrite<osh::Real> data) {
-  auto am = apf::getMesh(f);
-  apf::MeshEntity* v;
-  int i = 0;
-  while ((v = am->iterate(it))) {
+  for (size_t i = 0; i < ents.size(); ++i) {
     apf::Matrix3x3 x;
-    apf::getMatrix(f, v, 0, x);
+    apf::getMatrix(f, ents[i], 0, x);
     for (int j = 0; j < dim; ++j)
       for (int k = 0; k < dim; ++k)
         data[i * dim * dim + k * dim + j] = x[j][k];
-    ++i;
   }
 }
 
 template <int dim>
 static void matrices_from_osh(
     apf::Field* f,
-    apf::MeshIterator* it,
+    Ents const& ents,
     osh::HostRead<osh::Real> data) {
-  auto am = apf::getMesh(f);
-  apf::MeshEntity* v;
-  int i = 0;
-  while ((v = am->iterate(it))) {
+  for (size_t i = 0; i < ents.size(); ++i) {
     apf::Matrix3x3 x;
     for (int j = 0; j < dim; ++j)
       for (int k = 0; k < dim; ++k)
         x[j][k] = data[i * dim * dim + k * dim + j];
-    apf::setMatrix(f, v, 0, x);
-    ++i;
+    apf::setMatrix(f, ents[i], 0, x);
   }
 }
 
-static void field_to_osh(osh::Mesh* om, apf::Field* f) {
-  auto dim = om->dim();
+/* a frozen field with one node per entity keeps its values in
+   entity iteration order, which is exactly the Omega_h layout
+   whenever the component counts agree. Omega_h arrays own their
+   storage, so this is one contiguous copy of the apf array
+   instead of a virtual call per entity. */
+static bool frozen_to_osh(
+    apf::Field* f,
+    Ents const& ents,
+    int nc,
+    osh::HostWrite<osh::Real> data) {
+  if (!apf::isFrozen(f))
+    return false;
+  auto vt = apf::getValueType(f);
+  if (vt == apf::MATRIX || nc != apf::countComponents(f))
+    return false;
+  if (ents.empty())
+    return true;
   auto am = apf::getMesh(f);
+  auto shape = apf::getShape(f);
+  int ent_dim = apf::getDimension(am, ents.front());
+  for (int d = 0; d <= am->getDimension(); ++d)
+    if (shape->hasNodesIn(d) != (d == ent_dim))
+      return false;
+  if (shape->countNodesOn(apf::Mesh::simplexTypes[ent_dim]) != 1)
+    return false;
+  double const* array = apf::getArrayData(f);
+  std::copy(array, array + ents.size() * nc, data.data());
+  return true;
+}
+
+static void field_to_osh(osh::Mesh* om, apf::Field* f, Ents const* ents) {
+  auto dim = om->dim();
   std::string name = apf::getName(f);
   int ent_dim;
   if (apf::getShape(f) == apf::getLagrange(1)) {
@@ -140,35 +157,34 @@ static void field_to_osh(osh::Mesh* om, apf::Field* f) {
     nc = apf::countComponents(f);
   }
   auto data = osh::HostWrite<osh::Real>(om->nents(ent_dim) * nc);
-  auto it = am->begin(ent_dim);
-  if (vt == apf::VECTOR) {
-    vectors_to_osh(f, it, data);
-  } else if (vt == apf::MATRIX) {
-    if (dim == 2) matrices_to_osh<2>(f, it, data);
-    if (dim == 3) matrices_to_osh<3>(f, it, data);
-  } else components_to_osh(f, it, data);
-  am->end(it);
+  Ents const& fents = ents[ent_dim];
+  if (!frozen_to_osh(f, fents, nc, data)) {
+    if (vt == apf::VECTOR) {
+      vectors_to_osh(f, fents, data);
+    } else if (vt == apf::MATRIX) {
+      if (dim == 2) matrices_to_osh<2>(f, fents, data);
+      if (dim == 3) matrices_to_osh<3>(f, fents, data);
+    } else components_to_osh(f, fents, data);
+  }
   om->add_tag(ent_dim, name, nc, osh::Reals(data.write()));
 }
 
 static void field_from_osh(apf::Field* f, osh::Tag<osh::Real> const* tag,
-    int ent_dim) {
+    Ents const& ents) {
   auto am = apf::getMesh(f);
   auto dim = am->getDimension();
   auto data = osh::HostRead<osh::Real>(tag->array());
   auto value_type = apf::getValueType(f);
-  apf::MeshIterator* it = am->begin(ent_dim);
   if (value_type == apf::VECTOR) {
-    vectors_from_osh(f, it, data);
-  } if (value_type == apf::MATRIX) {
-    if (dim == 2) matrices_from_osh<2>(f, it, data);
-    if (dim == 3) matrices_from_osh<3>(f, it, data);
-  } else components_from_osh(f, it, data);
-  am->end(it);
+    vectors_from_osh(f, ents, data);
+  } else if (value_type == apf::MATRIX) {
+    if (dim == 2) matrices_from_osh<2>(f, ents, data);
+    if (dim == 3) matrices_from_osh<3>(f, ents, data);
+  } else components_from_osh(f, ents, data);
 }
 
 static void field_from_osh(apf::Mesh* am, osh::Tag<osh::Real> const* tag,
-    int ent_dim) {
+    Ents const& ents, int ent_dim) {
   auto dim = am->getDimension();
   auto nc = tag->ncomps();
   auto name = tag->name();
@@ -188,75 +204,70 @@ static void field_from_osh(apf::Mesh* am, osh::Tag<osh::Real> const* tag,
   }
   auto f = apf::createGeneralField(am, name.c_str(), value_type, nc,
       shape);
-  field_from_osh(f, tag, ent_dim);
+  field_from_osh(f, tag, ents);
 }
 
-static void fields_to_osh(osh::Mesh* om, apf::Mesh* am) {
+static void fields_to_osh(osh::Mesh* om, apf::Mesh* am, Ents const* ents) {
   for (int i = 0; i < am->countFields(); ++i)
-    field_to_osh(om, am->getField(i));
+    field_to_osh(om, am->getField(i), ents);
 }
 
-static void fields_from_osh(apf::Mesh* am, osh::Mesh* om, int ent_dim) {
+static void fields_from_osh(apf::Mesh* am, osh::Mesh* om,
+    Ents const& ents, int ent_dim) {
   for (int i = 0; i < om->ntags(ent_dim); ++i) {
     auto tagbase = om->get_tag(ent_dim, i);
     if (tagbase->type() == OMEGA_H_F64 &&
         tagbase->name() != "metric" &&
         tagbase->name() != "coordinates") {
-      field_from_osh(am, dynamic_cast<osh::Tag<osh::Real> const*>(tagbase), ent_dim);
+      field_from_osh(am, dynamic_cast<osh::Tag<osh::Real> const*>(tagbase),
+          ents, ent_dim);
     }
   }
 }
 
-static void fields_from_osh(apf::Mesh* am, osh::Mesh* om) {
-  fields_from_osh(am, om, 0);
-  fields_from_osh(am, om, am->getDimension());
-}
-
-static void coords_to_osh(osh::Mesh* om, apf::Mesh* am) {
-  field_to_osh(om, am->getCoordinateField());
+static void fields_from_osh(apf::Mesh* am, osh::Mesh* om, Ents const* ents) {
+  int dim = am->getDimension();
+  fields_from_osh(am, om, ents[0], 0);
+  fields_from_osh(am, om, ents[dim], dim);
 }
 
-static void coords_from_osh(apf::Mesh* am, osh::Mesh* om) {
-  field_from_osh(am->getCoordinateField(),
-      om->get_tag<osh::Real>(0, "coordinates"), 0);
+static void coords_to_osh(osh::Mesh* om, apf::Mesh* am, Ents const& verts) {
+  auto dim = om->dim();
+  osh::HostWrite<osh::Real> host_coords(osh::LO(verts.size()) * dim);
+  for (size_t i = 0; i < verts.size(); ++i) {
+    apf::Vector3 x;
+    am->getPoint(verts[i], 0, x);
+    for (int j = 0; j < dim; ++j) host_coords[i * dim + j] = x[j];
+  }
+  om->add_tag(0, "coordinates", dim, osh::Reals(host_coords.write()));
 }
 
-static void class_to_osh(osh::Mesh* mesh_osh, apf::Mesh* mesh_apf, int dim) {
-  auto nents = osh::LO(mesh_apf->count(dim));
+static void class_to_osh(osh::Mesh* mesh_osh, apf::Mesh* mesh_apf,
+    Ents const& ents, int dim) {
+  auto nents = osh::LO(ents.size());
   auto host_class_id = osh::HostWrite<osh::LO>(nents);
   auto host_class_dim = osh::HostWrite<osh::I8>(nents);
-  auto iter = mesh_apf->begin(dim);
-  apf::MeshEntity* e;
-  int i = 0;
-  while ((e = mesh_apf->iterate(iter))) {
-    auto me = mesh_apf->toModel(e);
+  for (osh::LO i = 0; i < nents; ++i) {
+    auto me = mesh_apf->toModel(ents[i]);
     host_class_dim[i] = osh::I8(mesh_apf->getModelType(me));
     host_class_id[i] = mesh_apf->getModelTag(me);
-    ++i;
   }
-  mesh_apf->end(iter);
   mesh_osh->add_tag(dim, "class_dim", 1, osh::Read<osh::I8>(host_class_dim.write()));
   mesh_osh->add_tag(dim, "class_id", 1, osh::LOs(host_class_id.write()));
 }
 
 static void conn_to_osh(osh::Mesh* mesh_osh, apf::Mesh* mesh_apf,
-    apf::Numbering* vert_nums, int d) {
-  auto nhigh = osh::LO(mesh_apf->count(d));
+    apf::MeshTag* vert_nums, Ents const& ents, int d) {
+  auto nhigh = osh::LO(ents.size());
   auto deg = d + 1;
   osh::HostWrite<osh::LO> host_ev2v(nhigh * deg);
-  auto iter = mesh_apf->begin(d);
-  apf::MeshEntity* he;
-  int i = 0;
-  while ((he = mesh_apf->iterate(iter))) {
+  for (osh::LO i = 0; i < nhigh; ++i) {
     apf::Downward eev;
-    auto deg2 = mesh_apf->getDownward(he, 0, eev);
+    auto deg2 = mesh_apf->getDownward(ents[i], 0, eev);
     OMEGA_H_CHECK(deg == deg2);
-    for (int j = 0; j < deg; ++j) {
-      host_ev2v[i * deg + j] = apf::getNumber(vert_nums, eev[j], 0, 0);
-    }
-    ++i;
+    for (int j = 0; j < deg; ++j)
+      mesh_apf->getIntTag(eev[j], vert_nums, &host_ev2v[i * deg + j]);
   }
-  mesh_apf->end(iter);
   auto ev2v = osh::LOs(host_ev2v.write());
   osh::Adj high2low;
   if (d == 1) {
@@ -270,28 +281,32 @@ static void conn_to_osh(osh::Mesh* mesh_osh, apf::Mesh* mesh_apf,
 }
 
 static void globals_to_osh(
-    osh::Mesh* mesh_osh, apf::Mesh* mesh_apf, int dim) {
+    osh::Mesh* mesh_osh, apf::Mesh* mesh_apf, Ents const& ents, int dim) {
   apf::GlobalNumbering* globals_apf = apf::makeGlobal(
       apf::numberOwnedDimension(mesh_apf, "smb2osh_global", dim));
   apf::synchronize(globals_apf);
-  auto nents = osh::LO(mesh_apf->count(dim));
+  auto nents = osh::LO(ents.size());
   osh::HostWrite<osh::GO> host_globals(nents);
-  auto iter = mesh_apf->begin(dim);
-  apf::MeshEntity* e;
-  int i = 0;
-  while ((e = mesh_apf->iterate(iter))) {
-    host_globals[i++] = apf::getNumber(globals_apf, apf::Node(e, 0));
-  }
-  mesh_apf->end(iter);
+  for (osh::LO i = 0; i < nents; ++i)
+    host_globals[i] = apf::getNumber(globals_apf, apf::Node(ents[i], 0));
   apf::destroyGlobalNumbering(globals_apf);
   auto globals = osh::Read<osh::GO>(host_globals.write());
-  mesh_osh->add_tag(dim, "global", 1,
-      osh::Read<osh::GO>(host_globals.write()));
+  mesh_osh->add_tag(dim, "global", 1, globals);
   auto owners = osh::owners_from_globals(
       mesh_osh->comm(), globals, osh::Read<osh::I32>());
   mesh_osh->set_owners(dim, owners);
 }
 
+/* local vertex ids live in a plain integer tag so the connectivity
+   pass is one tag lookup per vertex use instead of a Numbering
+   query through the field machinery */
+static apf::MeshTag* number_verts(apf::Mesh* am, Ents const& verts) {
+  apf::MeshTag* nums = am->createIntTag("apf2osh", 1);
+  for (int i = 0; i < int(verts.size()); ++i)
+    am->setIntTag(verts[i], nums, &i);
+  return nums;
+}
+
 void to_omega_h(osh::Mesh* om, apf::Mesh* am) {
   auto comm_mpi = PCU_Get_Comm();
   decltype(comm_mpi) comm_impl;
@@ -301,51 +316,56 @@ void to_omega_h(osh::Mesh* om, apf::Mesh* am) {
   om->set_parting(OMEGA_H_ELEM_BASED);
   auto dim = am->getDimension();
   OMEGA_H_CHECK(dim == 2 || dim == 3);
+  Ents ents[4];
+  for (int d = 0; d <= dim; ++d)
+    ents[d] = ents_of_dim(am, d);
   om->set_dim(am->getDimension());
-  om->set_verts(osh::LO(am->count(0)));
-  coords_to_osh(om, am);
-  class_to_osh(om, am, 0);
-  globals_to_osh(om, am, 0);
-  auto vert_nums = apf::numberOverlapDimension(am, "apf2osh", 0);
+  om->set_verts(osh::LO(ents[0].size()));
+  coords_to_osh(om, am, ents[0]);
+  class_to_osh(om, am, ents[0], 0);
+  globals_to_osh(om, am, ents[0], 0);
+  auto vert_nums = number_verts(am, ents[0]);
   for (int d = 1; d <= dim; ++d) {
-    conn_to_osh(om, am, vert_nums, d);
-    class_to_osh(om, am, d);
-    globals_to_osh(om, am, d);
+    conn_to_osh(om, am, vert_nums, ents[d], d);
+    class_to_osh(om, am, ents[d], d);
+    globals_to_osh(om, am, ents[d], d);
   }
-  apf::destroyNumbering(vert_nums);
-  fields_to_osh(om, am);
+  apf::removeTagFromDimension(am, vert_nums, 0);
+  am->destroyTag(vert_nums);
+  fields_to_osh(om, am, ents);
 }
 
-static void
-class_from_osh(apf::Mesh2* am, osh::Mesh* om,
-    std::vector<apf::MeshEntity*> const& ents,
-    int ent_dim) {
-  auto class_dim = osh::HostRead<osh::I8>(om->get_array<osh::I8>(ent_dim, "class_dim"));
-  auto class_id = osh::HostRead<osh::LO>(om->get_array<osh::LO>(ent_dim, "class_id"));
-  for (int i = 0; i < om->nents(ent_dim); ++i) {
+/* vertices are created already classified and positioned,
+   and buildElement classifies the higher entities as they are
+   created in increasing dimension, so no separate
+   classification or coordinate pass is needed */
+static Ents verts_from_osh(apf::Mesh2* am, osh::Mesh* om) {
+  auto nverts = om->nverts();
+  auto dim = om->dim();
+  auto coords = osh::HostRead<osh::Real>(om->coords());
+  auto class_dim = osh::HostRead<osh::I8>(
+      om->get_array<osh::I8>(0, "class_dim"));
+  auto class_id = osh::HostRead<osh::LO>(
+      om->get_array<osh::LO>(0, "class_id"));
+  Ents verts(nverts);
+  for (osh::LO i = 0; i < nverts; ++i) {
     auto ge = am->findModelEntity(class_dim[i], class_id[i]);
-    am->setModelEntity(ents[i], ge);
-  }
-}
-
-static std::vector<apf::MeshEntity*>
-verts_from_osh(apf::Mesh2* am, osh::Mesh* om) {
-  std::vector<apf::MeshEntity*> verts(om->nverts());
-  for (int i = 0; i < om->nverts(); ++i) {
-    verts[i] = am->createVert(nullptr);
+    verts[i] = am->createVert(ge);
+    apf::Vector3 x(0,0,0);
+    for (int j = 0; j < dim; ++j) x[j] = coords[i * dim + j];
+    am->setPoint(verts[i], 0, x);
   }
   assert(int(am->count(0)) == om->nverts());
   return verts;
 }
 
-static std::vector<apf::MeshEntity*>
-ents_from_osh(
+static Ents ents_from_osh(
     apf::Mesh2* am,
     osh::Mesh* om,
-    std::vector<apf::MeshEntity*> const& verts,
+    Ents const& verts,
     int ent_dim)
 {
-  std::vector<apf::MeshEntity*> ents(om->nents(ent_dim));
+  Ents ents(om->nents(ent_dim));
   auto ev2v = osh::HostRead<osh::LO>(om->ask_verts_of(ent_dim));
   auto class_dim = osh::HostRead<osh::I8>(
       om->get_array<osh::I8>(ent_dim, "class_dim"));
@@ -366,7 +386,7 @@ ents_from_osh(
 static void owners_from_osh(
     apf::Mesh2* am,
     osh::Mesh* om,
-    std::vector<apf::MeshEntity*> const& ents,
+    Ents const& ents,
     int ent_dim)
 {
   auto owners = om->ask_owners(ent_dim);
@@ -442,18 +462,16 @@ static void owners_from_osh(
 
 void from_omega_h(apf::Mesh2* am, osh::Mesh* om)
 {
-  std::vector<apf::MeshEntity*> ents[4];
+  Ents ents[4];
   ents[0] = verts_from_osh(am, om);
   for (int d = 1; d <= om->dim(); ++d)
     ents[d] = ents_from_osh(am, om, ents[0], d);
-  coords_from_osh(am, om);
   for (int d = 0; d <= om->dim(); ++d) {
-    class_from_osh(am, om, ents[d], d);
     owners_from_osh(am, om, ents[d], d);
     apf::initResidence(am, d);
   }
   am->acceptChanges();
-  fields_from_osh(am, om);
+  fields_from_osh(am, om, ents);
 }
 
 };
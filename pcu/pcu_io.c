@@ -22,16 +22,373 @@
 #ifdef PCU_BZIP
 #include <bzlib.h>
 #endif
+#ifdef PCU_ZSTD
+#include <zstd.h>
+#endif
+
+#if defined(PCU_BZIP) || defined(PCU_ZSTD)
+#define PCU_BLOCKS
+#endif
+
+/* compressed files are written as a block-framed container:
+
+     "PCUZ" version(1 byte) codec(1 byte) 0(2 bytes) block size(4 bytes)
+     { raw size(4 bytes) packed size(4 bytes) packed bytes } ...
+     0(4 bytes) 0(4 bytes)
+
+   all integers are big endian. blocks are independent, so a batch
+   of them is compressed or decompressed by OpenMP threads at once.
+   the writer picks the codec, bzip2 or zstd, and readers take it
+   from the header. files that do not start with the magic are read
+   as the single bzip2 stream that older versions wrote. */
+
+#define PCU_BLOCK_MAGIC "PCUZ"
+#define PCU_BLOCK_VERSION 1
+#define PCU_BLOCK_SIZE (1 << 20)
+#define PCU_BATCH_BLOCKS 16
+
+typedef struct pcu_blocks {
+  int codec;
+  size_t block_size;
+  /* uncompressed bytes of the current batch */
+  char* raw;
+  size_t raw_size;
+  size_t raw_pos;
+  /* compressed blocks of the current batch */
+  char* packed[PCU_BATCH_BLOCKS];
+  size_t packed_cap[PCU_BATCH_BLOCKS];
+  size_t packed_size[PCU_BATCH_BLOCKS];
+  size_t block_raw[PCU_BATCH_BLOCKS];
+  bool done;
+} pcu_blocks;
 
 typedef struct pcu_file {
   FILE* f;
 #ifdef PCU_BZIP
   BZFILE* bzf;
 #endif
+  pcu_blocks* blocks;
   bool write;
-  bool compress;
+  int codec;
+  /* the buffer of pcu_mopen_write */
+  char* mem;
+  size_t mem_size;
 } pcu_file;
 
+static void put_u32(unsigned char* p, uint32_t v)
+{
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+static uint32_t get_u32(unsigned char const* p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void put_u64(unsigned char* p, uint64_t v)
+{
+  put_u32(p, v >> 32);
+  put_u32(p + 4, v);
+}
+
+static uint64_t get_u64(unsigned char const* p)
+{
+  return ((uint64_t)get_u32(p) << 32) | get_u32(p + 4);
+}
+
+#ifdef PCU_BLOCKS
+
+static size_t codec_bound(int codec, size_t n)
+{
+#ifdef PCU_ZSTD
+  if (codec == PCU_CODEC_ZSTD)
+    return ZSTD_compressBound(n);
+#endif
+  (void)codec;
+  /* the bound documented for BZ2_bzBuffToBuffCompress */
+  return n + n / 100 + 600;
+}
+
+/* these run on OpenMP threads, so they report failure
+   instead of calling reel_fail */
+static int codec_compress(int codec, char* dst, size_t* dst_size,
+    char* src, size_t n)
+{
+#ifdef PCU_ZSTD
+  if (codec == PCU_CODEC_ZSTD) {
+    size_t rv = ZSTD_compress(dst, *dst_size, src, n, 3);
+    if (ZSTD_isError(rv))
+      return 0;
+    *dst_size = rv;
+    return 1;
+  }
+#endif
+#ifdef PCU_BZIP
+  if (codec == PCU_CODEC_BZIP2) {
+    unsigned len = *dst_size;
+    if (BZ2_bzBuffToBuffCompress(dst, &len, src, n, 9, 0, 30) != BZ_OK)
+      return 0;
+    *dst_size = len;
+    return 1;
+  }
+#endif
+  (void)codec; (void)dst; (void)dst_size; (void)src; (void)n;
+  return 0;
+}
+
+static int codec_decompress(int codec, char* dst, size_t n,
+    char* src, size_t packed)
+{
+#ifdef PCU_ZSTD
+  if (codec == PCU_CODEC_ZSTD) {
+    size_t rv = ZSTD_decompress(dst, n, src, packed);
+    return !ZSTD_isError(rv) && rv == n;
+  }
+#endif
+#ifdef PCU_BZIP
+  if (codec == PCU_CODEC_BZIP2) {
+    unsigned len = n;
+    if (BZ2_bzBuffToBuffDecompress(dst, &len, src, packed, 0, 0) != BZ_OK)
+      return 0;
+    return len == n;
+  }
+#endif
+  (void)codec; (void)dst; (void)n; (void)src; (void)packed;
+  return 0;
+}
+
+static void check_codec(int codec)
+{
+#ifdef PCU_ZSTD
+  if (codec == PCU_CODEC_ZSTD)
+    return;
+#endif
+#ifdef PCU_BZIP
+  if (codec == PCU_CODEC_BZIP2)
+    return;
+#endif
+  reel_fail("compression codec %d is not built in, recompile PCU with %s",
+      codec, codec == PCU_CODEC_ZSTD ? "-DPCU_ZSTD=ON" : "-DPCU_COMPRESS=ON");
+}
+
+static void file_read(pcu_file* pf, void* p, size_t n)
+{
+  if (n != fread(p, 1, n, pf->f))
+    reel_fail("pcu_fread: compressed file is truncated");
+}
+
+static void file_write(pcu_file* pf, void const* p, size_t n)
+{
+  if (n != fwrite(p, 1, n, pf->f))
+    reel_fail("pcu_fwrite: fwrite of %lu bytes failed", (unsigned long)n);
+}
+
+static void reserve_packed(pcu_blocks* b, int i, size_t n)
+{
+  if (n <= b->packed_cap[i])
+    return;
+  noto_free(b->packed[i]);
+  b->packed[i] = noto_malloc(n);
+  b->packed_cap[i] = n;
+}
+
+static pcu_blocks* make_blocks(int codec, size_t block_size)
+{
+  int i;
+  pcu_blocks* b = noto_malloc(sizeof(pcu_blocks));
+  b->codec = codec;
+  b->block_size = block_size;
+  b->raw = noto_malloc(block_size * PCU_BATCH_BLOCKS);
+  b->raw_size = 0;
+  b->raw_pos = 0;
+  for (i = 0; i < PCU_BATCH_BLOCKS; ++i) {
+    b->packed[i] = NULL;
+    b->packed_cap[i] = 0;
+  }
+  b->done = false;
+  return b;
+}
+
+static void free_blocks(pcu_blocks* b)
+{
+  int i;
+  for (i = 0; i < PCU_BATCH_BLOCKS; ++i)
+    noto_free(b->packed[i]);
+  noto_free(b->raw);
+  noto_free(b);
+}
+
+static void open_blocks_write(pcu_file* pf)
+{
+  unsigned char header[12];
+  pcu_blocks* b;
+  check_codec(pf->codec);
+  b = make_blocks(pf->codec, PCU_BLOCK_SIZE);
+  memcpy(header, PCU_BLOCK_MAGIC, 4);
+  header[4] = PCU_BLOCK_VERSION;
+  header[5] = b->codec;
+  header[6] = header[7] = 0;
+  put_u32(header + 8, b->block_size);
+  file_write(pf, header, sizeof(header));
+  pf->blocks = b;
+}
+
+/* returns false, having consumed nothing, if the file
+   does not start with a block container header */
+static bool open_blocks_read(pcu_file* pf)
+{
+  unsigned char header[12];
+  int codec;
+  size_t block_size;
+  if (fread(header, 1, sizeof(header), pf->f) != sizeof(header) ||
+      memcmp(header, PCU_BLOCK_MAGIC, 4)) {
+    rewind(pf->f);
+    return false;
+  }
+  if (header[4] != PCU_BLOCK_VERSION)
+    reel_fail("compressed file has unknown version %d", header[4]);
+  codec = header[5];
+  check_codec(codec);
+  block_size = get_u32(header + 8);
+  if (!block_size)
+    reel_fail("compressed file has zero block size");
+  pf->blocks = make_blocks(codec, block_size);
+  return true;
+}
+
+/* compresses the buffered blocks in parallel,
+   then appends them to the file in order */
+static void flush_blocks(pcu_file* pf)
+{
+  pcu_blocks* b = pf->blocks;
+  int n = (b->raw_size + b->block_size - 1) / b->block_size;
+  int failed = 0;
+  int i;
+  for (i = 0; i < n; ++i) {
+    size_t len = b->raw_size - i * b->block_size;
+    if (len > b->block_size)
+      len = b->block_size;
+    b->block_raw[i] = len;
+    reserve_packed(b, i, codec_bound(b->codec, len));
+  }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:failed)
+#endif
+  for (i = 0; i < n; ++i) {
+    b->packed_size[i] = b->packed_cap[i];
+    if (!codec_compress(b->codec, b->packed[i], &b->packed_size[i],
+          b->raw + i * b->block_size, b->block_raw[i]))
+      ++failed;
+  }
+  if (failed)
+    reel_fail("pcu_fwrite: compression of %d blocks failed", failed);
+  for (i = 0; i < n; ++i) {
+    unsigned char header[8];
+    put_u32(header, b->block_raw[i]);
+    put_u32(header + 4, b->packed_size[i]);
+    file_write(pf, header, sizeof(header));
+    file_write(pf, b->packed[i], b->packed_size[i]);
+  }
+  b->raw_size = 0;
+}
+
+/* reads the next batch of blocks, then decompresses them in parallel */
+static void fill_blocks(pcu_file* pf)
+{
+  pcu_blocks* b = pf->blocks;
+  size_t offsets[PCU_BATCH_BLOCKS];
+  int n = 0;
+  int failed = 0;
+  int i;
+  b->raw_size = 0;
+  b->raw_pos = 0;
+  while (!b->done && n < PCU_BATCH_BLOCKS) {
+    unsigned char header[8];
+    size_t raw;
+    size_t packed;
+    file_read(pf, header, sizeof(header));
+    raw = get_u32(header);
+    packed = get_u32(header + 4);
+    if (!raw) {
+      b->done = true;
+      break;
+    }
+    if (raw > b->block_size)
+      reel_fail("compressed file has a block of %lu bytes, more than %lu",
+          (unsigned long)raw, (unsigned long)b->block_size);
+    reserve_packed(b, n, packed);
+    file_read(pf, b->packed[n], packed);
+    b->packed_size[n] = packed;
+    b->block_raw[n] = raw;
+    offsets[n] = b->raw_size;
+    b->raw_size += raw;
+    ++n;
+  }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:failed)
+#endif
+  for (i = 0; i < n; ++i)
+    if (!codec_decompress(b->codec, b->raw + offsets[i], b->block_raw[i],
+          b->packed[i], b->packed_size[i]))
+      ++failed;
+  if (failed)
+    reel_fail("pcu_fread: decompression of %d blocks failed", failed);
+}
+
+static void blocks_write(pcu_file* pf, char const* data, size_t size)
+{
+  pcu_blocks* b = pf->blocks;
+  size_t cap = b->block_size * PCU_BATCH_BLOCKS;
+  while (size) {
+    size_t len = cap - b->raw_size;
+    if (len > size)
+      len = size;
+    memcpy(b->raw + b->raw_size, data, len);
+    b->raw_size += len;
+    data += len;
+    size -= len;
+    if (b->raw_size == cap)
+      flush_blocks(pf);
+  }
+}
+
+static void blocks_read(pcu_file* pf, char* data, size_t size)
+{
+  pcu_blocks* b = pf->blocks;
+  while (size) {
+    size_t len;
+    if (b->raw_pos == b->raw_size) {
+      fill_blocks(pf);
+      if (!b->raw_size)
+        reel_fail("pcu_fread: unexpected end of compressed file");
+    }
+    len = b->raw_size - b->raw_pos;
+    if (len > size)
+      len = size;
+    memcpy(data, b->raw + b->raw_pos, len);
+    b->raw_pos += len;
+    data += len;
+    size -= len;
+  }
+}
+
+static void close_blocks(pcu_file* pf)
+{
+  if (pf->write) {
+    unsigned char end[8] = {0};
+    flush_blocks(pf);
+    file_write(pf, end, sizeof(end));
+  }
+  free_blocks(pf->blocks);
+  pf->blocks = NULL;
+}
+
+#endif
+
 #ifdef PCU_BZIP
 
 static void open_compressed_read(pcu_file* pf)
@@ -46,25 +403,6 @@ static void open_compressed_read(pcu_file* pf)
     reel_fail("BZ2_bzReadOpen failed with code %d", bzerror);
 }
 
-static void open_compressed_write(pcu_file* pf)
-{
-  int bzerror;
-  int verbosity = 0;
-  int blockSize100k = 9;
-  int workFactor = 30;
-  pf->bzf = BZ2_bzWriteOpen(&bzerror, pf->f, blockSize100k, verbosity, workFactor);
-  if (bzerror != BZ_OK)
-    reel_fail("BZ2_bzWriteOpen failed with code %d", bzerror);
-}
-
-static void open_compressed(pcu_file* pf)
-{
-  if (pf->write)
-    open_compressed_write(pf);
-  else
-    open_compressed_read(pf);
-}
-
 static void compressed_read(pcu_file* pf, void* data, size_t size)
 {
   int bzerror;
@@ -78,75 +416,98 @@ static void compressed_read(pcu_file* pf, void* data, size_t size)
   PCU_ALWAYS_ASSERT(rv == len);
 }
 
-static void compressed_write(pcu_file* pf, void const* data, size_t size)
+static void close_compressed_read(pcu_file* pf)
 {
   int bzerror;
-  int len;
-  void* bzip2_is_not_const_correct;
-  PCU_ALWAYS_ASSERT_VERBOSE(size < INT_MAX, 
-    "partition the mesh further or disable bz2 mesh compression\n");
-  len = size;
-  bzip2_is_not_const_correct = (void*)data;
-  BZ2_bzWrite(&bzerror, pf->bzf, bzip2_is_not_const_correct, len);
+  BZ2_bzReadClose(&bzerror, pf->bzf);
   if (bzerror != BZ_OK)
-    reel_fail("BZ2_bzWrite failed with code %d", bzerror);
+    reel_fail("BZ2_readClose failed with code %d", bzerror);
+}
+
+#elif defined(PCU_BLOCKS)
+
+static void open_compressed_read(pcu_file* pf)
+{
+  (void)pf;
+  reel_fail("file is not block compressed, "
+      "recompile PCU with -DPCU_COMPRESS=ON to read bzip2 streams");
+}
+
+static void compressed_read(pcu_file* pf, void* data, size_t size)
+{
+  (void)pf;
+  (void)data;
+  (void)size;
+  reel_fail("recompile PCU with -DPCU_COMPRESS=ON");
 }
 
 static void close_compressed_read(pcu_file* pf)
 {
-  int bzerror;
-  BZ2_bzReadClose(&bzerror, pf->bzf);
-  if (bzerror != BZ_OK)
-    reel_fail("BZ2_readClose failed with code %d", bzerror);
+  (void)pf;
+  reel_fail("recompile PCU with -DPCU_COMPRESS=ON");
 }
 
-static void close_compressed_write(pcu_file* pf)
+#endif
+
+#ifdef PCU_BLOCKS
+
+static void open_compressed(pcu_file* pf)
 {
-  int bzerror;
-  int abandon = 0;
-  unsigned* nbytes_in = NULL;
-  unsigned* nbytes_out = NULL;
-  BZ2_bzWriteClose(&bzerror, pf->bzf, abandon, nbytes_in, nbytes_out);
-  if (bzerror != BZ_OK)
-    reel_fail("BZ2_writeClose failed with code %d", bzerror);
+  if (pf->write)
+    open_blocks_write(pf);
+  else if (!open_blocks_read(pf))
+    open_compressed_read(pf);
 }
 
 static void close_compressed(pcu_file* pf)
 {
-  if (pf->write)
-    close_compressed_write(pf);
+  if (pf->blocks)
+    close_blocks(pf);
   else
     close_compressed_read(pf);
 }
 
+static void compressed_file_read(pcu_file* pf, void* data, size_t size)
+{
+  if (pf->blocks)
+    blocks_read(pf, data, size);
+  else
+    compressed_read(pf, data, size);
+}
+
+static void compressed_file_write(pcu_file* pf, void const* data, size_t size)
+{
+  blocks_write(pf, data, size);
+}
+
 #else
 
 static void open_compressed(pcu_file* pf)
 {
   (void)pf;
-  reel_fail("recompile PCU with -DPCU_COMPRESS=ON");
+  reel_fail("recompile PCU with -DPCU_COMPRESS=ON or -DPCU_ZSTD=ON");
 }
 
-static void compressed_read(pcu_file* pf, void* data, size_t size)
+static void compressed_file_read(pcu_file* pf, void* data, size_t size)
 {
   (void)pf;
   (void)data;
   (void)size;
-  reel_fail("recompile PCU with -DPCU_COMPRESS=ON");
+  reel_fail("recompile PCU with -DPCU_COMPRESS=ON or -DPCU_ZSTD=ON");
 }
 
-static void compressed_write(pcu_file* pf, void const* data, size_t size)
+static void compressed_file_write(pcu_file* pf, void const* data, size_t size)
 {
   (void)pf;
   (void)data;
   (void)size;
-  reel_fail("recompile PCU with -DPCU_COMPRESS=ON");
+  reel_fail("recompile PCU with -DPCU_COMPRESS=ON or -DPCU_ZSTD=ON");
 }
 
 static void close_compressed(pcu_file* pf)
 {
   (void)pf;
-  reel_fail("recompile PCU with -DPCU_COMPRESS=ON");
+  reel_fail("recompile PCU with -DPCU_COMPRESS=ON or -DPCU_ZSTD=ON");
 }
 
 #endif
@@ -182,35 +543,237 @@ FILE* pcu_group_open(const char* path, bool write) {
   return fp;
 }
 
-pcu_file* pcu_fopen(const char* name, bool write, bool compress)
+pcu_file* pcu_fopen(const char* name, bool write, int codec)
 {
   pcu_file* pf = (pcu_file*) malloc(sizeof(pcu_file));
-  pf->compress = compress;
+  pf->codec = codec;
   pf->write = write;
+  pf->blocks = NULL;
+  pf->mem = NULL;
+  pf->mem_size = 0;
   pf->f = pcu_group_open(name, write);
   if (!pf->f) {
     perror("pcu_fopen");
     reel_fail("pcu_fopen couldn't open \"%s\"", name);
   }
-  if(compress)
+  if (codec)
     open_compressed(pf);
   return pf;
 }
 
 void pcu_fclose(pcu_file* pf)
 {
-  if (pf->compress)
+  if (pf->codec)
     close_compressed(pf);
   fclose(pf->f);
   free(pf);
 }
 
+pcu_file* pcu_mopen_write(int codec)
+{
+  pcu_file* pf = (pcu_file*) malloc(sizeof(pcu_file));
+  pf->codec = codec;
+  pf->write = true;
+  pf->blocks = NULL;
+  pf->mem = NULL;
+  pf->mem_size = 0;
+  pf->f = open_memstream(&pf->mem, &pf->mem_size);
+  if (!pf->f)
+    reel_fail("pcu_mopen_write: open_memstream failed");
+  if (codec)
+    open_compressed(pf);
+  return pf;
+}
+
+void pcu_mclose_write(pcu_file* pf, char** data, size_t* size)
+{
+  if (pf->codec)
+    close_compressed(pf);
+  fclose(pf->f);
+  *data = pf->mem;
+  *size = pf->mem_size;
+  free(pf);
+}
+
+pcu_file* pcu_mopen_read(void* data, size_t size, int codec)
+{
+  pcu_file* pf = (pcu_file*) malloc(sizeof(pcu_file));
+  pf->codec = codec;
+  pf->write = false;
+  pf->blocks = NULL;
+  pf->mem = NULL;
+  pf->mem_size = 0;
+  pf->f = fmemopen(data, size, "r");
+  if (!pf->f)
+    reel_fail("pcu_mopen_read: fmemopen of %lu bytes failed",
+        (unsigned long)size);
+  if (codec)
+    open_compressed(pf);
+  return pf;
+}
+
+bool pcu_is_block_compressed(void const* data, size_t size)
+{
+  return size >= 4 && !memcmp(data, PCU_BLOCK_MAGIC, 4);
+}
+
+/* a sections file holds one section per rank of the writing
+   communicator, found through an index table:
+
+     "PCUS" version(4 bytes) section count(8 bytes)
+     { offset(8 bytes) size(8 bytes) } ...
+     section bytes ...
+
+   all integers are big endian. sections are laid out in rank
+   order, so a contiguous range of them is one byte range. */
+
+#define PCU_SECTIONS_MAGIC "PCUS"
+#define PCU_SECTIONS_VERSION 1
+#define PCU_SECTIONS_HEADER 16
+#define PCU_SECTIONS_ENTRY 16
+/* MPI counts are ints, so large transfers are split */
+#define PCU_SECTIONS_CHUNK ((size_t)1 << 30)
+
+static void check_mpi_io(int rv, const char* what, const char* path)
+{
+  char message[MPI_MAX_ERROR_STRING];
+  int len;
+  if (rv == MPI_SUCCESS)
+    return;
+  MPI_Error_string(rv, message, &len);
+  reel_fail("%s \"%s\" failed: %s", what, path, message);
+}
+
+static MPI_File open_sections(const char* path, bool write)
+{
+  MPI_File fh;
+  int mode = write ? (MPI_MODE_WRONLY | MPI_MODE_CREATE) : MPI_MODE_RDONLY;
+  check_mpi_io(MPI_File_open(PCU_Get_Comm(), (char*)path, mode,
+        MPI_INFO_NULL, &fh), "MPI_File_open", path);
+  return fh;
+}
+
+/* collective, every rank takes the same number of rounds */
+static void transfer_all(MPI_File fh, const char* path, bool write,
+    uint64_t offset, char* data, size_t size)
+{
+  long rounds = (size + PCU_SECTIONS_CHUNK - 1) / PCU_SECTIONS_CHUNK;
+  long i;
+  MPI_Allreduce(MPI_IN_PLACE, &rounds, 1, MPI_LONG, MPI_MAX, PCU_Get_Comm());
+  for (i = 0; i < rounds; ++i) {
+    size_t done = i * PCU_SECTIONS_CHUNK;
+    size_t n = 0;
+    MPI_Status status;
+    if (done < size) {
+      n = size - done;
+      if (n > PCU_SECTIONS_CHUNK)
+        n = PCU_SECTIONS_CHUNK;
+    }
+    if (write)
+      check_mpi_io(MPI_File_write_at_all(fh, offset + done, data + done,
+            n, MPI_BYTE, &status), "MPI_File_write_at_all", path);
+    else
+      check_mpi_io(MPI_File_read_at_all(fh, offset + done, data + done,
+            n, MPI_BYTE, &status), "MPI_File_read_at_all", path);
+  }
+}
+
+void pcu_write_sections(const char* path, void const* data, size_t size)
+{
+  MPI_Comm comm = PCU_Get_Comm();
+  int self = PCU_Comm_Self();
+  int peers = PCU_Comm_Peers();
+  uint64_t mine = size;
+  uint64_t before = 0;
+  uint64_t offset;
+  unsigned char entry[PCU_SECTIONS_ENTRY];
+  unsigned char* table = NULL;
+  MPI_File fh;
+  MPI_Exscan(&mine, &before, 1, MPI_UINT64_T, MPI_SUM, comm);
+  if (!self)
+    before = 0;
+  offset = PCU_SECTIONS_HEADER + (uint64_t)peers * PCU_SECTIONS_ENTRY + before;
+  put_u64(entry, offset);
+  put_u64(entry + 8, mine);
+  if (!self)
+    table = malloc((size_t)peers * PCU_SECTIONS_ENTRY);
+  MPI_Gather(entry, PCU_SECTIONS_ENTRY, MPI_BYTE,
+      table, PCU_SECTIONS_ENTRY, MPI_BYTE, 0, comm);
+  fh = open_sections(path, true);
+  check_mpi_io(MPI_File_set_size(fh, 0), "MPI_File_set_size", path);
+  if (!self) {
+    unsigned char header[PCU_SECTIONS_HEADER];
+    MPI_Status status;
+    memcpy(header, PCU_SECTIONS_MAGIC, 4);
+    put_u32(header + 4, PCU_SECTIONS_VERSION);
+    put_u64(header + 8, peers);
+    check_mpi_io(MPI_File_write_at(fh, 0, header, PCU_SECTIONS_HEADER,
+          MPI_BYTE, &status), "MPI_File_write_at", path);
+    check_mpi_io(MPI_File_write_at(fh, PCU_SECTIONS_HEADER, table,
+          peers * PCU_SECTIONS_ENTRY, MPI_BYTE, &status),
+        "MPI_File_write_at", path);
+    free(table);
+  }
+  transfer_all(fh, path, true, offset, (char*)data, size);
+  check_mpi_io(MPI_File_close(&fh), "MPI_File_close", path);
+}
+
+int pcu_count_sections(const char* path)
+{
+  unsigned char header[PCU_SECTIONS_HEADER];
+  int count = 0;
+  MPI_File fh = open_sections(path, false);
+  if (!PCU_Comm_Self()) {
+    MPI_Status status;
+    check_mpi_io(MPI_File_read_at(fh, 0, header, PCU_SECTIONS_HEADER,
+          MPI_BYTE, &status), "MPI_File_read_at", path);
+    if (memcmp(header, PCU_SECTIONS_MAGIC, 4))
+      reel_fail("\"%s\" is not a sections file", path);
+    if (get_u32(header + 4) != PCU_SECTIONS_VERSION)
+      reel_fail("\"%s\" has unknown sections version %u", path,
+          (unsigned)get_u32(header + 4));
+    count = get_u64(header + 8);
+  }
+  check_mpi_io(MPI_File_close(&fh), "MPI_File_close", path);
+  MPI_Bcast(&count, 1, MPI_INT, 0, PCU_Get_Comm());
+  return count;
+}
+
+void* pcu_read_sections(const char* path, int first, int count,
+    size_t* starts, size_t* sizes)
+{
+  unsigned char* table;
+  uint64_t begin = 0;
+  uint64_t end = 0;
+  char* data;
+  int i;
+  MPI_File fh = open_sections(path, false);
+  table = malloc((size_t)count * PCU_SECTIONS_ENTRY + 1);
+  transfer_all(fh, path, false,
+      PCU_SECTIONS_HEADER + (uint64_t)first * PCU_SECTIONS_ENTRY,
+      (char*)table, (size_t)count * PCU_SECTIONS_ENTRY);
+  if (count) {
+    begin = get_u64(table);
+    end = get_u64(table + (count - 1) * PCU_SECTIONS_ENTRY) +
+          get_u64(table + (count - 1) * PCU_SECTIONS_ENTRY + 8);
+  }
+  for (i = 0; i < count; ++i) {
+    starts[i] = get_u64(table + i * PCU_SECTIONS_ENTRY) - begin;
+    sizes[i] = get_u64(table + i * PCU_SECTIONS_ENTRY + 8);
+  }
+  free(table);
+  data = malloc(end - begin + 1);
+  transfer_all(fh, path, false, begin, data, end - begin);
+  check_mpi_io(MPI_File_close(&fh), "MPI_File_close", path);
+  return data;
+}
+
 void pcu_fwrite(void const* p, size_t size, size_t nmemb, pcu_file * f)
 {
   if (!f->write)
     reel_fail("pcu_fwrite: file not opened for writing.");
-  if (f->compress) {
-    compressed_write(f, p, size * nmemb);
+  if (f->codec) {
+    compressed_file_write(f, p, size * nmemb);
   } else {
     if (nmemb != fwrite(p, size, nmemb, f->f))
       reel_fail("fwrite(%p, %lu, %lu, %p) failed", p, size, nmemb, (void*) f->f);
@@ -221,8 +784,8 @@ void pcu_fread(void* p, size_t size, size_t nmemb, pcu_file * f)
 {
   if (f->write)
     reel_fail("pcu_fread: file not opened for reading.");
-  if (f->compress) {
-    compressed_read(f, p, size * nmemb);
+  if (f->codec) {
+    compressed_file_read(f, p, size * nmemb);
   } else {
     if (nmemb != fread(p, size, nmemb, f->f))
       reel_fail("fread(%p, %lu, %lu, %p) failed", p, size, nmemb, (void*) f->f);
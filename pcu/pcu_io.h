@@ -21,7 +21,15 @@ extern "C" {
 
 struct pcu_file;
 
-struct pcu_file* pcu_fopen(const char* path, bool write, bool compress);
+/* how pcu_fopen and pcu_mopen_* compress a file. readers find the
+   codec in the file itself, so any nonzero value decompresses */
+enum {
+  PCU_NO_CODEC = 0,
+  PCU_CODEC_BZIP2 = 1,
+  PCU_CODEC_ZSTD = 2
+};
+
+struct pcu_file* pcu_fopen(const char* path, bool write, int codec);
 void pcu_fclose (struct pcu_file * pf);
 void pcu_read(struct pcu_file* f, char* p, size_t n);
 void pcu_write(struct pcu_file* f, const char* p, size_t n);
@@ -34,6 +42,22 @@ void pcu_write_doubles(struct pcu_file* f, double* p, size_t n);
 void pcu_read_string(struct pcu_file* f, char** p);
 void pcu_write_string(struct pcu_file* f, const char* p);
 
+/* files in memory: pcu_mclose_write returns a malloc'd buffer
+   holding everything written, which pcu_mopen_read can read back */
+struct pcu_file* pcu_mopen_write(int codec);
+void pcu_mclose_write(struct pcu_file* pf, char** data, size_t* size);
+struct pcu_file* pcu_mopen_read(void* data, size_t size, int codec);
+bool pcu_is_block_compressed(void const* data, size_t size);
+
+/* collective single-file I/O through MPI-IO: every rank writes
+   one section, and readers may fetch any contiguous range of
+   sections. pcu_read_sections returns one malloc'd buffer, and
+   section first+i is sizes[i] bytes at offset starts[i] in it */
+void pcu_write_sections(const char* path, void const* data, size_t size);
+int pcu_count_sections(const char* path);
+void* pcu_read_sections(const char* path, int first, int count,
+    size_t* starts, size_t* sizes);
+
 FILE* pcu_open_parallel(const char* prefix, const char* ext);
 FILE* pcu_group_open(const char* path, bool write);
 
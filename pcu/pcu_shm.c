@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include "pcu_shm.h"
+#include "PCU.h"
+#include "noto_malloc.h"
+#include "reel.h"
+#include <string.h>
+
+struct pcu_shm {
+  MPI_Comm node;
+  MPI_Win win;
+  int has_win;
+  int self;
+  int peers;
+  /* the PCU ranks of the node, ascending */
+  int* ranks;
+};
+
+struct pcu_shm* pcu_shm_open(void)
+{
+  struct pcu_shm* s;
+  int self = PCU_Comm_Self();
+  s = noto_malloc(sizeof(*s));
+  s->has_win = 0;
+  MPI_Comm_split_type(PCU_Get_Comm(), MPI_COMM_TYPE_SHARED, self,
+      MPI_INFO_NULL, &s->node);
+  MPI_Comm_rank(s->node, &s->self);
+  MPI_Comm_size(s->node, &s->peers);
+  s->ranks = noto_malloc(s->peers * sizeof(int));
+  MPI_Allgather(&self, 1, MPI_INT, s->ranks, 1, MPI_INT, s->node);
+  return s;
+}
+
+void pcu_shm_alloc(struct pcu_shm* s, size_t size)
+{
+  void* base;
+  if (s->has_win)
+    reel_fail("pcu_shm_alloc: called twice");
+  if (MPI_Win_allocate_shared(size, 1, MPI_INFO_NULL, s->node,
+        &base, &s->win) != MPI_SUCCESS)
+    reel_fail("pcu_shm: MPI_Win_allocate_shared of %lu bytes failed",
+        (unsigned long)size);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, s->win);
+  s->has_win = 1;
+}
+
+void pcu_shm_close(struct pcu_shm* s)
+{
+  if (s->has_win) {
+    MPI_Win_unlock_all(s->win);
+    MPI_Win_free(&s->win);
+  }
+  MPI_Comm_free(&s->node);
+  noto_free(s->ranks);
+  noto_free(s);
+}
+
+int pcu_shm_self(struct pcu_shm* s)
+{
+  return s->self;
+}
+
+int pcu_shm_peers(struct pcu_shm* s)
+{
+  return s->peers;
+}
+
+int pcu_shm_node_rank(struct pcu_shm* s, int rank)
+{
+  int lo = 0;
+  int hi = s->peers;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (s->ranks[mid] < rank)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo < s->peers && s->ranks[lo] == rank)
+    return lo;
+  return -1;
+}
+
+void* pcu_shm_segment(struct pcu_shm* s, int node_rank, size_t* size)
+{
+  MPI_Aint bytes;
+  int unit;
+  void* base;
+  MPI_Win_shared_query(s->win, node_rank, &bytes, &unit, &base);
+  if (size)
+    *size = bytes;
+  return base;
+}
+
+/* the separate memory model needs the syncs around the barrier,
+   the unified one tolerates them */
+void pcu_shm_fence(struct pcu_shm* s)
+{
+  if (s->has_win)
+    MPI_Win_sync(s->win);
+  MPI_Barrier(s->node);
+  if (s->has_win)
+    MPI_Win_sync(s->win);
+}
+
+struct pcu_shm* pcu_shm_share(void const* data, size_t size, void** copy)
+{
+  struct pcu_shm* s = pcu_shm_open();
+  pcu_shm_alloc(s, s->self ? 0 : size);
+  *copy = pcu_shm_segment(s, 0, NULL);
+  if (!s->self && size)
+    memcpy(*copy, data, size);
+  pcu_shm_fence(s);
+  return s;
+}
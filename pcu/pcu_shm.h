@@ -0,0 +1,53 @@
+/*
+ * Copyright 2026 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef PCU_SHM_H
+#define PCU_SHM_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* memory shared by the ranks of one compute node, through an
+   MPI-3 shared window over the current PCU communicator.
+   every rank owns one segment and can load and store into the
+   segments of the other ranks on its node. node ranks are
+   numbered from zero in PCU rank order. */
+struct pcu_shm;
+
+/* collective; groups the ranks of each node */
+struct pcu_shm* pcu_shm_open(void);
+/* collective over the node, once per pcu_shm: allocates this
+   rank's segment. size may differ between ranks and be zero */
+void pcu_shm_alloc(struct pcu_shm* s, size_t size);
+/* collective over every rank that opened s, whatever the PCU
+   communicator is by then; the segments are gone afterwards */
+void pcu_shm_close(struct pcu_shm* s);
+
+int pcu_shm_self(struct pcu_shm* s);
+int pcu_shm_peers(struct pcu_shm* s);
+/* the node rank of a PCU rank, or -1 if it is on another node */
+int pcu_shm_node_rank(struct pcu_shm* s, int rank);
+/* the segment of a rank on this node, and its size */
+void* pcu_shm_segment(struct pcu_shm* s, int node_rank, size_t* size);
+/* collective over the node: stores made before it are
+   visible to loads made after it on every rank of the node */
+void pcu_shm_fence(struct pcu_shm* s);
+
+/* collective; one read-only copy per node of the size bytes at
+   data on the lowest rank of each node, which other ranks may
+   leave null. *copy points to it until pcu_shm_close, which
+   all ranks that shared it must then call together */
+struct pcu_shm* pcu_shm_share(void const* data, size_t size, void** copy);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -1,6 +1,7 @@
 tribits_package(SCORECpcu)
 
 option(PCU_COMPRESS "Enable SMB compression using libbzip2 [ON|OFF]" OFF)
+option(PCU_ZSTD "Enable block-parallel SMB compression using libzstd [ON|OFF]" OFF)
 
 set(CMAKE_MODULE_PATH
    ${CMAKE_MODULE_PATH}
@@ -42,6 +43,7 @@ set(SOURCES
    pcu_msg.c
    pcu_order.c
    pcu_pmpi.c
+   pcu_shm.c
    pcu_util.c
    noto/noto_malloc.c
    reel/reel.c
@@ -50,6 +52,7 @@ set(SOURCES
 set(HEADERS
    PCU.h
    pcu_io.h
+   pcu_shm.h
    pcu_util.h
    noto/noto_malloc.h
    reel/reel.h)
@@ -65,4 +68,12 @@ if (PCU_COMPRESS)
   add_definitions(-DPCU_BZIP)
 endif (PCU_COMPRESS)
 
+if (PCU_ZSTD)
+  find_path(ZSTD_INCLUDE_DIR zstd.h)
+  find_library(ZSTD_LIBRARY zstd)
+  include_directories(${ZSTD_INCLUDE_DIR})
+  target_link_libraries(pcu ${ZSTD_LIBRARY})
+  add_definitions(-DPCU_ZSTD)
+endif (PCU_ZSTD)
+
 tribits_package_postprocess()
@@ -120,6 +120,7 @@ struct IntBC : public SimBC
     buf = AttributeInt_value(attribute);
     return &buf;
   }
+  virtual bool isConstant() { return true; }
   pAttributeInt attribute;
   double buf;
 };
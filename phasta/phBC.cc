@@ -12,6 +12,7 @@
 #include <sstream>
 #include <cstring>
 #include <gmi.h>
+#include <gmi_base.h>
 #include <pcu_util.h>
 
 namespace ph {
@@ -130,8 +131,11 @@ void loadModelAndBCs(ph::Input& in, gmi_model*& m, BCs& bcs)
   const char* attribfile = in.attributeFileName.c_str();
   /* loading the model */
   /* case 1: meshmodel */
-  if (gmi_has_ext(modelfile, "dmg"))
+  if (gmi_has_ext(modelfile, "dmg")) {
     m = gmi_load(modelfile);
+    if (in.nodeSharedModel)
+      gmi_base_share(m);
+  }
 #ifdef HAVE_SIMMETRIX
   /* cases 2: Simmetrix model (and possibly attributes) file */
   else if (gmi_has_ext(modelfile, "smd"))
@@ -153,6 +157,12 @@ void loadModelAndBCs(ph::Input& in, gmi_model*& m, BCs& bcs)
     lion_oprint(1,"\"%s\" and \"%s\" loaded in %f seconds\n", modelfile, attribfile, t1 - t0);
 }
 
+void unshareModel(ph::Input& in, gmi_model* m)
+{
+  if (in.nodeSharedModel && gmi_has_ext(in.modelFileName.c_str(), "dmg"))
+    gmi_base_unshare(m);
+}
+
 struct KnownBC
 {
   const char* name;
@@ -352,4 +362,131 @@ bool applySolutionBCs(gmi_model* gm, gmi_ent* ge,
       sizeof(solutionBCs) / sizeof(KnownBC), values, 0);
 }
 
+/* whether all the conditions that applyBC would
+   reach from ge have constant values */
+static bool reachesOnlyConstant(gmi_model* gm, gmi_ent* ge, FieldBCs& bcs)
+{
+  ConstantBC keyObj;
+  keyObj.tag = gmi_tag(gm, ge);
+  keyObj.dim = gmi_dim(gm, ge);
+  BC* key = &keyObj;
+  FieldBCs::Set::iterator it = bcs.bcs.find(key);
+  if (it != bcs.bcs.end())
+    return (*it)->isConstant();
+  bool allConstant = true;
+  gmi_set* up = gmi_adjacent(gm, ge, gmi_dim(gm, ge) + 1);
+  for (int i = 0; i < up->n; ++i)
+    if ( ! reachesOnlyConstant(gm, up->e[i], bcs)) {
+      allConstant = false;
+      break;
+    }
+  gmi_free_set(up);
+  return allConstant;
+}
+
+/* the fields read by applyVelocityConstaints
+   and applyElasticConstaints */
+static const char* const constraintNames[5] =
+{"comp3"
+,"comp1"
+,"DG interface"
+,"comp3_elas"
+,"comp1_elas"
+};
+
+static bool isConstantOn(gmi_model* gm, gmi_ent* ge, BCs& bcs,
+    CompiledBCs::Kind kind)
+{
+  std::vector<std::string> names;
+  if (kind == CompiledBCs::NATURAL)
+    for (size_t i = 0; i < sizeof(naturalBCs) / sizeof(KnownBC); ++i)
+      names.push_back(naturalBCs[i].name);
+  if (kind == CompiledBCs::ESSENTIAL) {
+    for (size_t i = 0; i < sizeof(essentialBCs) / sizeof(KnownBC); ++i)
+      names.push_back(essentialBCs[i].name);
+    for (int i = 0; i < 5; ++i)
+      names.push_back(constraintNames[i]);
+  }
+  if (kind == CompiledBCs::SOLUTION)
+    for (size_t i = 0; i < sizeof(solutionBCs) / sizeof(KnownBC); ++i)
+      names.push_back(solutionBCs[i].name);
+  for (size_t i = 0; i < names.size(); ++i)
+    if (haveBC(bcs, names[i]) &&
+        ! reachesOnlyConstant(gm, ge, bcs.fields[names[i]]))
+      return false;
+  return true;
+}
+
+static bool applyKind(gmi_model* gm, gmi_ent* ge, BCs& bcs,
+    CompiledBCs::Kind kind, apf::Vector3 const& x,
+    double* values, int* bits)
+{
+  if (kind == CompiledBCs::NATURAL)
+    return applyNaturalBCs(gm, ge, bcs, x, values, bits);
+  if (kind == CompiledBCs::ESSENTIAL)
+    return applyEssentialBCs(gm, ge, bcs, x, values, bits);
+  return applySolutionBCs(gm, ge, bcs, x, values);
+}
+
+CompiledBCs::CompiledBCs(gmi_model* gm, BCs& bcs, Kind k, int n):
+  model(gm),
+  conditions(&bcs),
+  kind(k),
+  nvalues(n)
+{
+  /* applying to arrays of zeros and of ones tells which
+     values were written: every apply function assigns,
+     and its override rules only look at the bits */
+  apf::NewArray<double> zeros(nvalues);
+  apf::NewArray<double> ones(nvalues);
+  apf::Vector3 x(0,0,0);
+  for (int dim = 0; dim <= 3; ++dim) {
+    gmi_iter* it = gmi_begin(gm, dim);
+    gmi_ent* ge;
+    while ((ge = gmi_next(gm, it))) {
+      int slot = slots.size();
+      slots[ge] = slot;
+      bool isConstant = isConstantOn(gm, ge, bcs, kind);
+      int zeroBits[2] = {0, 0};
+      int oneBits[2] = {0, 0};
+      for (int i = 0; i < nvalues; ++i) {
+        zeros[i] = 0;
+        ones[i] = 1;
+      }
+      bool didAny = false;
+      if (isConstant) {
+        didAny = applyKind(gm, ge, bcs, kind, x, &zeros[0], zeroBits);
+        applyKind(gm, ge, bcs, kind, x, &ones[0], oneBits);
+      }
+      constant.push_back(isConstant);
+      applied.push_back(didAny);
+      bits.push_back(zeroBits[0]);
+      bits.push_back(zeroBits[1]);
+      for (int i = 0; i < nvalues; ++i) {
+        values.push_back(zeros[i]);
+        written.push_back(isConstant && zeros[i] == ones[i]);
+      }
+    }
+    gmi_end(gm, it);
+  }
+}
+
+bool CompiledBCs::apply(gmi_ent* ge, apf::Vector3 const& x,
+    double* outValues, int* outBits) const
+{
+  std::map<gmi_ent*, int>::const_iterator it = slots.find(ge);
+  if (it == slots.end() || ! constant[it->second])
+    return applyKind(model, ge, *conditions, kind, x, outValues, outBits);
+  int slot = it->second;
+  for (int i = 0; i < nvalues; ++i)
+    if (written[slot * nvalues + i])
+      outValues[i] = values[slot * nvalues + i];
+  if (kind != SOLUTION)
+    outBits[0] |= bits[slot * 2];
+  /* only natural conditions carry the surface id */
+  if (kind == NATURAL)
+    outBits[1] |= bits[slot * 2 + 1];
+  return applied[slot];
+}
+
 }
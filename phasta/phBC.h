@@ -4,6 +4,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <apfVector.h>
 #include <gmi.h>
@@ -98,6 +99,8 @@ struct BC
   int tag;
   int dim;
   virtual double* eval(apf::Vector3 const& x) = 0;
+  /* whether eval gives the same values everywhere */
+  virtual bool isConstant() { return false; }
   bool operator<(const BC& other) const;
 };
 
@@ -106,6 +109,7 @@ struct ConstantBC : public BC
   ConstantBC();
   ~ConstantBC();
   virtual double* eval(apf::Vector3 const& x);
+  virtual bool isConstant() { return true; }
   double* value;
 };
 
@@ -129,6 +133,10 @@ struct BCs
 
 void readBCs(gmi_model* m, const char* attFile, bool axisymmetry, BCs& bcs);
 void loadModelAndBCs(ph::Input& in, gmi_model*& m, BCs& bcs);
+/* undoes the node sharing loadModelAndBCs did for
+   in.nodeSharedModel, so that the model can be destroyed
+   on any rank. collective over the ranks that loaded it */
+void unshareModel(ph::Input& in, gmi_model* m);
 
 bool applyNaturalBCs(gmi_model* gm, gmi_ent* ge,
     BCs& appliedBCs, apf::Vector3 const& x, double* values, int* bits);
@@ -137,6 +145,37 @@ bool applyEssentialBCs(gmi_model* gm, gmi_ent* ge,
 bool applySolutionBCs(gmi_model* gm, gmi_ent* ge,
     BCs& appliedBCs, apf::Vector3 const& x, double* values);
 
+/* one kind of conditions resolved once per model entity.
+   where every condition reachable from a model entity is
+   constant, the table holds what applying them to zeroed
+   arrays gives, so mesh entities classified on it only
+   copy that in. other model entities fall back to applying
+   the conditions at x. lookups only read the table, so the
+   constant entries can be applied from several threads */
+struct CompiledBCs
+{
+  enum Kind { NATURAL, ESSENTIAL, SOLUTION };
+  /* nvalues is the length of the value arrays given to apply */
+  CompiledBCs(gmi_model* gm, BCs& bcs, Kind kind, int nvalues);
+  /* same contract as the applyNaturalBCs, applyEssentialBCs
+     and applySolutionBCs counterparts; bits is unused
+     for SOLUTION */
+  bool apply(gmi_ent* ge, apf::Vector3 const& x,
+      double* values, int* bits) const;
+  gmi_model* model;
+  BCs* conditions;
+  Kind kind;
+  int nvalues;
+  std::map<gmi_ent*, int> slots;
+  /* per slot */
+  std::vector<char> constant;
+  std::vector<char> applied;
+  std::vector<int> bits;
+  /* per slot and value */
+  std::vector<double> values;
+  std::vector<char> written;
+};
+
 bool applyVelocityConstaints(gmi_model* gm, BCs& bcs, gmi_ent* e,
     apf::Vector3 const& x, double* BC, int* iBC);
 
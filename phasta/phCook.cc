@@ -15,6 +15,7 @@
 #include <phPartition.h>
 #include <phFilterMatching.h>
 #include "phInterfaceCutter.h"
+#include "phMPIIO.h"
 #include "phiotimer.h" //for phastaio_initStats and phastaio_printStats
 #include <parma.h>
 #include <apfMDS.h>
@@ -97,14 +98,20 @@ void originalMain(apf::Mesh2*& m, ph::Input& in,
 }//end namespace
 
 namespace chef {
-  static FILE* openfile_read(ph::Input&, const char* path) {
+  /* with parts sharing files, the open and close of the
+     shared file are timed inside phMPIIO.cc */
+  static FILE* openfile_read(ph::Input& in, const char* path) {
     FILE* f = NULL;
+    if (in.partsPerFile)
+      return ph_mpiio_open_read(path, in.partsPerFile);
     PHASTAIO_OPENTIME(f = pcu_group_open(path, false);)
     return f;
   }
 
-  static FILE* openfile_write(ph::Output&, const char* path) {
+  static FILE* openfile_write(ph::Output& out, const char* path) {
     FILE* f = NULL;
+    if (out.in->partsPerFile)
+      return ph_mpiio_open_write(path, out.in->partsPerFile);
     PHASTAIO_OPENTIME(f = pcu_group_open(path, true);)
     return f;
   }
@@ -242,6 +249,7 @@ namespace chef {
       m = repeatMdsMesh(m, g, plan, in.splitFactor);
     ph::checkBalance(m,in);
     ph::preprocess(m,in,out,bcs);
+    ph::unshareModel(in, g);
   }
   void cook(gmi_model*& g, apf::Mesh2*& m) {
     ph::Input in;
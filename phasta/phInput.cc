@@ -73,6 +73,8 @@ static void setDefaults(Input& in)
   in.adaptShrinkLimit = 10000;
   in.validQuality = 1.0e-10;
   in.printIOtime = 0;
+  in.partsPerFile = 0;
+  in.nodeSharedModel = 0;
   in.mesh2geom = 0;
   in.alphaDist = 1e-6;
   in.alphaSize = 1e-5;
@@ -160,6 +162,8 @@ static void formMaps(Input& in, StringMap& stringMap, IntMap& intMap, DblMap& db
   intMap["simmetrixMesh"] = &in.simmetrixMesh;
   intMap["maxAdaptIterations"] = &in.maxAdaptIterations;
   intMap["printIOtime"] = &in.printIOtime;
+  intMap["partsPerFile"] = &in.partsPerFile;
+  intMap["nodeSharedModel"] = &in.nodeSharedModel;
   intMap["mesh2geom"] = &in.mesh2geom;
   dblMap["alphaDist"] = &in.alphaDist;
   dblMap["alphaSize"] = &in.alphaSize;
@@ -247,6 +251,10 @@ static void validate(Input& in)
   PCU_ALWAYS_ASSERT(in.elementImbalance > 1.0 && in.elementImbalance <= 2.0);
   PCU_ALWAYS_ASSERT(in.vertexImbalance > 1.0 && in.vertexImbalance <= 2.0);
   PCU_ALWAYS_ASSERT( ! (in.buildMapping && in.adaptFlag));
+#ifdef __APPLE__
+  if (in.partsPerFile)
+    fail("partsPerFile is not available on Apple, set it to zero");
+#endif
 }
 
 void Input::load(const char* filename)
@@ -48,8 +48,8 @@ class Input
     /** \brief path to the directory that includes the input mesh
         \details the path to the SCOREC MDS mesh must end with a '/' if it is a
        directory containing multiple '<partid>.smb' files. This path
-       can also be prepended by "bz2:" to tell the mesh file reader that the
-       files have been compressed. */
+       can also be prepended by "bz2:" or "zst:" to tell the mesh file
+       reader that the files have been compressed with bzip2 or zstd. */
     std::string meshFileName;
     /** \brief output mesh file name, see meshFileName */
     std::string outMeshFileName;
@@ -167,6 +167,20 @@ class Input
     double adaptShrinkLimit;
     /** \brief report the time spent in IO */
     int printIOtime;
+    /** \brief the number of consecutive parts sharing each geombc and
+        restart file.
+        \details zero writes one file per part. otherwise chef
+       writes and reads the shared files with collective MPI-IO,
+       see phMPIIO.h. chef can then read only restarts that it
+       wrote itself, not the grouped restarts the solver writes,
+       so set it to zero to read solver output. not available on
+       Apple */
+    int partsPerFile;
+    /** \brief keep one copy of the model topology per compute node
+        \details only .dmg models; see gmi_base_share.
+       chef goes back to one copy per rank once it is done, so
+       the model it returns can be destroyed on any rank */
+    int nodeSharedModel;
     /** \brief flag of writing m2g fields to geomBC files */
     int mesh2geom;
     /** \brief closest distance from zero level set for banded refinement */
@@ -0,0 +1,294 @@
+#include <PCU.h>
+#include <pcu_util.h>
+#include <lionPrint.h>
+#include "phMPIIO.h"
+#include "phIO.h"
+#include "phiotimer.h"
+#include <mpi.h>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef __APPLE__
+namespace {
+
+struct Group
+{
+  Group(int partsPerFile)
+  {
+    PCU_ALWAYS_ASSERT(partsPerFile > 0);
+    int self = PCU_Comm_Self();
+    index = self / partsPerFile;
+    first = index * partsPerFile;
+    MPI_Comm_split(PCU_Get_Comm(), index, self, &comm);
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+  }
+  ~Group()
+  {
+    MPI_Comm_free(&comm);
+  }
+  int index;
+  int first;
+  int rank;
+  int size;
+  MPI_Comm comm;
+};
+
+/* drops the part number that ends per-part file names */
+std::string getSharedName(std::string const& path, Group const& g)
+{
+  std::stringstream suffix;
+  suffix << '.' << PCU_Comm_Self() + 1;
+  std::string s = suffix.str();
+  std::string stem = path;
+  if (stem.size() > s.size() &&
+      !stem.compare(stem.size() - s.size(), s.size(), s))
+    stem.erase(stem.size() - s.size());
+  std::stringstream ss;
+  ss << stem << ".shared." << g.index + 1;
+  return ss.str();
+}
+
+const char* const offsetsName = "part offsets";
+
+/* the same bytes as ph_write_field, without counting
+   them as a part's write */
+std::string formatIndex(Group const& g, double* offsets)
+{
+  char* data = 0;
+  size_t size = 0;
+  FILE* f = open_memstream(&data, &size);
+  PCU_ALWAYS_ASSERT(f);
+  ph_write_preamble(f);
+  int params[3] = {g.size + 1, 1, g.first};
+  size_t n = g.size + 1;
+  ph_write_header(f, offsetsName, n * sizeof(double) + 1, 3, params);
+  fwrite(offsets, sizeof(double), n, f);
+  fprintf(f, "\n");
+  fclose(f);
+  std::string index(data, size);
+  free(data);
+  return index;
+}
+
+void readIndex(MPI_File file, Group const& g, double* offsets)
+{
+  std::vector<double> zeros(g.size + 1, 0);
+  MPI_Offset fileSize;
+  MPI_File_get_size(file, &fileSize);
+  MPI_Offset size = formatIndex(g, &zeros[0]).size();
+  PCU_ALWAYS_ASSERT(size <= fileSize);
+  std::vector<char> head(size);
+  MPI_File_read_at(file, 0, &head[0], size, MPI_BYTE, MPI_STATUS_IGNORE);
+  FILE* f = fmemopen(&head[0], size, "r");
+  PCU_ALWAYS_ASSERT(f);
+  int swap = ph_should_swap(f);
+  double* data = 0;
+  int nodes, vars, step;
+  char name[1024];
+  int ok = ph_read_field(f, offsetsName, swap,
+      &data, &nodes, &vars, &step, name);
+  fclose(f);
+  if (ok != 2 || nodes != g.size + 1 || vars != 1 || step != g.first) {
+    lion_eprint(1, "shared file index for parts %d to %d does not match\n",
+        g.first, g.first + g.size - 1);
+    abort();
+  }
+  for (int i = 0; i <= g.size; ++i)
+    offsets[i] = data[i];
+  free(data);
+}
+
+/* MPI counts are ints, so a part moves its bytes as a count
+   of blocks and then the rest. both calls are collective */
+const int blockSize = 1 << 20;
+
+void moveAll(MPI_File file, MPI_Offset at, char* data, size_t size,
+    bool write)
+{
+  MPI_Datatype block;
+  MPI_Type_contiguous(blockSize, MPI_BYTE, &block);
+  MPI_Type_commit(&block);
+  size_t blocks = size / blockSize;
+  PCU_ALWAYS_ASSERT(blocks <= INT_MAX);
+  int rest = size % blockSize;
+  char* tail = data ? data + blocks * blockSize : 0;
+  MPI_Offset tailAt = at + (MPI_Offset)blocks * blockSize;
+  if (write) {
+    MPI_File_write_at_all(file, at, data, blocks, block, MPI_STATUS_IGNORE);
+    MPI_File_write_at_all(file, tailAt, tail, rest, MPI_BYTE,
+        MPI_STATUS_IGNORE);
+  } else {
+    MPI_File_read_at_all(file, at, data, blocks, block, MPI_STATUS_IGNORE);
+    MPI_File_read_at_all(file, tailAt, tail, rest, MPI_BYTE,
+        MPI_STATUS_IGNORE);
+  }
+  MPI_Type_free(&block);
+}
+
+void writeShared(std::string const& path, int partsPerFile,
+    std::string& data)
+{
+  Group g(partsPerFile);
+  std::string name = getSharedName(path, g);
+  long size = data.size();
+  std::vector<long> sizes(g.size);
+  MPI_Gather(&size, 1, MPI_LONG, &sizes[0], 1, MPI_LONG, 0, g.comm);
+  std::vector<double> offsets(g.size + 1, 0);
+  if (!g.rank) {
+    offsets[0] = formatIndex(g, &offsets[0]).size();
+    for (int i = 0; i < g.size; ++i)
+      offsets[i + 1] = offsets[i] + sizes[i];
+  }
+  MPI_Bcast(&offsets[0], g.size + 1, MPI_DOUBLE, 0, g.comm);
+  MPI_File file;
+  int err;
+  PHASTAIO_OPENTIME(err = MPI_File_open(g.comm, name.c_str(),
+        MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file);)
+  if (err != MPI_SUCCESS) {
+    lion_eprint(1, "failed to open \"%s\"!\n", name.c_str());
+    abort();
+  }
+  MPI_File_set_size(file, 0);
+  if (!g.rank) {
+    std::string index = formatIndex(g, &offsets[0]);
+    MPI_File_write_at(file, 0, &index[0], index.size(), MPI_BYTE,
+        MPI_STATUS_IGNORE);
+  }
+  char* buf = size ? &data[0] : 0;
+  PHASTAIO_SHAREDWRITETIME(
+      moveAll(file, (MPI_Offset)offsets[g.rank], buf, size, true);, size)
+  PHASTAIO_CLOSETIME(MPI_File_close(&file);)
+}
+
+struct Writer
+{
+  std::string path;
+  int partsPerFile;
+  std::string data;
+};
+
+ssize_t writeToBuffer(void* cookie, const char* buf, size_t size)
+{
+  Writer* w = static_cast<Writer*>(cookie);
+  w->data.append(buf, size);
+  return size;
+}
+
+int closeWriter(void* cookie)
+{
+  Writer* w = static_cast<Writer*>(cookie);
+  writeShared(w->path, w->partsPerFile, w->data);
+  delete w;
+  return 0;
+}
+
+struct Reader
+{
+  std::vector<char> data;
+  size_t at;
+};
+
+ssize_t readFromBuffer(void* cookie, char* buf, size_t size)
+{
+  Reader* r = static_cast<Reader*>(cookie);
+  size_t n = r->data.size() - r->at;
+  if (size < n)
+    n = size;
+  if (n)
+    memcpy(buf, &r->data[r->at], n);
+  r->at += n;
+  return n;
+}
+
+int seekBuffer(void* cookie, off64_t* offset, int whence)
+{
+  Reader* r = static_cast<Reader*>(cookie);
+  off64_t at = *offset;
+  if (whence == SEEK_CUR)
+    at += r->at;
+  else if (whence == SEEK_END)
+    at += r->data.size();
+  if (at < 0 || at > (off64_t)r->data.size())
+    return -1;
+  r->at = at;
+  *offset = at;
+  return 0;
+}
+
+int closeReader(void* cookie)
+{
+  delete static_cast<Reader*>(cookie);
+  return 0;
+}
+
+}
+#endif
+
+#ifdef __APPLE__
+/* there is no fopencookie to give parts a FILE* over their
+   piece of the shared file */
+static void failOnApple()
+{
+  lion_eprint(1, "partsPerFile is not available on Apple, "
+      "set it to zero to write one file per part\n");
+  abort();
+}
+
+FILE* ph_mpiio_open_write(const char*, int) {
+  failOnApple();
+  return NULL;
+}
+
+FILE* ph_mpiio_open_read(const char*, int) {
+  failOnApple();
+  return NULL;
+}
+#else
+FILE* ph_mpiio_open_write(const char* path, int partsPerFile) {
+  Writer* w = new Writer();
+  w->path = path;
+  w->partsPerFile = partsPerFile;
+  cookie_io_functions_t io;
+  io.read = 0;
+  io.write = writeToBuffer;
+  io.seek = 0;
+  io.close = closeWriter;
+  return fopencookie(w, "w", io);
+}
+
+FILE* ph_mpiio_open_read(const char* path, int partsPerFile) {
+  Group g(partsPerFile);
+  std::string name = getSharedName(path, g);
+  MPI_File file;
+  int err;
+  PHASTAIO_OPENTIME(err = MPI_File_open(g.comm, name.c_str(),
+        MPI_MODE_RDONLY, MPI_INFO_NULL, &file);)
+  if (err != MPI_SUCCESS) {
+    lion_eprint(1, "failed to open \"%s\"!\n", name.c_str());
+    abort();
+  }
+  std::vector<double> offsets(g.size + 1);
+  if (!g.rank)
+    readIndex(file, g, &offsets[0]);
+  MPI_Bcast(&offsets[0], g.size + 1, MPI_DOUBLE, 0, g.comm);
+  size_t size = offsets[g.rank + 1] - offsets[g.rank];
+  Reader* r = new Reader();
+  r->data.resize(size);
+  r->at = 0;
+  char* buf = size ? &r->data[0] : 0;
+  PHASTAIO_SHAREDREADTIME(
+      moveAll(file, (MPI_Offset)offsets[g.rank], buf, size, false);, size)
+  PHASTAIO_CLOSETIME(MPI_File_close(&file);)
+  cookie_io_functions_t io;
+  io.read = readFromBuffer;
+  io.write = 0;
+  io.seek = seekBuffer;
+  io.close = closeReader;
+  return fopencookie(r, "r", io);
+}
+#endif
@@ -0,0 +1,42 @@
+#ifndef PH_MPIIO_H
+#define PH_MPIIO_H
+#include <stdio.h>
+
+/** \file phMPIIO.h
+    \brief geombc and restart files shared by groups of parts
+    \details Each group of partsPerFile consecutive parts shares one
+             file, so a run opens a few files instead of one per part.
+             A part still writes and reads its own PHASTA POSIX file
+             through a FILE*, which lives in memory; the group moves
+             all of its parts' files with one collective MPI-IO call.
+
+             The shared file for "geombc.dat.3" on part 2 with four
+             parts per file is "geombc.dat.shared.1". It starts with
+             a PHASTA POSIX preamble and a "part offsets" field of
+             n + 1 values for its n parts, whose step parameter is
+             the first part, so ph_should_swap and ph_read_field can
+             read it. Part i's file spans offsets i to i + 1.
+             The timing goes to the phiotimer shared counters.
+    \remark Opening for reading and closing after writing are
+            collective over all parts. A part's file may be larger
+            than 2GB. Not available on Apple, where both functions
+            fail. The PHASTA solver groups its files differently,
+            so these read only files written here.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief open this part's file at path for writing;
+           fclose writes it into its group's shared file */
+FILE* ph_mpiio_open_write(const char* path, int partsPerFile);
+/** @brief read this part's file at path from its group's
+           shared file and open it for reading */
+FILE* ph_mpiio_open_read(const char* path, int partsPerFile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
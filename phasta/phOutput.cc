@@ -236,6 +236,7 @@ static void getBoundary(Output& o, BCs& bcs, apf::Numbering* n)
   int*** ibcb = new int**[bs.getSize()];
   double*** bcb = new double**[bs.getSize()];
   apf::NewArray<int> js(bs.getSize());
+  CompiledBCs natural(gm, bcs, CompiledBCs::NATURAL, nbc);
   for (int i = 0; i < bs.getSize(); ++i) {
     ienb[i]     = new int*[bs.nElements[i]];
     if (mattypeb)
@@ -276,7 +277,7 @@ static void getBoundary(Output& o, BCs& bcs, apf::Numbering* n)
     bcb[i][j] = new double[nbc]();
     ibcb[i][j] = new int[2](); /* <- parens initialize to zero */
     apf::Vector3 x = apf::getLinearCentroid(m, f);
-    applyNaturalBCs(gm, gf, bcs, x, bcb[i][j], ibcb[i][j]);
+    natural.apply(gf, x, bcb[i][j], ibcb[i][j]);
 
     /* get material type */
     if (mattypeb) {
@@ -693,6 +694,7 @@ static void getEssentialBCs(BCs& bcs, Output& o)
   int nec = countEssentialBCs(in);
   double* bc = new double[nec]();
   gmi_model* gm = m->getModel();
+  CompiledBCs essential(gm, bcs, CompiledBCs::ESSENTIAL, nec);
   int i = 0;
   int& ei = o.nEssentialBCNodes;
   apf::MeshEntity* v;
@@ -705,7 +707,7 @@ static void getEssentialBCs(BCs& bcs, Output& o)
     for (int j = 0; j < nec; ++j)
       bc[j] = 0;
     //bool hasBC = applyEssentialBCs(gm, ge, bcs, x, bc, &ibc) && bcs.fields.count("material type");
-    bool hasBC = applyEssentialBCs(gm, ge, bcs, x, bc, &ibc);
+    bool hasBC = essential.apply(ge, x, bc, &ibc);
     /* matching introduces an iper bit */
     /* which is set for all slaves */
     if (isMatchingSlave(ms, v)) {
@@ -855,6 +857,7 @@ static void getInitialConditions(BCs& bcs, Output& o)
   apf::MeshIterator* it = m->begin(3);
   apf::MeshEntity* e;
   gmi_model* gm = m->getModel();
+  CompiledBCs solution(gm, bcs, CompiledBCs::SOLUTION, in.ensa_dof);
   while ((e = m->iterate(it))) {
     gmi_ent* ge = (gmi_ent*)m->toModel(e);
     apf::Downward v;
@@ -863,7 +866,7 @@ static void getInitialConditions(BCs& bcs, Output& o)
       apf::getComponents(f, v[i], 0, &s[0]);
       apf::Vector3 x;
       m->getPoint(v[i], 0, x);
-      applySolutionBCs(gm, ge, bcs, x, &s[0]);
+      solution.apply(ge, x, &s[0], 0);
       apf::setComponents(f, v[i], 0, &s[0]);
     }
   }
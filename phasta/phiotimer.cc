@@ -22,6 +22,12 @@ struct phastaio_stats {
   size_t closeTime[NUM_PHASTAIO_MODES];
   size_t opens[NUM_PHASTAIO_MODES];
   size_t closes[NUM_PHASTAIO_MODES];
+  size_t sharedReadTime[NUM_PHASTAIO_MODES];
+  size_t sharedWriteTime[NUM_PHASTAIO_MODES];
+  size_t sharedReadBytes[NUM_PHASTAIO_MODES];
+  size_t sharedWriteBytes[NUM_PHASTAIO_MODES];
+  size_t sharedReads[NUM_PHASTAIO_MODES];
+  size_t sharedWrites[NUM_PHASTAIO_MODES];
   int fileIdx;
 };
 static struct phastaio_stats phastaio_global_stats;
@@ -113,6 +119,28 @@ void phastaio_addWriteTime(size_t t) {
   phastaio_global_stats.writes[i]++;
 }
 
+void phastaio_addSharedReadBytes(size_t b) {
+  const int i = phastaio_global_stats.fileIdx;
+  phastaio_global_stats.sharedReadBytes[i] += b;
+}
+
+void phastaio_addSharedWriteBytes(size_t b) {
+  const int i = phastaio_global_stats.fileIdx;
+  phastaio_global_stats.sharedWriteBytes[i] += b;
+}
+
+void phastaio_addSharedReadTime(size_t t) {
+  const int i = phastaio_global_stats.fileIdx;
+  phastaio_global_stats.sharedReadTime[i] += t;
+  phastaio_global_stats.sharedReads[i]++;
+}
+
+void phastaio_addSharedWriteTime(size_t t) {
+  const int i = phastaio_global_stats.fileIdx;
+  phastaio_global_stats.sharedWriteTime[i] += t;
+  phastaio_global_stats.sharedWrites[i]++;
+}
+
 void phastaio_setfile(int f) {
   char msg[64]; sprintf(msg, "f %d", f);
   PCU_ALWAYS_ASSERT_VERBOSE(f >= 0 && f < NUM_PHASTAIO_MODES, msg);
@@ -164,6 +192,16 @@ static void printMinMaxAvgDbl(const char* key, double v) {
         getFileName(), key, min, max, avg);
 }
 
+/* the bytes moved by all ranks over the time of the slowest rank,
+   which is what a collective operation delivers */
+static void printAggregateBandwidth(const char* key, size_t bytes, size_t us) {
+  size_t totalBytes = PCU_Add_SizeT(bytes);
+  size_t maxUs = PCU_Max_SizeT(us);
+  if(!PCU_Comm_Self() && maxUs)
+    lion_eprint(1, "%s_%s %f\n", getFileName(), key,
+        ((double)totalBytes)/maxUs);
+}
+
 static size_t phastaio_getReadTime() {
   const int i = phastaio_global_stats.fileIdx;
   return phastaio_global_stats.readTime[i];
@@ -194,6 +232,36 @@ static size_t phastaio_getWrites() {
   return phastaio_global_stats.writes[i];
 }
 
+static size_t phastaio_getSharedReadTime() {
+  const int i = phastaio_global_stats.fileIdx;
+  return phastaio_global_stats.sharedReadTime[i];
+}
+
+static size_t phastaio_getSharedWriteTime() {
+  const int i = phastaio_global_stats.fileIdx;
+  return phastaio_global_stats.sharedWriteTime[i];
+}
+
+static size_t phastaio_getSharedReadBytes() {
+  const int i = phastaio_global_stats.fileIdx;
+  return phastaio_global_stats.sharedReadBytes[i];
+}
+
+static size_t phastaio_getSharedWriteBytes() {
+  const int i = phastaio_global_stats.fileIdx;
+  return phastaio_global_stats.sharedWriteBytes[i];
+}
+
+static size_t phastaio_getSharedReads() {
+  const int i = phastaio_global_stats.fileIdx;
+  return phastaio_global_stats.sharedReads[i];
+}
+
+static size_t phastaio_getSharedWrites() {
+  const int i = phastaio_global_stats.fileIdx;
+  return phastaio_global_stats.sharedWrites[i];
+}
+
 static size_t phastaio_getOpens() {
   const int i = phastaio_global_stats.fileIdx;
   return phastaio_global_stats.opens[i];
@@ -258,6 +326,35 @@ void phastaio_printStats() {
       printMinMaxAvgDbl("writeBandwidth (MB/s)",
           ((double)phastaio_getWriteBytes())/phastaio_getWriteTime());
     }
+    /* with shared files the reads and writes above only
+       move data between memory and a part's stream */
+    int sharedReads = PCU_Max_Int((int)phastaio_getSharedReads());
+    if(sharedReads) {
+      totalus += phastaio_getSharedReadTime();
+      totalbytes += phastaio_getSharedReadBytes();
+      printMinMaxAvgSzt("sharedReads", phastaio_getSharedReads());
+      printMinMaxAvgSzt("sharedReadTime (us)", phastaio_getSharedReadTime());
+      printMinMaxAvgSzt("sharedReadBytes (B)", phastaio_getSharedReadBytes());
+      printMinMaxAvgDbl("sharedReadBandwidth (MB/s)",
+          ((double)phastaio_getSharedReadBytes())/
+          phastaio_getSharedReadTime());
+      printAggregateBandwidth("sharedReadAggregateBandwidth (MB/s)",
+          phastaio_getSharedReadBytes(), phastaio_getSharedReadTime());
+    }
+    int sharedWrites = PCU_Max_Int((int)phastaio_getSharedWrites());
+    if(sharedWrites) {
+      totalus += phastaio_getSharedWriteTime();
+      totalbytes += phastaio_getSharedWriteBytes();
+      printMinMaxAvgSzt("sharedWrites", phastaio_getSharedWrites());
+      printMinMaxAvgSzt("sharedWriteTime (us)", phastaio_getSharedWriteTime());
+      printMinMaxAvgSzt("sharedWriteBytes (B)",
+          phastaio_getSharedWriteBytes());
+      printMinMaxAvgDbl("sharedWriteBandwidth (MB/s)",
+          ((double)phastaio_getSharedWriteBytes())/
+          phastaio_getSharedWriteTime());
+      printAggregateBandwidth("sharedWriteAggregateBandwidth (MB/s)",
+          phastaio_getSharedWriteBytes(), phastaio_getSharedWriteTime());
+    }
     int opens = PCU_Max_Int((int)phastaio_getOpens());
     if(opens) {
       totalus += phastaio_getOpenTime();
@@ -296,5 +393,11 @@ void phastaio_initStats() {
     phastaio_global_stats.closeTime[i] = 0;
     phastaio_global_stats.opens[i] = 0;
     phastaio_global_stats.closes[i] = 0;
+    phastaio_global_stats.sharedReadTime[i] = 0;
+    phastaio_global_stats.sharedWriteTime[i] = 0;
+    phastaio_global_stats.sharedReadBytes[i] = 0;
+    phastaio_global_stats.sharedWriteBytes[i] = 0;
+    phastaio_global_stats.sharedReads[i] = 0;
+    phastaio_global_stats.sharedWrites[i] = 0;
   }
 }
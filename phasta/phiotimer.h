@@ -29,6 +29,26 @@ extern "C" {
     phastaio_addWriteBytes(bytes);\
 }
 
+#define PHASTAIO_SHAREDREADTIME(cmd,bytes) {\
+    phastaioTime t0,t1;\
+    phastaio_time(&t0);\
+    cmd\
+    phastaio_time(&t1);\
+    const size_t time = phastaio_time_diff(&t0,&t1);\
+    phastaio_addSharedReadTime(time);\
+    phastaio_addSharedReadBytes(bytes);\
+}
+
+#define PHASTAIO_SHAREDWRITETIME(cmd,bytes) {\
+    phastaioTime t0,t1;\
+    phastaio_time(&t0);\
+    cmd\
+    phastaio_time(&t1);\
+    const size_t time = phastaio_time_diff(&t0,&t1);\
+    phastaio_addSharedWriteTime(time);\
+    phastaio_addSharedWriteBytes(bytes);\
+}
+
 #define PHASTAIO_OPENTIME(cmd) {\
     phastaioTime t0,t1;\
     phastaio_time(&t0);\
@@ -76,6 +96,14 @@ void phastaio_addWriteBytes(size_t b);
 void phastaio_addReadTime(size_t t);
 /* \brief accumulate time writing */
 void phastaio_addWriteTime(size_t t);
+/* \brief accumulate bytes read from shared files with MPI-IO */
+void phastaio_addSharedReadBytes(size_t b);
+/* \brief accumulate bytes written to shared files with MPI-IO */
+void phastaio_addSharedWriteBytes(size_t b);
+/* \brief accumulate time reading shared files with MPI-IO */
+void phastaio_addSharedReadTime(size_t t);
+/* \brief accumulate time writing shared files with MPI-IO */
+void phastaio_addSharedWriteTime(size_t t);
 /* \brief accumulate time opening */
 void phastaio_addOpenTime(size_t t);
 /* \brief accumulate time closing */
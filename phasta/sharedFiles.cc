@@ -0,0 +1,107 @@
+#include <PCU.h>
+#include <pcu_util.h>
+#include <lionPrint.h>
+#include "phMPIIO.h"
+#include "phIO.h"
+#include "phiotimer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* every part writes a restart-like file of a different size
+   through ph_mpiio_open_write, then reads it back through
+   ph_mpiio_open_read, with groups that do and do not divide
+   the number of parts */
+
+static std::string getPath(int partsPerFile)
+{
+  std::stringstream ss;
+  ss << "sharedFiles" << partsPerFile << ".dat." << PCU_Comm_Self() + 1;
+  return ss.str();
+}
+
+static double getValue(int i)
+{
+  return PCU_Comm_Self() * 1e6 + i * 0.5;
+}
+
+/* the higher parts write more than one MPI-IO block */
+static int countNodes()
+{
+  return 40000 * PCU_Comm_Self() + 7;
+}
+
+static void write(int partsPerFile)
+{
+  phastaio_setfile(RESTART_WRITE);
+  FILE* f = ph_mpiio_open_write(getPath(partsPerFile).c_str(),
+      partsPerFile);
+  PCU_ALWAYS_ASSERT(f);
+  ph_write_preamble(f);
+  int nodes = countNodes();
+  ph_write_header(f, "number of modes", 0, 1, &nodes);
+  std::vector<double> values(nodes * 2);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = getValue(i);
+  ph_write_field(f, "solution", &values[0], nodes, 2, PCU_Comm_Self());
+  fclose(f);
+}
+
+static long read(int partsPerFile)
+{
+  phastaio_setfile(RESTART_READ);
+  FILE* f = ph_mpiio_open_read(getPath(partsPerFile).c_str(),
+      partsPerFile);
+  PCU_ALWAYS_ASSERT(f);
+  int swap = ph_should_swap(f);
+  double* data = 0;
+  int nodes, vars, step;
+  char name[1024];
+  int ok = ph_read_field(f, "solution", swap,
+      &data, &nodes, &vars, &step, name);
+  fclose(f);
+  PCU_ALWAYS_ASSERT(ok == 2);
+  PCU_ALWAYS_ASSERT(nodes == countNodes());
+  PCU_ALWAYS_ASSERT(vars == 2);
+  PCU_ALWAYS_ASSERT(step == PCU_Comm_Self());
+  long bad = 0;
+  for (int i = 0; i < nodes * vars; ++i)
+    if (data[i] != getValue(i))
+      ++bad;
+  free(data);
+  return PCU_Add_Long(bad);
+}
+
+static void removeShared(int partsPerFile)
+{
+  PCU_Barrier();
+  if (PCU_Comm_Self())
+    return;
+  int files = (PCU_Comm_Peers() + partsPerFile - 1) / partsPerFile;
+  for (int i = 0; i < files; ++i) {
+    std::stringstream ss;
+    ss << "sharedFiles" << partsPerFile << ".dat.shared." << i + 1;
+    PCU_ALWAYS_ASSERT(!remove(ss.str().c_str()));
+  }
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  phastaio_initStats();
+  for (int partsPerFile = 1; partsPerFile <= 3; ++partsPerFile) {
+    write(partsPerFile);
+    long bad = read(partsPerFile);
+    if (!PCU_Comm_Self())
+      lion_oprint(1, "%d parts per file: %ld values differ\n",
+          partsPerFile, bad);
+    PCU_ALWAYS_ASSERT(bad == 0);
+    removeShared(partsPerFile);
+  }
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -15,6 +15,7 @@
 #include "GenIterator.h"
 #include "mPartEntityContainer.h"
 #include "apf.h"
+#include <map>
 
 enum PUMI_EntTopology {
   PUMI_VERTEX, // 0 
@@ -37,6 +38,10 @@ enum PUMI_FieldType {
 };
 class gEntity;
 class mPartEntityContainer;
+class GhostLayers;
+namespace apf {
+class NodeSynchronizer;
+}
 
 class gModel : public TagHolder
 {
@@ -100,6 +105,10 @@ public:
   pMeshTag ghost_tag;
   std::vector<pMeshEnt> ghost_vec[4];
   std::vector<pMeshEnt> ghosted_vec[4];
+  // exchange plans of pumi_field_synchronizeCached
+  std::map<pField, apf::NodeSynchronizer*> sync_plans;
+  // per-bridge layers of pumi_ghost_updateLayer, kept between updates
+  GhostLayers* ghost_layers;
 };
 
 //************************************
@@ -358,6 +367,20 @@ void pumi_ghost_create(pMesh m, Ghosting* plan);
 
 void pumi_ghost_delete (pMesh m);
 
+/* 
+input: same as pumi_ghost_createLayer
+brings the ghost layers to those pumi_ghost_createLayer makes on the mesh without ghosts.
+ghost copies still in the layers are kept, missing ones are created, and the others are deleted,
+so only the layers around changed bridges cost messages and mesh changes. 
+the layers each bridge grew are kept, and the next update with the same input grows 
+them again only for bridges that mesh changes or new remote copies reach.
+with numLayer 0, all ghost copies are deleted.
+owned entities with ghost copies must not be destroyed before the update.
+*/
+void pumi_ghost_updateLayer (pMesh m, int brgType, int ghostType, int numLayer, int includeCopy);
+// delete the layers kept by pumi_ghost_updateLayer. pumi_ghost_delete and pumi_mesh_delete call it
+void pumi_ghost_deleteLayers();
+
 //************************************
 // MISCELLANEOUS
 //************************************
@@ -522,6 +545,12 @@ pNumbering pumi_field_getNumbering(pField f);
 
 void pumi_field_delete(pField f);
 void pumi_field_synchronize(pField f, pOwnership o=NULL);
+// same as pumi_field_synchronize with the default ownership, through an exchange plan 
+// made on the first call and kept per field. ghosting and migration delete the plans; 
+// call pumi_field_deleteSyncPlan after other mesh changes
+void pumi_field_synchronizeCached(pField f);
+// delete the exchange plan of a field, or of all fields if f is NULL
+void pumi_field_deleteSyncPlan(pField f=NULL);
 void pumi_field_accumulate(pField f, pOwnership o=NULL);
 void pumi_field_freeze(pField f);
 void pumi_field_unfreeze(pField f);
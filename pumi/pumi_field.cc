@@ -12,6 +12,7 @@
 #include "apfShape.h"
 #include "apfFieldData.h"
 #include "apfNumbering.h"
+#include "apfNodeSync.h"
 #include <pcu_util.h>
 #include <PCU.h>
 #include <lionPrint.h>
@@ -126,6 +127,7 @@ pNumbering pumi_field_getNumbering (pField f)
 
 void pumi_field_delete(pField f)
 {
+  pumi_field_deleteSyncPlan(f);
   apf::destroyField(f);
 }
 
@@ -134,6 +136,31 @@ void pumi_field_synchronize(pField f, pOwnership o)
   apf::synchronizeFieldData<double>(f->getData(), o, false);
 }
 
+void pumi_field_synchronizeCached(pField f)
+{
+  std::map<pField, apf::NodeSynchronizer*>& plans = pumi::instance()->sync_plans;
+  std::map<pField, apf::NodeSynchronizer*>::iterator it = plans.find(f);
+  if (it==plans.end())
+    it = plans.insert(std::make_pair(f, new apf::NodeSynchronizer(f))).first;
+  it->second->run();
+}
+
+void pumi_field_deleteSyncPlan(pField f)
+{
+  std::map<pField, apf::NodeSynchronizer*>& plans = pumi::instance()->sync_plans;
+  std::map<pField, apf::NodeSynchronizer*>::iterator it = plans.begin();
+  while (it!=plans.end())
+  {
+    if (f && it->first!=f)
+    {
+      ++it;
+      continue;
+    }
+    delete it->second;
+    plans.erase(it++);
+  }
+}
+
 void pumi_field_accumulate(pField f, pOwnership o)
 { 
   apf::accumulate(f, o, false);
@@ -14,6 +14,7 @@
 #include <PCU.h>
 #include <map>
 #include <set>
+#include <algorithm>
 #include <pcu_util.h>
 #include <lionPrint.h>
 #include <cstdlib>
@@ -391,16 +392,9 @@ void ghost_sendEntities(Ghosting* plan, int entDim,
 #include "apfNumbering.h"
 #include "apfShape.h"
 // *********************************************************
-void pumi_ghost_create(pMesh m, Ghosting* plan)
+static void ghost_unfreezeFields(pMesh m, std::vector<apf::Field*>& frozen_fields)
 // *********************************************************
 {
-  if (PCU_Comm_Peers()==1) {
-    delete plan;
-    return;
-  }
- 
-  std::vector<apf::Field*> fields;
-  std::vector<apf::Field*> frozen_fields;
   for (int i=0; i<m->countFields(); ++i)
   {
     pField f = m->getField(i);
@@ -410,14 +404,35 @@ void pumi_ghost_create(pMesh m, Ghosting* plan)
       apf::unfreeze(f);
     }
   }
+}
 
-  double t0=PCU_Time();
-
-  EntityVector entities_to_ghost[4];
-  ghost_collectEntities(m, plan, entities_to_ghost);
+// *********************************************************
+static void ghost_freezeFields(pMesh m, std::vector<apf::Field*>& frozen_fields)
+// *********************************************************
+{
+  // frozen (array-based) field relies on local numbering of default field shape for accessing DOF
+  // if no default local numbering is found for default field shape, 
+  // apf::freeze creates a new local numbering. 
+  // local numbering has to be deleted after mesh modification and before freezing the field
+  while (m->countNumberings()) destroyNumbering(m->getNumbering(0));
+  for (std::vector<apf::Field*>::iterator fit=frozen_fields.begin(); fit!=frozen_fields.end(); ++fit)
+    apf::freeze(*fit);    
+}
 
+// *********************************************************
+static int ghost_exchange(Ghosting* plan, EntityVector entities_to_ghost[4])
+// *********************************************************
+// returns the number of ghost copies received
+{
+  int num_received=0;
+  apf::DynamicArray<pMeshTag> all_tags;
+  plan->getMesh()->getTags(all_tags);
+  // ghost copies get their own ghost tags, not those of the sender
   apf::DynamicArray<pMeshTag> tags;
-  plan->getMesh()->getTags(tags);
+  for (size_t i=0; i<all_tags.getSize(); ++i)
+    if (all_tags[i]!=pumi::instance()->ghost_tag &&
+        all_tags[i]!=pumi::instance()->ghosted_tag)
+      tags.append(all_tags[i]);
   for (int dimension = 0; dimension <= plan->ghost_dim; ++dimension)
   {
     PCU_Comm_Begin();
@@ -426,26 +441,55 @@ void pumi_ghost_create(pMesh m, Ghosting* plan)
     EntityVector received;
     ghost_receiveEntities(plan,tags,received);
     setupGhosts(plan->getMesh(),received);
+    num_received+=received.size();
+  }
+  return num_received;
+}
+
+// *********************************************************
+void pumi_ghost_create(pMesh m, Ghosting* plan)
+// *********************************************************
+{
+  if (PCU_Comm_Peers()==1) {
+    delete plan;
+    return;
   }
+ 
+  std::vector<apf::Field*> frozen_fields;
+  ghost_unfreezeFields(m, frozen_fields);
+
+  double t0=PCU_Time();
+
+  EntityVector entities_to_ghost[4];
+  ghost_collectEntities(m, plan, entities_to_ghost);
+  ghost_exchange(plan, entities_to_ghost);
   
   delete plan;
   m->acceptChanges();
+  pumi_field_deleteSyncPlan();
   
-  // frozen (array-based) field relies on local numbering of default field shape for accessing DOF
-  // if no default local numbering is found for default field shape, 
-  // apf::freeze creates a new local numbering. 
-  // local numbering has to be deleted after mesh modification and before freezing the field
-  while (m->countNumberings()) destroyNumbering(m->getNumbering(0));
-  for (std::vector<apf::Field*>::iterator fit=frozen_fields.begin(); fit!=frozen_fields.end(); ++fit)
-    apf::freeze(*fit);    
+  ghost_freezeFields(m, frozen_fields);
 
   if (!PCU_Comm_Self())
     lion_oprint(1,"mesh ghosted in %f seconds\n", PCU_Time()-t0);
 }
 
+// *********************************************************
+static bool ghost_isOn(pMeshEnt e, int pid, bool ignore_ghosts)
+// *********************************************************
+// with ignore_ghosts, ghost copies do not count as being on a part
+{
+  if (!ignore_ghosts) return pumi_ment_isOn(e, pid);
+  if (pid==pumi_rank()) return true;
+  apf::Copies remotes;
+  pumi::instance()->mesh->getRemotes(e,remotes);
+  return remotes.count(pid);
+}
+
 // *********************************************************
 void do_off_part_bridge(pMesh m, int brg_dim, int ghost_dim, int num_layer, 
-                        std::set<pMeshEnt>** off_bridge_set, Ghosting* plan)
+                        std::set<pMeshEnt>** off_bridge_set, Ghosting* plan,
+                        bool ignore_ghosts)
 // *********************************************************
 {
   std::map<pMeshEnt, set<int> > off_bridge_marker;
@@ -525,7 +569,7 @@ void do_off_part_bridge(pMesh m, int brg_dim, int ghost_dim, int num_layer,
         int num_brg=m->getDownward(ghost_ent,brg_dim, adjacent);
         for (int b=0; b<num_brg; ++b)
         {     
-          if (m->isShared(adjacent[b]) && adjacent[b]!=r && !pumi_ment_isOn(adjacent[b], r_pid))
+          if (m->isShared(adjacent[b]) && adjacent[b]!=r && !ghost_isOn(adjacent[b], r_pid, ignore_ghosts))
             off_bridge_set[r_layer+1][r_pid].insert(adjacent[b]);
         }
       } // if (r_layer<num_layer)
@@ -560,7 +604,7 @@ void do_off_part_bridge(pMesh m, int brg_dim, int ghost_dim, int num_layer,
           int num_brg=m->getDownward(ghost_ent,brg_dim, adjacent);
           for (int b=0; b<num_brg; ++b)
           {     
-            if (m->isShared(adjacent[b]) && adjacent[b]!=r && !pumi_ment_isOn(adjacent[b], r_pid))
+            if (m->isShared(adjacent[b]) && adjacent[b]!=r && !ghost_isOn(adjacent[b], r_pid, ignore_ghosts))
               off_bridge_set[layer+1][r_pid].insert(adjacent[b]);
           } // for int b=0
         } // if (layer<=num_layer)
@@ -647,7 +691,7 @@ void do_off_part_bridge(pMesh m, int brg_dim, int ghost_dim, int num_layer,
           int num_brg=m->getDownward(ghost_ent,brg_dim, adjacent);
           for (int b=0; b<num_brg; ++b)
           {     
-            if (m->isShared(adjacent[b]) && adjacent[b]!=r && !pumi_ment_isOn(adjacent[b], r_pid))
+            if (m->isShared(adjacent[b]) && adjacent[b]!=r && !ghost_isOn(adjacent[b], r_pid, ignore_ghosts))
             {
               if (off_bridge_marker[adjacent[b]].find(r_pid)==off_bridge_marker[adjacent[b]].end())
                 off_bridge_set[r_layer+1][r_pid].insert(adjacent[b]);
@@ -685,7 +729,7 @@ void do_off_part_bridge(pMesh m, int brg_dim, int ghost_dim, int num_layer,
             int num_brg=m->getDownward(ghost_ent,brg_dim, adjacent);
             for (int b=0; b<num_brg; ++b)
             {     
-              if (m->isShared(adjacent[b]) && adjacent[b]!=r && !pumi_ment_isOn(adjacent[b], r_pid))
+              if (m->isShared(adjacent[b]) && adjacent[b]!=r && !ghost_isOn(adjacent[b], r_pid, ignore_ghosts))
                 off_bridge_set[layer+1][r_pid].insert(adjacent[b]);
             } // for int b=0
           } // if (layer<=num_layer)
@@ -706,23 +750,158 @@ void do_off_part_bridge(pMesh m, int brg_dim, int ghost_dim, int num_layer,
 
 
 // *********************************************************
-void pumi_ghost_createLayer (pMesh m, int brg_dim, int ghost_dim, int num_layer, int include_copy)
+static bool ghost_checkLayer (pMesh m, int brg_dim, int ghost_dim, const char* func)
 // *********************************************************
 {
-  if (PCU_Comm_Peers()==1 || num_layer==0) return;
-  
-  int dummy=1, mesh_dim=m->getDimension(), self = pumi_rank();;
-  
+  int mesh_dim=m->getDimension();
   // brid/ghost dim check
   if (brg_dim>=ghost_dim || 0>brg_dim || brg_dim>=mesh_dim || 
       ghost_dim>mesh_dim || ghost_dim<1)
   {
-    if (!self)
-       std::cout<<__func__<<" ERROR: invalid bridge/ghost dimension\n";   
-    return;
+    if (!pumi_rank())
+       std::cout<<func<<" ERROR: invalid bridge/ghost dimension\n";   
+    return false;
   }
+  return true;
+}
 
-  double t0 = PCU_Time();
+// *********************************************************
+struct GhostReach
+// *********************************************************
+// the ghost_dim entities one bridge grows its layers over, in layer order,
+// and the off-part bridges met on the way, by layer and destination part
+{
+  struct OffBridge
+  {
+    pMeshEnt e;
+    int layer;
+    int pid;
+  };
+  std::vector<pMeshEnt> ents;
+  std::vector<OffBridge> off;
+};
+
+// *********************************************************
+static void ghost_growBridge (pMesh m, pMeshEnt brg_ent, apf::Copies& remotes,
+                              int brg_dim, int ghost_dim, int num_layer, pMeshTag tag,
+                              bool ignore_ghosts, GhostReach& reach)
+// *********************************************************
+{
+  int dummy=1;
+  pMeshEnt ghost_ent;
+  std::vector<pMeshEnt>& processed_ent = reach.ents;
+  std::vector<pMeshEnt> adj_ent;
+  processed_ent.clear();
+  reach.off.clear();
+
+  apf::Adjacent adjacent;
+  m->getAdjacent(brg_ent,ghost_dim, adjacent);   
+  APF_ITERATE(apf::Adjacent, adjacent, adj_ent_it)
+  {
+    ghost_ent = *adj_ent_it;
+    if (m->isGhost(ghost_ent)) continue; // skip ghost copy
+    m->setIntTag(ghost_ent,tag,&dummy);
+    processed_ent.push_back(ghost_ent);
+  }
+
+  int start_prev_layer=0, size_prev_layer=processed_ent.size(), num_prev_layer;
+  for (int layer=2; layer<num_layer+1; ++layer)
+  {  
+    num_prev_layer=0;
+    for (int i=start_prev_layer; i<size_prev_layer; ++i)
+    {
+      ghost_ent = processed_ent.at(i);
+      adj_ent.clear();
+      pumi_ment_get2ndAdj (ghost_ent, brg_dim, ghost_dim, adj_ent);
+
+      for (std::vector<pMeshEnt>::iterator git=adj_ent.begin(); git!=adj_ent.end(); ++git)
+      {
+        if (m->isGhost(*git) || m->hasTag(*git,tag))
+          continue; // skip ghost copy or already-processed copy
+        m->setIntTag(*git,tag,&dummy);
+        processed_ent.push_back(*git);
+        ++num_prev_layer;
+      } // for (std::vector<pMeshEnt>::iterator git=adj_ent.begin()
+
+      // collect off-part adjacent bridges
+      apf::Downward down;
+      int num_brg=m->getDownward(ghost_ent,brg_dim, down);
+      for (int b=0; b<num_brg; ++b)
+      {     
+        if (m->isShared(down[b]) && brg_ent!=down[b])
+        {
+          APF_ITERATE(apf::Copies,remotes,rit)
+          {
+            if (ghost_isOn(down[b], rit->first, ignore_ghosts)) continue;
+            GhostReach::OffBridge o = {down[b], layer, rit->first};
+            reach.off.push_back(o);
+          }
+        } // if (m->isShared(down[b])
+      } // for int b=0
+    } // for int i=start_prev_layer
+
+    start_prev_layer+=size_prev_layer;
+    size_prev_layer+=num_prev_layer;
+  } // for layer
+  for (std::vector<pMeshEnt>::iterator git=processed_ent.begin(); git!=processed_ent.end(); ++git)
+    m->removeTag(*git,tag);
+}
+
+// *********************************************************
+static void ghost_applyReach (Ghosting* plan, apf::Copies& remotes, GhostReach& reach,
+                              std::set<pMeshEnt>** off_bridge_set)
+// *********************************************************
+// sends the reach of a bridge to the remote copies of the bridge
+{
+  for (std::vector<pMeshEnt>::iterator it=reach.ents.begin(); it!=reach.ents.end(); ++it)
+    APF_ITERATE(apf::Copies,remotes,rit)
+      plan->send(*it, rit->first);
+  for (size_t i=0; i<reach.off.size(); ++i)
+    off_bridge_set[reach.off[i].layer][reach.off[i].pid].insert(reach.off[i].e);
+}
+
+// *********************************************************
+static std::set<pMeshEnt>** ghost_newOffBridgeSet (int num_layer)
+// *********************************************************
+{
+  std::set<pMeshEnt>** off_bridge_set=new std::set<pMeshEnt>*[num_layer+1];
+  for (int i=0; i<num_layer+1;++i)
+    off_bridge_set[i]=new std::set<pMeshEnt>[pumi_size()];
+  return off_bridge_set;
+}
+
+// *********************************************************
+static void ghost_planOffPart (pMesh m, int brg_dim, int ghost_dim, int num_layer, 
+                               std::set<pMeshEnt>** off_bridge_set, Ghosting* plan,
+                               bool ignore_ghosts)
+// *********************************************************
+// STEP 2 of the layer plan, which also deletes off_bridge_set
+{
+  int global_num_off_part=0, local_num_off_part=0;
+  if (num_layer>=2)
+  {
+    for (int i=0; i<num_layer+1;++i)
+      for (int j=0; j<pumi_size();++j)
+        local_num_off_part+=off_bridge_set[i][j].size();
+    MPI_Allreduce(&local_num_off_part, &global_num_off_part, 1,MPI_INT,MPI_SUM,PCU_Get_Comm());
+  }
+
+  if (global_num_off_part)
+    do_off_part_bridge(m, brg_dim, ghost_dim, num_layer, off_bridge_set, plan,
+                       ignore_ghosts);
+
+  // clean up
+  for (int i=0; i<num_layer+1;++i)
+    delete [] off_bridge_set[i];
+  delete [] off_bridge_set;
+}
+
+// *********************************************************
+static Ghosting* ghost_planLayer (pMesh m, int brg_dim, int ghost_dim, int num_layer, 
+                                  int include_copy, bool ignore_ghosts)
+// *********************************************************
+{
+  int self = pumi_rank();
 
   pMeshTag tag = m->createIntTag("ghost_check_mark",1);
   Ghosting* plan = new Ghosting(m, ghost_dim);
@@ -731,114 +910,256 @@ void pumi_ghost_createLayer (pMesh m, int brg_dim, int ghost_dim, int num_layer,
 // STEP 1: compute entities to ghost
 // ********************************************
 
-  pMeshEnt ghost_ent;
   pMeshEnt brg_ent;
-
-  std::vector<pMeshEnt> processed_ent;
-  std::vector<pMeshEnt> adj_ent;
-
-  std::set<pMeshEnt>** off_bridge_set=new std::set<pMeshEnt>*[num_layer+1];
-  for (int i=0; i<num_layer+1;++i)
-    off_bridge_set[i]=new std::set<pMeshEnt>[pumi_size()];
+  GhostReach reach;
+  std::set<pMeshEnt>** off_bridge_set = ghost_newOffBridgeSet(num_layer);
 
   apf::MeshIterator* it = m->begin(brg_dim);
   while ((brg_ent = m->iterate(it)))
   {
     if (!m->isShared(brg_ent)) continue; // skip non-partboundary entity
     if (!include_copy && m->getOwner(brg_ent)!=self) continue;
-    processed_ent.clear();
 
     apf::Copies remotes;
     m->getRemotes(brg_ent,remotes);
+    ghost_growBridge(m, brg_ent, remotes, brg_dim, ghost_dim, num_layer, tag,
+                     ignore_ghosts, reach);
+    ghost_applyReach(plan, remotes, reach, off_bridge_set);
+  } // while brg_ent
+  m->end(it);
 
-    apf::Adjacent adjacent;
-    m->getAdjacent(brg_ent,ghost_dim, adjacent);   
-    APF_ITERATE(apf::Adjacent, adjacent, adj_ent_it)
-    {
-      ghost_ent = *adj_ent_it;
-      if (m->isGhost(ghost_ent)) continue; // skip ghost copy
-
-      APF_ITERATE(apf::Copies,remotes,rit)
-        plan->send(ghost_ent, rit->first);
+// ********************************************
+// STEP 2: deal with off-part adjacency, if any
+// ********************************************
+  ghost_planOffPart(m, brg_dim, ghost_dim, num_layer, off_bridge_set, plan, ignore_ghosts);
+  m->destroyTag(tag);
+  return plan;
+}
 
-      m->setIntTag(ghost_ent,tag,&dummy);
-      processed_ent.push_back(ghost_ent);
+// *********************************************************
+class GhostLayers : public apf::ModifyCallback
+// *********************************************************
+// the reach of every bridge that pumi_ghost_updateLayer grew, the remote
+// copies of the shared bridges when they were last seen, and, from mesh
+// change callbacks, the bridges whose reach must grow again
+{
+  public:
+    GhostLayers(pMesh mesh, int b, int g, int n, int ic):
+      m(mesh), brg_dim(b), ghost_dim(g), num_layer(n), include_copy(ic)
+    {
+      m->addModifyCallback(this);
     }
-
-    int start_prev_layer=0, size_prev_layer=processed_ent.size(), num_prev_layer;
-    for (int layer=2; layer<num_layer+1; ++layer)
-    {  
-      num_prev_layer=0;
-      for (int i=start_prev_layer; i<size_prev_layer; ++i)
+    ~GhostLayers()
+    {
+      m->removeModifyCallback(this);
+    }
+    bool fits(pMesh mesh, int b, int g, int n, int ic)
+    {
+      return m==mesh && brg_dim==b && ghost_dim==g && num_layer==n && include_copy==ic;
+    }
+    // drops the reach of a bridge
+    void forget(pMeshEnt b)
+    {
+      std::map<pMeshEnt, GhostReach>::iterator rit = reaches.find(b);
+      if (rit==reaches.end()) return;
+      std::vector<pMeshEnt>& ents = rit->second.ents;
+      for (std::vector<pMeshEnt>::iterator it=ents.begin(); it!=ents.end(); ++it)
       {
-        ghost_ent = processed_ent.at(i);
-        adj_ent.clear();
-        pumi_ment_get2ndAdj (ghost_ent, brg_dim, ghost_dim, adj_ent);
+        std::map<pMeshEnt, std::vector<pMeshEnt> >::iterator fit = reached_from.find(*it);
+        if (fit==reached_from.end()) continue;
+        std::vector<pMeshEnt>& from = fit->second;
+        from.erase(std::remove(from.begin(), from.end(), b), from.end());
+        if (from.empty()) reached_from.erase(fit);
+      }
+      reaches.erase(rit);
+    }
+    // keeps the reach of a bridge
+    void remember(pMeshEnt b, GhostReach& reach)
+    {
+      GhostReach& kept = reaches[b];
+      kept = reach;
+      for (std::vector<pMeshEnt>::iterator it=kept.ents.begin(); it!=kept.ents.end(); ++it)
+        reached_from[*it].push_back(b);
+    }
+    void created(pMeshEnt e)
+    {
+      if (getDimension(m, e)==ghost_dim)
+        created_ents.insert(e);
+    }
+    void destroying(pMeshEnt e)
+    {
+      int d = getDimension(m, e);
+      if (d==ghost_dim)
+      {
+        created_ents.erase(e);
+        std::map<pMeshEnt, std::vector<pMeshEnt> >::iterator fit = reached_from.find(e);
+        if (fit==reached_from.end()) return;
+        dirty.insert(fit->second.begin(), fit->second.end());
+        reached_from.erase(fit);
+      }
+      else if (d==brg_dim)
+      {
+        forget(e);
+        copies.erase(e);
+        dirty.erase(e);
+      }
+    }
+    void moved(pMeshEnt) {}
 
-        for (std::vector<pMeshEnt>::iterator git=adj_ent.begin(); git!=adj_ent.end(); ++git)
-        {
-          if (m->isGhost(*git) || m->hasTag(*git,tag))
-            continue; // skip ghost copy or already-processed copy
-      
-          APF_ITERATE(apf::Copies,remotes,rit)
-            plan->send(*git, rit->first);
+    pMesh m;
+    int brg_dim, ghost_dim, num_layer, include_copy;
+    std::map<pMeshEnt, GhostReach> reaches;
+    std::map<pMeshEnt, std::vector<pMeshEnt> > reached_from;
+    std::map<pMeshEnt, apf::Copies> copies;
+    std::set<pMeshEnt> dirty;
+    std::set<pMeshEnt> created_ents;
+};
 
-          m->setIntTag(*git,tag,&dummy);
-          processed_ent.push_back(*git);
-          ++num_prev_layer;
-        } // for (std::vector<pMeshEnt>::iterator git=adj_ent.begin()
+// *********************************************************
+static void ghost_markDirty (GhostLayers* l, std::vector<pMeshEnt>& seeds)
+// *********************************************************
+// a bridge reaches an entity in layer k iff the entity reaches the bridge
+// in k-1 steps, so walking num_layer-1 steps from the changed ghost_dim
+// entities finds every bridge whose reach may have changed
+{
+  pMesh m = l->m;
+  int dummy=1;
+  pMeshTag tag = m->createIntTag("ghost_dirty_mark",1);
+  std::vector<pMeshEnt> visited;
+  std::vector<pMeshEnt> adj_ent;
+  for (std::vector<pMeshEnt>::iterator it=seeds.begin(); it!=seeds.end(); ++it)
+  {
+    if (m->isGhost(*it) || m->hasTag(*it,tag)) continue;
+    m->setIntTag(*it,tag,&dummy);
+    visited.push_back(*it);
+  }
+  size_t start=0;
+  for (int layer=1; layer<=l->num_layer; ++layer)
+  {
+    size_t end=visited.size();
+    for (size_t i=start; i<end; ++i)
+    {
+      apf::Downward down;
+      int num_brg=m->getDownward(visited[i],l->brg_dim, down);
+      for (int b=0; b<num_brg; ++b)
+        if (m->isShared(down[b]))
+          l->dirty.insert(down[b]);
+      if (layer==l->num_layer) continue;
+      adj_ent.clear();
+      pumi_ment_get2ndAdj (visited[i], l->brg_dim, l->ghost_dim, adj_ent);
+      for (std::vector<pMeshEnt>::iterator git=adj_ent.begin(); git!=adj_ent.end(); ++git)
+      {
+        if (m->isGhost(*git) || m->hasTag(*git,tag)) continue;
+        m->setIntTag(*git,tag,&dummy);
+        visited.push_back(*git);
+      }
+    }
+    start=end;
+  }
+  for (std::vector<pMeshEnt>::iterator it=visited.begin(); it!=visited.end(); ++it)
+    m->removeTag(*it,tag);
+  m->destroyTag(tag);
+}
 
-        // collect off-part adjacent bridges
-        if (layer<=num_layer)
-        {
-          apf::Downward adjacent;
-          int num_brg=m->getDownward(ghost_ent,brg_dim, adjacent);
-          for (int b=0; b<num_brg; ++b)
-          {     
-            if (m->isShared(adjacent[b]) && brg_ent!=adjacent[b])
-            {
-              APF_ITERATE(apf::Copies,remotes,rit)
-              {
-                if (!pumi_ment_isOn(adjacent[b], rit->first))
-                  off_bridge_set[layer][rit->first].insert(adjacent[b]);
-              }
-            } // if (m->isShared(adjacent[b])
-          } // for int b=0
-        } // if (layer<=num_layer)
-      } // for int i=start_prev_layer
+// *********************************************************
+static Ghosting* ghost_replanLayer (GhostLayers* l, int& num_grown, int& num_bridges)
+// *********************************************************
+// the plan of ghost_planLayer with ignore_ghosts, where only the bridges
+// that mesh changes or new remote copies reach grow their layers again
+{
+  pMesh m = l->m;
+  int self = pumi_rank();
+  pMeshEnt brg_ent;
 
-      start_prev_layer+=size_prev_layer;
-      size_prev_layer+=num_prev_layer;
-    } // for layer
-    for (std::vector<pMeshEnt>::iterator git=processed_ent.begin(); git!=processed_ent.end(); ++git)
-      m->removeTag(*git,tag);
-  } // while brg_ent
+  // the changed ghost_dim entities, and the bridges whose remote copies
+  // changed, appeared or went away
+  std::vector<pMeshEnt> seeds(l->created_ents.begin(), l->created_ents.end());
+  l->created_ents.clear();
+  std::vector<pMeshEnt> changed;
+  std::vector<pMeshEnt> bridges;
+  apf::MeshIterator* it = m->begin(l->brg_dim);
+  while ((brg_ent = m->iterate(it)))
+  {
+    if (!m->isShared(brg_ent)) continue;
+    apf::Copies remotes;
+    m->getRemotes(brg_ent,remotes);
+    std::map<pMeshEnt, apf::Copies>::iterator cit = l->copies.find(brg_ent);
+    if (cit==l->copies.end() || cit->second!=remotes)
+    {
+      changed.push_back(brg_ent);
+      l->copies[brg_ent] = remotes;
+    }
+    if (l->include_copy || m->getOwner(brg_ent)==self)
+      bridges.push_back(brg_ent);
+  }
   m->end(it);
+  for (std::map<pMeshEnt, apf::Copies>::iterator cit=l->copies.begin(); cit!=l->copies.end();)
+  {
+    if (m->isShared(cit->first)) { ++cit; continue; }
+    changed.push_back(cit->first);
+    l->copies.erase(cit++);
+  }
+  for (std::vector<pMeshEnt>::iterator cit=changed.begin(); cit!=changed.end(); ++cit)
+  {
+    l->dirty.insert(*cit);
+    apf::Adjacent adjacent;
+    m->getAdjacent(*cit,l->ghost_dim, adjacent);
+    seeds.insert(seeds.end(), adjacent.begin(), adjacent.end());
+  }
+  ghost_markDirty(l, seeds);
+
+  // bridges that no longer grow layers
+  std::set<pMeshEnt> growing(bridges.begin(), bridges.end());
+  std::vector<pMeshEnt> gone;
+  for (std::map<pMeshEnt, GhostReach>::iterator rit=l->reaches.begin(); rit!=l->reaches.end(); ++rit)
+    if (!growing.count(rit->first)) gone.push_back(rit->first);
+  for (std::vector<pMeshEnt>::iterator git=gone.begin(); git!=gone.end(); ++git)
+    l->forget(*git);
 
 // ********************************************
-// STEP 2: deal with off-part adjacency, if any
+// STEP 1: grow the layers of changed bridges, keep the others
 // ********************************************
-  int global_num_off_part=0, local_num_off_part=0;
-  if (num_layer>=2)
+  pMeshTag tag = m->createIntTag("ghost_check_mark",1);
+  GhostReach reach;
+  num_grown=0;
+  num_bridges=bridges.size();
+  for (std::vector<pMeshEnt>::iterator bit=bridges.begin(); bit!=bridges.end(); ++bit)
   {
-    for (int i=0; i<num_layer+1;++i)
-      for (int j=0; j<pumi_size();++j)
-        local_num_off_part+=off_bridge_set[i][j].size();
-    MPI_Allreduce(&local_num_off_part, &global_num_off_part, 1,MPI_INT,MPI_SUM,PCU_Get_Comm());
+    if (!l->dirty.count(*bit) && l->reaches.count(*bit)) continue;
+    l->forget(*bit);
+    ghost_growBridge(m, *bit, l->copies[*bit], l->brg_dim, l->ghost_dim, l->num_layer,
+                     tag, true, reach);
+    l->remember(*bit, reach);
+    ++num_grown;
   }
+  l->dirty.clear();
 
-  if (global_num_off_part)
-    do_off_part_bridge(m, brg_dim, ghost_dim, num_layer, off_bridge_set, plan);
+  Ghosting* plan = new Ghosting(m, l->ghost_dim);
+  std::set<pMeshEnt>** off_bridge_set = ghost_newOffBridgeSet(l->num_layer);
+  for (std::map<pMeshEnt, GhostReach>::iterator rit=l->reaches.begin(); rit!=l->reaches.end(); ++rit)
+    ghost_applyReach(plan, l->copies[rit->first], rit->second, off_bridge_set);
 
-  // clean up
+// ********************************************
+// STEP 2: off-part bridges come from other parts, so they grow every time
+// ********************************************
+  ghost_planOffPart(m, l->brg_dim, l->ghost_dim, l->num_layer, off_bridge_set, plan, true);
   m->destroyTag(tag);
-  for (int i=0; i<num_layer+1;++i)
-    for (int j=0; j<pumi_size();++j)
-      off_bridge_set[i][j].clear();
+  return plan;
+}
 
-  for (int i=0; i<num_layer+1;++i)
-    delete [] off_bridge_set[i];
-  delete [] off_bridge_set;
+// *********************************************************
+void pumi_ghost_createLayer (pMesh m, int brg_dim, int ghost_dim, int num_layer, int include_copy)
+// *********************************************************
+{
+  if (PCU_Comm_Peers()==1 || num_layer==0) return;
+  if (!ghost_checkLayer(m, brg_dim, ghost_dim, __func__)) return;
+
+  double t0 = PCU_Time();
+
+// ********************************************
+// STEP 1-2: compute entities to ghost
+// ********************************************
+  Ghosting* plan = ghost_planLayer(m, brg_dim, ghost_dim, num_layer, include_copy, false);
 
 // ********************************************
 // STEP 3: perform ghosting
@@ -850,22 +1171,183 @@ void pumi_ghost_createLayer (pMesh m, int brg_dim, int ghost_dim, int num_layer,
 }
 
 // *********************************************************
-void pumi_ghost_delete (pMesh m)
+static void ghost_unlink(pMesh m, pMeshEnt e, int pid)
 // *********************************************************
+// removes the ghost copy on part pid from the ghost copies of e
+{
+  apf::Copies ghosts;
+  m->getGhosts(e, ghosts);
+  ghosts.erase(pid);
+  m->deleteGhost(e);
+  APF_ITERATE(apf::Copies, ghosts, git)
+    m->addGhost(e, git->first, git->second);
+}
+
+// *********************************************************
+static void ghost_forget(pMesh m, std::set<pMeshEnt>& destroyed)
+// *********************************************************
+// drops destroyed ghost copies and entities left without ghost copies
+// from the ghost lists
 {
   pMeshTag tag = pumi::instance()->ghosted_tag;
-  if (!tag) return;
+  for (int d=0; d<4; ++d)
+  {
+    std::vector<pMeshEnt>& ghost_vec = pumi::instance()->ghost_vec[d];
+    std::vector<pMeshEnt> kept;
+    for (std::vector<pMeshEnt>::iterator it=ghost_vec.begin(); it!=ghost_vec.end(); ++it)
+      if (!destroyed.count(*it)) kept.push_back(*it);
+    ghost_vec.swap(kept);
+
+    std::vector<pMeshEnt>& ghosted_vec = pumi::instance()->ghosted_vec[d];
+    kept.clear();
+    for (std::vector<pMeshEnt>::iterator it=ghosted_vec.begin(); it!=ghosted_vec.end(); ++it)
+    {
+      apf::Copies ghosts;
+      if (m->getGhosts(*it, ghosts))
+        kept.push_back(*it);
+      else
+        m->removeTag(*it, tag);
+    }
+    ghosted_vec.swap(kept);
+  }
+}
 
-  std::vector<apf::Field*> frozen_fields;
-  for (int i=0; i<m->countFields(); ++i)
+// *********************************************************
+static int ghost_deleteStale(pMesh m, Ghosting* plan)
+// *********************************************************
+// deletes the ghost copies of owned entities that the plan no longer
+// sends to their part, and returns how many
+{
+  enum { DESTROY, UNLINK };
+  int self = pumi_rank(), num_deleted=0;
+  PCU_Comm_Begin();
+  for (int d=0; d<4; ++d)
   {
-    pField f = m->getField(i);
-    if (isFrozen(f))
+    std::vector<pMeshEnt>& ghosted_vec = pumi::instance()->ghosted_vec[d];
+    for (std::vector<pMeshEnt>::iterator it=ghosted_vec.begin(); it!=ghosted_vec.end(); ++it)
     {
-      frozen_fields.push_back(f); // turn field data from tag to array
-      apf::unfreeze(f);
+      pMeshEnt e = *it;
+      if (m->getOwner(e)!=self) continue;
+      apf::Copies ghosts, remotes;
+      m->getGhosts(e, ghosts);
+      m->getRemotes(e, remotes);
+      APF_ITERATE(apf::Copies, ghosts, git)
+      {
+        int to = git->first;
+        if (d<=plan->ghost_dim && plan->has(e) && plan->sending(e, d).count(to))
+          continue;
+        // the ghost copy goes away, then every copy of e forgets it
+        int kind = DESTROY;
+        PCU_COMM_PACK(to, kind);
+        PCU_COMM_PACK(to, git->second);
+        kind = UNLINK;
+        APF_ITERATE(apf::Copies, remotes, rit)
+        {
+          PCU_COMM_PACK(rit->first, kind);
+          PCU_COMM_PACK(rit->first, rit->second);
+          PCU_COMM_PACK(rit->first, to);
+        }
+        ghost_unlink(m, e, to);
+        ++num_deleted;
+      }
     }
   }
+  PCU_Comm_Send();
+  EntityVector to_destroy[4];
+  while (PCU_Comm_Receive())
+  {
+    int kind;
+    pMeshEnt e;
+    PCU_COMM_UNPACK(kind);
+    PCU_COMM_UNPACK(e);
+    if (kind==DESTROY)
+      to_destroy[getDimension(m, e)].push_back(e);
+    else
+    {
+      int pid;
+      PCU_COMM_UNPACK(pid);
+      ghost_unlink(m, e, pid);
+    }
+  }
+  std::set<pMeshEnt> destroyed;
+  for (int d=3; d>=0; --d)
+    APF_ITERATE(EntityVector, to_destroy[d], it)
+    {
+      destroyed.insert(*it);
+      m->destroy(*it);
+    }
+  ghost_forget(m, destroyed);
+  return num_deleted;
+}
+
+// *********************************************************
+void pumi_ghost_updateLayer (pMesh m, int brg_dim, int ghost_dim, int num_layer, int include_copy)
+// *********************************************************
+{
+  if (PCU_Comm_Peers()==1) return;
+  if (!ghost_checkLayer(m, brg_dim, ghost_dim, __func__)) return;
+
+  double t0 = PCU_Time();
+  GhostLayers* layers = pumi::instance()->ghost_layers;
+  if (layers && !layers->fits(m, brg_dim, ghost_dim, num_layer, include_copy))
+  {
+    pumi_ghost_deleteLayers();
+    layers = NULL;
+  }
+  Ghosting* plan;
+  int num_grown=0, num_bridges=0;
+  if (num_layer)
+  {
+    if (!layers)
+      layers = pumi::instance()->ghost_layers =
+        new GhostLayers(m, brg_dim, ghost_dim, num_layer, include_copy);
+    plan = ghost_replanLayer(layers, num_grown, num_bridges);
+  }
+  else
+    plan = new Ghosting(m, ghost_dim);
+
+  std::vector<apf::Field*> frozen_fields;
+  ghost_unfreezeFields(m, frozen_fields);
+
+  EntityVector entities_to_ghost[4];
+  ghost_collectEntities(m, plan, entities_to_ghost);
+  int num_deleted = ghost_deleteStale(m, plan);
+  int num_sent = ghost_exchange(plan, entities_to_ghost);
+  delete plan;
+
+  int counts[4] = {num_deleted, num_sent, num_grown, num_bridges};
+  PCU_Add_Ints(counts, 4);
+  if (counts[0] || counts[1])
+  {
+    m->acceptChanges();
+    pumi_field_deleteSyncPlan();
+  }
+  ghost_freezeFields(m, frozen_fields);
+
+  if (!PCU_Comm_Self())
+    lion_oprint(1,"ghost layers updated in %f seconds: %d of %d bridges grown, "
+                "%d ghost copies deleted, %d created\n",
+                PCU_Time()-t0, counts[2], counts[3], counts[0], counts[1]);
+}
+
+// *********************************************************
+void pumi_ghost_deleteLayers()
+// *********************************************************
+{
+  delete pumi::instance()->ghost_layers;
+  pumi::instance()->ghost_layers = NULL;
+}
+
+// *********************************************************
+void pumi_ghost_delete (pMesh m)
+// *********************************************************
+{
+  pumi_ghost_deleteLayers();
+  pMeshTag tag = pumi::instance()->ghosted_tag;
+  if (!tag) return;
+
+  std::vector<apf::Field*> frozen_fields;
+  ghost_unfreezeFields(m, frozen_fields);
 
   for (int d=3; d>=0; --d)
   {
@@ -894,14 +1376,9 @@ void pumi_ghost_delete (pMesh m)
     pumi::instance()->ghost_vec[d].clear();
     pumi::instance()->ghosted_vec[d].clear();
   }
+  pumi_field_deleteSyncPlan();
 
-  // frozen (array-based) field relies on local numbering of default field shape for accessing DOF
-  // if no default local numbering is found for default field shape, 
-  // apf::freeze creates a new local numbering. 
-  // local numbering has to be deleted after mesh modification and before freezing the field
-  while (m->countNumberings()) destroyNumbering(m->getNumbering(0));
-  for (std::vector<apf::Field*>::iterator fit=frozen_fields.begin(); fit!=frozen_fields.end(); ++fit)
-    apf::freeze(*fit);    
+  ghost_freezeFields(m, frozen_fields);
 }
 
 // *********************************************************
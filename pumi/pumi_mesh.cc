@@ -149,6 +149,7 @@ pumi::pumi(): mesh(NULL), model(NULL)
 {
   ghost_tag=NULL;
   ghosted_tag=NULL;
+  ghost_layers=NULL;
   num_local_ent = NULL;
   num_own_ent = NULL;
   num_global_ent = NULL;
@@ -307,6 +308,7 @@ pMesh pumi_mesh_loadAll(pGeom g, const char* filename, bool stitch_link)
 
 void pumi_mesh_migrate(pMesh m, Migration* plan)
 {
+  pumi_field_deleteSyncPlan();
   apf::migrate(m, plan);
 }
 
@@ -585,6 +587,8 @@ void pumi_mesh_write (pMesh m, const char* filename, const char* mesh_type)
 
 void pumi_mesh_delete(pMesh m)
 {
+  pumi_field_deleteSyncPlan();
+  pumi_ghost_deleteLayers();
   if (m->findTag("ghost_tag"))
     m->destroyTag(pumi::instance()->ghost_tag);
   if (m->findTag("ghosted_tag"))
@@ -920,5 +924,6 @@ void pumi_mesh_distribute(pMesh m, Distribution* plan)
     if (!PCU_Comm_Self()) std::cout<<"[PUMI ERROR] "<<__func__<<" not supported with ghosted mesh\n";
     return;
   }
+  pumi_field_deleteSyncPlan();
   distribute(m, plan);
 }
@@ -25,6 +25,8 @@ void pumi_start()
 
 void pumi_finalize(bool)
 {
+  pumi_field_deleteSyncPlan();
+  pumi_ghost_deleteLayers();
   PCU_Comm_Free();
 }
 
@@ -299,7 +299,7 @@ static void eliminateDBCs(
 }
 
 static double computeL2Error(apf::Mesh* mesh, apf::MeshEntity* e,
-  apf::Field* f, mth::Vector<double> const error_dofs)
+  apf::Field* f, mth::Vector<double> const& error_dofs)
 {
   double error = 0.0;
 
@@ -327,18 +327,15 @@ static double computeL2Error(apf::Mesh* mesh, apf::MeshEntity* e,
     w = weight * jdet;
 
     apf::getVectorShapeValues(el, p, vectorshape);
-    mth::Matrix<double> vectorShape (nd, dim);
-    for (int j = 0; j < nd; j++)
-      for (int k = 0; k < dim; k++)
-        vectorShape(j,k) = vectorshape[j][k];
-
-    mth::Matrix<double> vectorShapeT (dim, nd);
-    mth::transpose(vectorShape, vectorShapeT);
-
-    mth::Vector<double> err_func;
-    mth::multiply(vectorShapeT, error_dofs, err_func);
-
-    error += w * (err_func * err_func);
+    double err_func[3] = {0., 0., 0.};
+    for (int k = 0; k < dim; k++)
+      for (int j = 0; j < nd; j++)
+        err_func[k] += vectorshape[j][k] * error_dofs(j);
+
+    double err_sq = 0;
+    for (int k = 0; k < dim; k++)
+      err_sq += err_func[k] * err_func[k];
+    error += w * err_sq;
   }
   apf::destroyElement(el);
   apf::destroyMeshElement(me);
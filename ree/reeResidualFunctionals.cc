@@ -70,6 +70,7 @@ struct EdgePatch {
   mth::Matrix<double> T; // T = A*At + 1
   mth::Vector<double> b;
   mth::Vector<double> x;
+  mth::Vector<double> g; // g = At*x on interior edges
   QRDecomp qr;
 };
 
@@ -163,6 +164,26 @@ static void assembleEdgePatchLHS(EdgePatch* ep)
   mth::decomposeQR(ep->T, ep->qr.Q, ep->qr.R);
 }
 
+/*
+ * elmat += w * S S^T, where row j of S holds the first dim
+ * components of s[j]. each product is computed once for the
+ * lower triangle and mirrored, and no temporaries are allocated.
+ */
+static void addWeightedOuterProducts(apf::NewArray<apf::Vector3> const& s,
+    int nd, int dim, double w, mth::Matrix<double>& elmat)
+{
+  for (int j = 0; j < nd; j++)
+    for (int k = 0; k <= j; k++) {
+      double d = 0;
+      for (int l = 0; l < dim; l++)
+        d += s[j][l] * s[k][l];
+      d *= w;
+      elmat(j,k) += d;
+      if (k != j)
+        elmat(k,j) += d;
+    }
+}
+
 /*
  * Performs Curl Curl integration using curl vector Nedelec shapes
  */
@@ -174,11 +195,10 @@ void assembleCurlCurlElementMatrix(apf::Mesh* mesh, apf::MeshEntity* e,
   PCU_ALWAYS_ASSERT(type == apf::Mesh::TET);
   int nd = apf::countElementNodes(fs, type);
   int dim = apf::getDimension(mesh, e);
-  int dimc = (dim == 3) ? 3 : 1;
   double w;
 
   apf::NewArray<apf::Vector3> curlshape(nd);
-  mth::Matrix<double> phys_curlshape(nd, dimc);
+  apf::NewArray<apf::Vector3> phys_curlshape(nd);
   elmat.resize(nd,nd);
 
   apf::MeshElement* me = apf::createMeshElement(mesh, e);
@@ -196,22 +216,14 @@ void assembleCurlCurlElementMatrix(apf::Mesh* mesh, apf::MeshEntity* e,
     double jdet = apf::getJacobianDeterminant(J, dim);
     w = weight / jdet;
 
-    if (dim == 3) {
-      el->getShape()->getLocalVectorCurls(mesh, e, p, curlshape);
-      phys_curlshape.zero();
-      for (int j = 0; j < nd; j++)
-        for (int k = 0; k < dim; k++)
-          for (int l = 0; l < dim; l++)
-            phys_curlshape(j,k) += curlshape[j][l] * J[l][k];
-    }
-    mth::Matrix<double> phys_curlshapeT;
-    mth::transpose(phys_curlshape, phys_curlshapeT);
-
-    mth::Matrix<double> M (nd, nd);
-    M.zero();
-    mth::multiply(phys_curlshape, phys_curlshapeT, M);
-    M *= w;
-    elmat += M;
+    el->getShape()->getLocalVectorCurls(mesh, e, p, curlshape);
+    for (int j = 0; j < nd; j++)
+      for (int k = 0; k < dim; k++) {
+        phys_curlshape[j][k] = 0;
+        for (int l = 0; l < dim; l++)
+          phys_curlshape[j][k] += curlshape[j][l] * J[l][k];
+      }
+    addWeightedOuterProducts(phys_curlshape, nd, dim, w, elmat);
   }
   apf::destroyElement(el);
   apf::destroyMeshElement(me);
@@ -250,19 +262,7 @@ void assembleVectorMassElementMatrix(apf::Mesh* mesh, apf::MeshEntity* e,
     w = weight * jdet;
 
     apf::getVectorShapeValues(el, p, vectorshapes);
-    mth::Matrix<double> vectorShapes (nd, sdim);
-    for (int j = 0; j < nd; j++)
-      for (int k = 0; k < sdim; k++)
-        vectorShapes(j,k) = vectorshapes[j][k];
-
-    mth::Matrix<double> vectorShapesT (sdim, nd);
-    mth::transpose(vectorShapes, vectorShapesT);
-
-    mth::Matrix<double> M (nd,nd);
-    M.zero();
-    mth::multiply(vectorShapes, vectorShapesT, M);
-    M *= w;
-    elmat += M;
+    addWeightedOuterProducts(vectorshapes, nd, sdim, w, elmat);
   }
 
   apf::destroyElement(el);
@@ -300,9 +300,6 @@ static double getLocalEdgeBLF(EdgePatch* ep, apf::MeshEntity* tet)
   int nd = apf::countElementNodes(el->getFieldShape(), type);
   apf::NewArray<double> d (nd);
   el->getElementNodeData(d);
-  mth::Vector<double> dofs (nd);
-  for (int i = 0; i < nd; i++)
-    dofs(i) = d[i];
   // assemble curl curl element matrix
   mth::Matrix<double> curl_elmat;
   assembleCurlCurlElementMatrix(ep->mesh, tet,
@@ -311,25 +308,21 @@ static double getLocalEdgeBLF(EdgePatch* ep, apf::MeshEntity* tet)
   mth::Matrix<double> mass_elmat;
   assembleVectorMassElementMatrix(ep->mesh, tet,
       ep->equilibration->ef, mass_elmat);
-  // add element matrices
-  mth::Matrix<double> elmat(nd, nd);
-  elmat.zero();
-  elmat += curl_elmat;
-  elmat += mass_elmat;
-  // multiply element matrix with element dofs
-  mth::Vector<double> blf_integrals (nd);
-  mth::multiply(elmat, dofs, blf_integrals);
+  // only the row of the edge is needed from
+  // the product of the element matrix with the dofs
+  double blf_integral = 0;
+  for (int i = 0; i < nd; i++)
+    blf_integral += (curl_elmat(ei,i) + mass_elmat(ei,i)) * d[i];
 
   apf::destroyElement(el);
   apf::destroyMeshElement(me);
 
-  // pick edge index from the resulting vector
   // negation of negative ND dofs
   int which, rotate; bool flip;
   apf::getAlignment(ep->mesh, tet, ep->entity, which, flip, rotate);
   if (flip)
-    blf_integrals(ei) = -1*blf_integrals(ei);
-  return blf_integrals(ei);
+    blf_integral = -1*blf_integral;
+  return blf_integral;
 }
 
 /*
@@ -391,14 +384,12 @@ void assembleDomainLFElementVector(apf::Mesh* mesh, apf::MeshEntity* e,
     pumiUserFunction(mesh, e, global, val);
     val *= w;
 
-    mth::Matrix<double> vectorShapes (nd, dim);
-    for (int j = 0; j < nd; j++)
+    for (int j = 0; j < nd; j++) {
+      double v = 0;
       for (int k = 0; k < dim; k++)
-        vectorShapes(j,k) = vectorshapes[j][k];
-    mth::Vector<double> V (nd);
-    V.zero();
-    mth::multiply(vectorShapes, val, V);
-    elvect += V;
+        v += vectorshapes[j][k] * val(k);
+      elvect(j) += v;
+    }
   }
 
   apf::destroyElement(el);
@@ -849,10 +840,9 @@ static void runErm(EdgePatch* ep)
   mth::solveFromQR(ep->qr.Q, ep->qr.R, ep->b, ep->x);
 
   if (!ep->isOnBdry) { // solve At*mu = g for g
-    mth::Vector<double> temp(ep->tets.size());
-    mth::multiply(ep->At, ep->x, temp);
+    mth::multiply(ep->At, ep->x, ep->g);
     for (size_t i = 0; i < ep->tets.size(); i++) {
-      ep->x(i) = temp(i);
+      ep->x(i) = ep->g(i);
     }
   }
 
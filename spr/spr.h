@@ -16,6 +16,7 @@
 #include "apfNew.h"
 #include "apfDynamicVector.h"
 #include "apfDynamicMatrix.h"
+#include <vector>
 
 /** \namespace spr
   * \brief All SPR error estimator functions
@@ -37,6 +38,19 @@ apf::Field* getGradIPField(apf::Field* f,
   */
 apf::Field* recoverField(apf::Field* ip_field);
 
+/** @brief recover several nodal fields using patch recovery
+  * @details all input fields must share one integration point shape.
+  *          patches are built from flat adjacency arrays, processed
+  *          on threads when OpenMP is enabled, and each patch QR
+  *          factorization is reused for every component of every field.
+  *          patches touching part boundaries fall back to the
+  *          migrating CavityOp path.
+  * @param ip_fields (In) integration point fields
+  * @returns the recovered nodal fields, in input order
+  */
+std::vector<apf::Field*> recoverFields(
+    std::vector<apf::Field*> const& ip_fields);
+
 /** @brief run the SPR ZZ error estimator
   * @param f the integration-point input field
   * @param adapt_ratio the fraction of allowable error,
@@ -16,6 +16,7 @@
 #include <mthQR.h>
 
 #include <set>
+#include <algorithm>
 #include <pcu_util.h>
 
 namespace spr {
@@ -417,15 +418,335 @@ public:
   Patch patch;
 };
 
+/* compressed sparse row adjacency between local indices */
+struct Csr {
+  std::vector<int> offsets;
+  std::vector<int> items;
+};
+
+/* a flat, read-only copy of everything patch construction
+   needs, built once per mesh so that patches can be assembled
+   concurrently from plain arrays.
+   for each dimension d below the element dimension we keep the
+   entities, whether they are shared with other parts, and the
+   element adjacency in both directions. */
+struct PatchMesh {
+  int dim;
+  int points_per_element;
+  std::vector<apf::MeshEntity*> elements;
+  std::vector<apf::MeshEntity*> entities[3];
+  std::vector<char> shared[3];
+  Csr down[3];
+  Csr up[3];
+  /* global coordinates of all integration points,
+     points_per_element consecutive entries per element */
+  std::vector<apf::Vector3> points;
+};
+
+static void numberEntities(apf::Mesh* m, int d, apf::MeshTag* tag,
+    std::vector<apf::MeshEntity*>& ents)
+{
+  ents.reserve(m->count(d));
+  apf::MeshIterator* it = m->begin(d);
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    int i = ents.size();
+    m->setIntTag(e, tag, &i);
+    ents.push_back(e);
+  }
+  m->end(it);
+}
+
+static void buildUpward(Csr const& down, int nents, Csr& up)
+{
+  int nelems = down.offsets.size() - 1;
+  up.offsets.assign(nents + 1, 0);
+  for (size_t i = 0; i < down.items.size(); ++i)
+    ++up.offsets[down.items[i] + 1];
+  for (int i = 0; i < nents; ++i)
+    up.offsets[i + 1] += up.offsets[i];
+  up.items.resize(down.items.size());
+  std::vector<int> fill(up.offsets.begin(), up.offsets.end() - 1);
+  for (int e = 0; e < nelems; ++e)
+    for (int j = down.offsets[e]; j < down.offsets[e + 1]; ++j)
+      up.items[fill[down.items[j]]++] = e;
+}
+
+static void buildPatchMesh(Recovery* r, PatchMesh& pm)
+{
+  apf::Mesh* m = r->mesh;
+  pm.dim = r->dim;
+  pm.points_per_element = r->points_per_element;
+  apf::MeshTag* tag = m->createIntTag("spr_index", 1);
+  numberEntities(m, pm.dim, tag, pm.elements);
+  int nelems = pm.elements.size();
+  for (int d = 0; d < pm.dim; ++d) {
+    numberEntities(m, d, tag, pm.entities[d]);
+    int nents = pm.entities[d].size();
+    pm.shared[d].resize(nents);
+    for (int i = 0; i < nents; ++i)
+      pm.shared[d][i] = m->isShared(pm.entities[d][i]);
+    Csr& down = pm.down[d];
+    down.offsets.resize(nelems + 1);
+    down.offsets[0] = 0;
+    for (int e = 0; e < nelems; ++e) {
+      apf::Downward ents;
+      int n = m->getDownward(pm.elements[e], d, ents);
+      for (int j = 0; j < n; ++j) {
+        int i;
+        m->getIntTag(ents[j], tag, &i);
+        down.items.push_back(i);
+      }
+      down.offsets[e + 1] = down.items.size();
+    }
+    buildUpward(down, nents, pm.up[d]);
+  }
+  for (int d = 0; d <= pm.dim; ++d)
+    apf::removeTagFromDimension(m, tag, d);
+  m->destroyTag(tag);
+  pm.points.resize(nelems * pm.points_per_element);
+  for (int e = 0; e < nelems; ++e) {
+    apf::MeshElement* me = apf::createMeshElement(m, pm.elements[e]);
+    for (int l = 0; l < pm.points_per_element; ++l) {
+      apf::Vector3 param;
+      apf::getIntPoint(me, r->order, l, param);
+      apf::mapLocalToGlobal(me, param,
+          pm.points[e * pm.points_per_element + l]);
+    }
+    apf::destroyMeshElement(me);
+  }
+}
+
+/* per-thread patch workspace */
+struct FlatPatch {
+  std::vector<int> elements;
+  std::vector<int> bridges;
+  std::vector<int> old_elements;
+  apf::NewArray<apf::Vector3> points;
+  QRDecomp qr;
+};
+
+static void makeUnique(std::vector<int>& v)
+{
+  std::sort(v.begin(), v.end());
+  v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+static void addUpward(FlatPatch& p, Csr const& up, int i)
+{
+  p.elements.insert(p.elements.end(),
+      up.items.begin() + up.offsets[i],
+      up.items.begin() + up.offsets[i + 1]);
+}
+
+static bool hasEnoughPoints(PatchMesh const& pm, Recovery* r, FlatPatch& p)
+{
+  int ppe = pm.points_per_element;
+  int np = ppe * p.elements.size();
+  if (np < r->polynomial_terms)
+    return false;
+  p.points.allocate(np);
+  for (size_t i = 0; i < p.elements.size(); ++i)
+    for (int l = 0; l < ppe; ++l)
+      p.points[i * ppe + l] = pm.points[p.elements[i] * ppe + l];
+  return preparePolynomialFit(r->dim, r->order, np, p.points, p.qr);
+}
+
+/* mirrors buildPatch, but returns false as soon as the patch
+   would touch a shared entity; such patches are left to the
+   CavityOp pass, which can migrate elements to complete them */
+static bool buildFlatPatch(PatchMesh const& pm, Recovery* r,
+    int d, int i, FlatPatch& p)
+{
+  p.elements.clear();
+  if (d == pm.dim)
+    p.elements.push_back(i);
+  else {
+    if (pm.shared[d][i])
+      return false;
+    addUpward(p, pm.up[d], i);
+  }
+  while (!hasEnoughPoints(pm, r, p)) {
+    p.old_elements = p.elements;
+    for (int sd = pm.dim - 1; sd >= 0; --sd) {
+      Csr const& down = pm.down[sd];
+      p.bridges.clear();
+      for (size_t j = 0; j < p.old_elements.size(); ++j) {
+        int e = p.old_elements[j];
+        p.bridges.insert(p.bridges.end(),
+            down.items.begin() + down.offsets[e],
+            down.items.begin() + down.offsets[e + 1]);
+      }
+      makeUnique(p.bridges);
+      for (size_t j = 0; j < p.bridges.size(); ++j) {
+        if (pm.shared[sd][p.bridges[j]])
+          return false;
+        addUpward(p, pm.up[sd], p.bridges[j]);
+      }
+      makeUnique(p.elements);
+      if (hasEnoughPoints(pm, r, p))
+        return true;
+    }
+    if (p.elements.size() == p.old_elements.size())
+      apf::fail("SPR: patch construction: all hope is lost.");
+  }
+  return true;
+}
+
+/* an entity that carries recovered nodes */
+struct Target {
+  int dim;
+  int index;
+  apf::MeshEntity* entity;
+  int num_nodes;
+  /* offset of its first node in the flat node arrays */
+  int first_node;
+};
+
+static void getTargets(PatchMesh const& pm, apf::Mesh* m,
+    std::vector<Target>& targets, std::vector<apf::Vector3>& nodes)
+{
+  apf::FieldShape* s = m->getShape();
+  for (int d = 0; d <= pm.dim; ++d) {
+    if (!s->hasNodesIn(d))
+      continue;
+    std::vector<apf::MeshEntity*> const& ents =
+      (d == pm.dim) ? pm.elements : pm.entities[d];
+    for (size_t i = 0; i < ents.size(); ++i) {
+      Target t;
+      t.dim = d;
+      t.index = i;
+      t.entity = ents[i];
+      t.num_nodes = s->countNodesOn(m->getType(ents[i]));
+      t.first_node = nodes.size();
+      for (int j = 0; j < t.num_nodes; ++j) {
+        apf::Vector3 x;
+        m->getPoint(ents[i], j, x);
+        nodes.push_back(x);
+      }
+      targets.push_back(t);
+    }
+  }
+}
+
+/* integration point values of one field, gathered into
+   element-major order matching PatchMesh::points */
+static void getIPValues(PatchMesh const& pm, apf::Field* f,
+    std::vector<double>& values)
+{
+  int nc = apf::countComponents(f);
+  int ppe = pm.points_per_element;
+  values.resize(pm.elements.size() * ppe * nc);
+  for (size_t e = 0; e < pm.elements.size(); ++e)
+    for (int l = 0; l < ppe; ++l)
+      apf::getComponents(f, pm.elements[e], l, &values[(e * ppe + l) * nc]);
+}
+
+static void fitPatch(PatchMesh const& pm, Recovery* r, FlatPatch& p,
+    std::vector<double> const& ip_values, apf::Vector3 const* nodes,
+    int num_nodes, double* out)
+{
+  int ppe = pm.points_per_element;
+  int nc = apf::countComponents(r->f);
+  int np = ppe * p.elements.size();
+  mth::Vector<double> values(np);
+  mth::Vector<double> coeffs;
+  for (int c = 0; c < nc; ++c) {
+    for (size_t i = 0; i < p.elements.size(); ++i)
+      for (int l = 0; l < ppe; ++l)
+        values(i * ppe + l) =
+          ip_values[(p.elements[i] * ppe + l) * nc + c];
+    runPolynomialFit(p.qr, values, coeffs);
+    for (int j = 0; j < num_nodes; ++j) {
+      apf::Vector3 x = nodes[j];
+      out[j * nc + c] = evalPolynomial(r->dim, r->order, x, coeffs);
+    }
+  }
+}
+
+/* recovers all entities whose patches are entirely local,
+   one thread per patch when OpenMP is enabled.
+   each patch is factored once and the factorization is applied
+   to every component of every field */
+static void recoverLocalPatches(std::vector<Recovery>& rs)
+{
+  Recovery* r0 = &rs[0];
+  apf::Mesh* m = r0->mesh;
+  PatchMesh pm;
+  buildPatchMesh(r0, pm);
+  std::vector<Target> targets;
+  std::vector<apf::Vector3> nodes;
+  getTargets(pm, m, targets, nodes);
+  size_t nf = rs.size();
+  std::vector<std::vector<double> > ip_values(nf);
+  std::vector<std::vector<double> > results(nf);
+  for (size_t k = 0; k < nf; ++k) {
+    getIPValues(pm, rs[k].f, ip_values[k]);
+    results[k].resize(nodes.size() * apf::countComponents(rs[k].f));
+  }
+  int nt = targets.size();
+  std::vector<char> done(nt, 0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    FlatPatch p;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+    for (int t = 0; t < nt; ++t) {
+      Target const& tg = targets[t];
+      if (!buildFlatPatch(pm, r0, tg.dim, tg.index, p))
+        continue;
+      for (size_t k = 0; k < nf; ++k) {
+        int nc = apf::countComponents(rs[k].f);
+        fitPatch(pm, &rs[k], p, ip_values[k], &nodes[tg.first_node],
+            tg.num_nodes, &results[k][tg.first_node * nc]);
+      }
+      done[t] = 1;
+    }
+  }
+  for (size_t k = 0; k < nf; ++k) {
+    int nc = apf::countComponents(rs[k].f);
+    for (int t = 0; t < nt; ++t) {
+      if (!done[t])
+        continue;
+      Target const& tg = targets[t];
+      for (int j = 0; j < tg.num_nodes; ++j)
+        apf::setComponents(rs[k].f_star, tg.entity, j,
+            &results[k][(tg.first_node + j) * nc]);
+    }
+  }
+}
+
+std::vector<apf::Field*> recoverFields(
+    std::vector<apf::Field*> const& ip_fields)
+{
+  std::vector<apf::Field*> out;
+  if (ip_fields.empty())
+    return out;
+  std::vector<Recovery> rs(ip_fields.size());
+  for (size_t k = 0; k < ip_fields.size(); ++k) {
+    setupRecovery(&rs[k], ip_fields[k]);
+    PCU_ALWAYS_ASSERT_VERBOSE(
+        apf::getShape(ip_fields[k]) == apf::getShape(ip_fields[0]),
+        "SPR: recovered fields must share an integration point shape");
+  }
+  recoverLocalPatches(rs);
+  for (size_t k = 0; k < rs.size(); ++k) {
+    PatchOp op(&rs[k]);
+    for (int d = 0; d <= 3; ++d)
+      if (rs[k].mesh->getShape()->hasNodesIn(d))
+        op.applyToDimension(d);
+    out.push_back(rs[k].f_star);
+  }
+  return out;
+}
+
 apf::Field* recoverField(apf::Field* f)
 {
-  Recovery recovery;
-  setupRecovery(&recovery, f);
-  PatchOp op(&recovery);
-  for (int d = 0; d <= 3; ++d)
-    if (recovery.mesh->getShape()->hasNodesIn(d))
-      op.applyToDimension(d);
-  return recovery.f_star;
+  std::vector<apf::Field*> fs(1, f);
+  return recoverFields(fs)[0];
 }
 
 }
@@ -0,0 +1,105 @@
+#include <gmi_mesh.h>
+#include <apfMDS.h>
+#include <apfMesh2.h>
+#include <apf.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <string>
+
+/* writes a mesh with a field as a single-file checkpoint,
+   loads it back on all ranks, on one rank fewer, and from
+   there on all ranks again, and checks that nothing was lost */
+
+static void countOwned(apf::Mesh* m, long counts[4])
+{
+  for (int d = 0; d < 4; ++d) {
+    counts[d] = 0;
+    if (d > m->getDimension())
+      continue;
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it)))
+      if (m->isOwned(e))
+        ++counts[d];
+    m->end(it);
+  }
+  PCU_Add_Longs(counts, 4);
+}
+
+static void checkField(apf::Mesh* m)
+{
+  apf::Field* f = m->findField("checkpoint_coords");
+  PCU_ALWAYS_ASSERT(f);
+  apf::MeshIterator* it = m->begin(0);
+  apf::MeshEntity* v;
+  while ((v = m->iterate(it))) {
+    apf::Vector3 x;
+    apf::Vector3 y;
+    m->getPoint(v, 0, x);
+    apf::getVector(f, v, 0, y);
+    PCU_ALWAYS_ASSERT(x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+  }
+  m->end(it);
+}
+
+static apf::Mesh2* load(const char* model, const char* path,
+    long const before[4])
+{
+  apf::Mesh2* m = apf::loadMdsCheckpoint(gmi_load(model), path);
+  m->verify();
+  long after[4];
+  countOwned(m, after);
+  for (int d = 0; d < 4; ++d)
+    PCU_ALWAYS_ASSERT(before[d] == after[d]);
+  checkField(m);
+  return m;
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 4);
+  lion_set_verbosity(1);
+  gmi_register_mesh();
+  apf::Mesh2* m = apf::loadMdsMesh(argv[1], argv[2]);
+  apf::Field* f = apf::createFieldOn(m, "checkpoint_coords", apf::VECTOR);
+  apf::MeshIterator* it = m->begin(0);
+  apf::MeshEntity* v;
+  while ((v = m->iterate(it))) {
+    apf::Vector3 x;
+    m->getPoint(v, 0, x);
+    apf::setVector(f, v, 0, x);
+  }
+  m->end(it);
+  long before[4];
+  countOwned(m, before);
+  apf::writeMdsCheckpoint(m, argv[3]);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  m = load(argv[1], argv[3], before);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  /* merge the parts onto one rank fewer, then split them back */
+  std::string fewer = std::string(argv[3]) + ".fewer";
+  int self = PCU_Comm_Self();
+  bool inGroup = self < PCU_Comm_Peers() - 1;
+  MPI_Comm prevComm = PCU_Get_Comm();
+  MPI_Comm groupComm;
+  MPI_Comm_split(prevComm, inGroup, self, &groupComm);
+  PCU_Switch_Comm(groupComm);
+  if (inGroup) {
+    m = load(argv[1], argv[3], before);
+    apf::writeMdsCheckpoint(m, fewer.c_str());
+    m->destroyNative();
+    apf::destroyMesh(m);
+  }
+  PCU_Switch_Comm(prevComm);
+  MPI_Comm_free(&groupComm);
+  m = load(argv[1], fewer.c_str(), before);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,151 @@
+#include <gmi_null.h>
+#include <apfMDS.h>
+#include <apfMesh2.h>
+#include <apfConvert.h>
+#include <apfCSR.h>
+#include <apf.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <cstdlib>
+#include <vector>
+
+/* builds an n^3 box of tets from a connectivity array spread over
+   all ranks, then takes it apart again with apf::destruct and
+   apf::extractCoords and checks that rebuilding from those arrays
+   gives back every vertex at the same place */
+
+static int n;
+
+static int getGid(int i, int j, int k)
+{
+  return i + (n + 1) * (j + (n + 1) * k);
+}
+
+static apf::Vector3 getPoint(int gid)
+{
+  int i = gid % (n + 1);
+  int j = (gid / (n + 1)) % (n + 1);
+  int k = gid / ((n + 1) * (n + 1));
+  return apf::Vector3(i, j * 1.5, k * 0.5 + 0.1 * i);
+}
+
+static void addTet(std::vector<int>& conn, int v[4])
+{
+  apf::Vector3 x[4];
+  for (int i = 0; i < 4; ++i)
+    x[i] = getPoint(v[i]);
+  if (apf::cross(x[1] - x[0], x[2] - x[0]) * (x[3] - x[0]) < 0)
+    std::swap(v[2], v[3]);
+  conn.insert(conn.end(), v, v + 4);
+}
+
+/* six tets per cube along the paths from its low to its high corner */
+static void getConnectivity(std::vector<int>& conn)
+{
+  static int const perms[6][3] =
+  {{0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}};
+  int cubes = n * n * n;
+  int first = long(cubes) * PCU_Comm_Self() / PCU_Comm_Peers();
+  int last = long(cubes) * (PCU_Comm_Self() + 1) / PCU_Comm_Peers();
+  for (int c = first; c < last; ++c) {
+    int at[3] = {c % n, (c / n) % n, c / (n * n)};
+    for (int p = 0; p < 6; ++p) {
+      int x[3] = {at[0], at[1], at[2]};
+      int v[4];
+      v[0] = getGid(x[0], x[1], x[2]);
+      for (int s = 0; s < 3; ++s) {
+        ++x[perms[p][s]];
+        v[s + 1] = getGid(x[0], x[1], x[2]);
+      }
+      addTet(conn, v);
+    }
+  }
+}
+
+static void getCoords(std::vector<double>& coords)
+{
+  int total = (n + 1) * (n + 1) * (n + 1);
+  int first = long(total) * PCU_Comm_Self() / PCU_Comm_Peers();
+  int last = long(total) * (PCU_Comm_Self() + 1) / PCU_Comm_Peers();
+  for (int g = first; g < last; ++g) {
+    apf::Vector3 x = getPoint(g);
+    coords.insert(coords.end(), &x[0], &x[0] + 3);
+  }
+}
+
+static apf::Mesh2* build(gmi_model* model, int const* conn, int nelem,
+    double const* coords, int nverts, apf::GlobalToVert& globalToVert)
+{
+  apf::Mesh2* m = apf::makeEmptyMdsMesh(model, 3, false);
+  apf::construct(m, conn, nelem, apf::Mesh::TET, globalToVert);
+  apf::alignMdsRemotes(m);
+  apf::deriveMdsModel(m);
+  apf::setCoords(m, coords, nverts, globalToVert);
+  m->verify();
+  return m;
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  gmi_register_null();
+  n = argc > 1 ? atoi(argv[1]) : 6;
+  std::vector<int> conn;
+  getConnectivity(conn);
+  std::vector<double> coords;
+  getCoords(coords);
+  apf::GlobalToVert inMap;
+  apf::Mesh2* m = build(gmi_load(".null"), &conn[0], conn.size() / 4,
+      &coords[0], coords.size() / 3, inMap);
+  for (apf::GlobalToVert::iterator it = inMap.begin();
+       it != inMap.end(); ++it) {
+    apf::Vector3 x;
+    m->getPoint(it->second, 0, x);
+    PCU_ALWAYS_ASSERT((x - getPoint(it->first)).getLength() == 0);
+  }
+  PCU_ALWAYS_ASSERT(PCU_Add_Long(m->count(3)) == 6L * n * n * n);
+
+  /* the CSR export and destruct agree on the global vertex ids */
+  apf::MeshArrays a;
+  apf::exportMeshArrays(m, a);
+  int* outConn;
+  int nelem;
+  int etype;
+  apf::destruct(m, outConn, nelem, etype);
+  PCU_ALWAYS_ASSERT(etype == apf::Mesh::TET);
+  PCU_ALWAYS_ASSERT(nelem == int(a.elems.size()));
+  for (int i = 0; i < nelem * 4; ++i)
+    PCU_ALWAYS_ASSERT(outConn[i] == a.vertGlobals[a.elemVerts.items[i]]);
+  double* outCoords;
+  int nverts;
+  apf::extractCoords(m, outCoords, nverts);
+  PCU_ALWAYS_ASSERT(nverts == a.ownedVerts);
+
+  /* rebuild from the exported arrays: the same elements stay
+     on each rank, so every local vertex has a counterpart */
+  apf::GlobalToVert outMap;
+  apf::Mesh2* m2 = build(gmi_load(".null"), outConn, nelem,
+      outCoords, nverts, outMap);
+  delete [] outConn;
+  delete [] outCoords;
+  PCU_ALWAYS_ASSERT(m2->count(0) == m->count(0));
+  for (size_t i = 0; i < a.verts.size(); ++i) {
+    apf::Vector3 x(&a.coords[i * 3]);
+    apf::Vector3 y;
+    m2->getPoint(outMap[a.vertGlobals[i]], 0, y);
+    PCU_ALWAYS_ASSERT((x - y).getLength() == 0);
+  }
+  if (!PCU_Comm_Self())
+    lion_oprint(1, "round trip of %d vertices done\n",
+        (n + 1) * (n + 1) * (n + 1));
+
+  m2->destroyNative();
+  apf::destroyMesh(m2);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
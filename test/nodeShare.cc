@@ -0,0 +1,164 @@
+#include <gmi.h>
+#include <gmi_base.h>
+#include <apf.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfMesh2.h>
+#include <apfShape.h>
+#include <apfNodeSync.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+/* shares a box model over each compute node and checks
+   that model queries give what they gave before, then
+   checks apf::NodeSynchronizer against apf::synchronize, and
+   finally unshares the model so that each rank can destroy
+   its mesh on its own */
+
+/* the answers to every adjacency, closure and tag query,
+   by dimension and tag, and the agm topology under them */
+static void query(gmi_model* g, std::vector<int>& answers)
+{
+  answers.clear();
+  std::vector<gmi_ent*> all;
+  for (int d = 0; d <= 3; ++d) {
+    gmi_iter* it = gmi_begin(g, d);
+    gmi_ent* e;
+    while ((e = gmi_next(g, it)))
+      all.push_back(e);
+    gmi_end(g, it);
+  }
+  agm* topo = gmi_base_topo(g);
+  for (size_t i = 0; i < all.size(); ++i) {
+    int d = gmi_dim(g, all[i]);
+    int tag = gmi_tag(g, all[i]);
+    answers.push_back(tag);
+    answers.push_back(gmi_find(g, d, tag) == all[i]);
+    agm_ent a = agm_from_gmi(all[i]);
+    answers.push_back(agm_use_count_of(topo, a));
+    answers.push_back(agm_bdry_count_of(topo, a));
+    answers.push_back(agm_down_count(topo, a));
+    for (int to = d - 1; to <= d + 1; to += 2) {
+      if (to < 0 || to > 3)
+        continue;
+      gmi_set* s = gmi_adjacent(g, all[i], to);
+      answers.push_back(s->n);
+      for (int j = 0; j < s->n; ++j)
+        answers.push_back(gmi_tag(g, s->e[j]));
+      gmi_free_set(s);
+    }
+    for (size_t j = 0; j < all.size(); ++j)
+      answers.push_back(gmi_is_in_closure_of(g, all[i], all[j]));
+  }
+}
+
+static apf::Vector3 getValue(apf::Mesh* m, apf::MeshEntity* e, int pass)
+{
+  apf::Vector3 x = apf::getLinearCentroid(m, e);
+  return apf::Vector3(std::sin(5 * x[0] + pass), x[1] * x[2],
+      std::cos(3 * x[2]) - pass);
+}
+
+/* owners get the values of this pass, copies get garbage */
+static void setValues(apf::Field* f, int pass)
+{
+  apf::Mesh* m = apf::getMesh(f);
+  apf::FieldShape* s = apf::getShape(f);
+  for (int d = 0; d <= 3; ++d) {
+    if (!s->hasNodesIn(d))
+      continue;
+    apf::MeshEntity* e;
+    apf::MeshIterator* it = m->begin(d);
+    while ((e = m->iterate(it))) {
+      apf::Vector3 v(-1, -1, -1);
+      if (m->isOwned(e))
+        v = getValue(m, e, pass);
+      int nn = s->countNodesOn(m->getType(e));
+      for (int i = 0; i < nn; ++i)
+        apf::setVector(f, e, i, v);
+    }
+    m->end(it);
+  }
+}
+
+static long countDifferences(apf::Field* a, apf::Field* b)
+{
+  apf::Mesh* m = apf::getMesh(a);
+  apf::FieldShape* s = apf::getShape(a);
+  long bad = 0;
+  for (int d = 0; d <= 3; ++d) {
+    if (!s->hasNodesIn(d))
+      continue;
+    apf::MeshEntity* e;
+    apf::MeshIterator* it = m->begin(d);
+    while ((e = m->iterate(it))) {
+      int nn = s->countNodesOn(m->getType(e));
+      for (int i = 0; i < nn; ++i) {
+        apf::Vector3 u;
+        apf::Vector3 v;
+        apf::getVector(a, e, i, u);
+        apf::getVector(b, e, i, v);
+        if ((u - v).getLength() != 0)
+          ++bad;
+      }
+    }
+    m->end(it);
+  }
+  return PCU_Add_Long(bad);
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  PCU_ALWAYS_ASSERT(PCU_Comm_Peers() > 1);
+  int n = argc > 1 ? atoi(argv[1]) : 4;
+  apf::Mesh2* m = apf::makeMdsBoxOnParts(n, n, n, 1, 1, 1, true);
+  gmi_model* g = m->getModel();
+
+  std::vector<int> before;
+  query(g, before);
+  gmi_base_share(g);
+  std::vector<int> shared;
+  query(g, shared);
+  PCU_ALWAYS_ASSERT(shared == before);
+
+  apf::Field* f = apf::createLagrangeField(m, "node", apf::VECTOR, 2);
+  apf::Field* r = apf::createLagrangeField(m, "message", apf::VECTOR, 2);
+  /* the plan covers the entities that have values */
+  setValues(f, 0);
+  apf::NodeSynchronizer* sync = new apf::NodeSynchronizer(f);
+  long bad = 0;
+  for (int pass = 0; pass < 3; ++pass) {
+    setValues(f, pass);
+    setValues(r, pass);
+    sync->run();
+    apf::synchronize(r);
+    bad += countDifferences(f, r);
+  }
+  delete sync;
+  if (!PCU_Comm_Self())
+    lion_oprint(1, "%ld synchronized values differ\n", bad);
+  PCU_ALWAYS_ASSERT(bad == 0);
+
+  gmi_base_unshare(g);
+  std::vector<int> after;
+  query(g, after);
+  PCU_ALWAYS_ASSERT(after == before);
+  /* with the model private again, ranks destroy
+     their meshes and the model one at a time */
+  for (int i = 0; i < PCU_Comm_Peers(); ++i) {
+    if (i == PCU_Comm_Self()) {
+      m->destroyNative();
+      apf::destroyMesh(m);
+    }
+    PCU_Barrier();
+  }
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -732,6 +732,8 @@ void TEST_FIELD(pMesh m)
     pumi_field_synchronize(f); // broadcast result to other partitions
   } 
 
+  pumi_field_synchronizeCached(f); // the same values through a stored plan
+
 
   it = m->begin(0);
   while ((e = m->iterate(it)))
@@ -813,6 +815,7 @@ void TEST_GHOSTING(pMesh m)
     PCU_ALWAYS_ASSERT(org_mcount[i] == pumi_mesh_getNumEnt(m, i));
 
   // layer-wise ghosting test
+  std::vector<int> layer_mcount;
   for (int brg_dim=mesh_dim-1; brg_dim>=0; --brg_dim)
     for (int num_layer=1; num_layer<=3; ++num_layer)
       for (int include_copy=0; include_copy<=1; ++include_copy)
@@ -824,10 +827,58 @@ void TEST_GHOSTING(pMesh m)
         if (!pumi_rank()) std::cout<<"\n[test_pumi] layer-wise pumi_ghost_createLayer (bd "<<brg_dim<<", gd "<<mesh_dim<<", nl "<<num_layer<<", ic"<<include_copy<<"), #ghost increase="<<total_mcount_diff<<"\n";
         pumi_mesh_verify(m);
         TEST_FIELD(m);
+        layer_mcount.push_back(pumi_mesh_getNumEnt(m, mesh_dim));
         pumi_ghost_delete(m);
         for (int i=0; i<4; ++i)
           PCU_ALWAYS_ASSERT(org_mcount[i] == pumi_mesh_getNumEnt(m, i));
       }
+
+  // incremental layer-ghosting: each update from the previous layers
+  // gives the same ghost copies as creating the layers afresh
+  size_t layer=0;
+  for (int brg_dim=mesh_dim-1; brg_dim>=0; --brg_dim)
+    for (int num_layer=1; num_layer<=3; ++num_layer)
+      for (int include_copy=0; include_copy<=1; ++include_copy)
+      {
+        pumi_ghost_updateLayer (m, brg_dim, mesh_dim, num_layer, include_copy);
+        pumi_mesh_verify(m);
+        TEST_FIELD(m);
+        PCU_ALWAYS_ASSERT(layer_mcount[layer++] == pumi_mesh_getNumEnt(m, mesh_dim));
+      }
+  // the next update with the same input grows only the layers the mesh
+  // changed, here none, as the rebuilt element next to the ghosted ones
+  // is in no layer
+  pumi_ghost_updateLayer (m, mesh_dim-1, mesh_dim, 1, 1);
+  {
+    pMeshEnt e, rebuilt=NULL;
+    pMeshIter mit = m->begin(mesh_dim);
+    while (!rebuilt && (e = m->iterate(mit)))
+    {
+      if (m->isGhost(e) || m->isGhosted(e)) continue;
+      Adjacent adj;
+      pumi_ment_get2ndAdjacent(e, mesh_dim-1, mesh_dim, adj);
+      for (size_t i=0; i<adj.getSize(); ++i)
+        if (m->isGhosted(adj[i])) rebuilt=e;
+    }
+    m->end(mit);
+    if (rebuilt)
+    {
+      apf::Downward down;
+      m->getDownward(rebuilt, mesh_dim-1, down);
+      int type = m->getType(rebuilt);
+      apf::ModelEntity* c = m->toModel(rebuilt);
+      m->destroy(rebuilt);
+      m->createEntity(type, c, down);
+    }
+    m->acceptChanges();
+    pumi_ghost_updateLayer (m, mesh_dim-1, mesh_dim, 1, 1);
+    pumi_mesh_verify(m);
+    TEST_FIELD(m);
+    PCU_ALWAYS_ASSERT(layer_mcount[1] == pumi_mesh_getNumEnt(m, mesh_dim));
+  }
+  pumi_ghost_updateLayer (m, 0, mesh_dim, 0, 0);
+  for (int i=0; i<4; ++i)
+    PCU_ALWAYS_ASSERT(org_mcount[i] == pumi_mesh_getNumEnt(m, i));
   
   // accumulative layer-ghosting
   for (int brg_dim=mesh_dim-1; brg_dim>=0; --brg_dim)
@@ -0,0 +1,114 @@
+#include <ma.h>
+#include <apf.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfMesh2.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+/* refines the same mesh with and without the bulk uniform
+   refinement path and checks that both give the same entities
+   and the same transferred field values */
+
+static void setFields(apf::Mesh* m)
+{
+  apf::Field* s = apf::createFieldOn(m, "scalar", apf::SCALAR);
+  apf::Field* v = apf::createFieldOn(m, "vector", apf::VECTOR);
+  apf::MeshEntity* e;
+  apf::MeshIterator* it = m->begin(0);
+  while ((e = m->iterate(it))) {
+    apf::Vector3 x;
+    m->getPoint(e, 0, x);
+    apf::setScalar(s, e, 0, std::sin(4 * x[0]) + x[1] * x[2]);
+    apf::setVector(v, e, 0,
+        apf::Vector3(x[0] * x[1], std::cos(3 * x[2]), x[0] - x[2]));
+  }
+  m->end(it);
+}
+
+typedef std::vector<double> Key;
+typedef std::map<Key, std::vector<double> > Values;
+
+/* field values by vertex position, which both
+   refinements put at the same places */
+static void getValues(apf::Mesh* m, Values& values)
+{
+  apf::Field* s = m->findField("scalar");
+  apf::Field* v = m->findField("vector");
+  apf::MeshEntity* e;
+  apf::MeshIterator* it = m->begin(0);
+  while ((e = m->iterate(it))) {
+    apf::Vector3 x;
+    m->getPoint(e, 0, x);
+    Key k(3);
+    for (int i = 0; i < 3; ++i)
+      k[i] = std::floor(x[i] * 1e8 + 0.5);
+    apf::Vector3 u;
+    apf::getVector(v, e, 0, u);
+    std::vector<double>& val = values[k];
+    val.push_back(apf::getScalar(s, e, 0));
+    val.insert(val.end(), &u[0], &u[0] + 3);
+  }
+  m->end(it);
+}
+
+static apf::Mesh2* refine(int n, bool bulk, long counts[4])
+{
+  apf::Mesh2* m = apf::makeMdsBoxOnParts(n, n, n, 1, 1, 1, true);
+  setFields(m);
+  ma::Input* in = ma::configureUniformRefine(m, 2);
+  in->shouldRefineUniformly = bulk;
+  in->shouldFixShape = false;
+  ma::adapt(in);
+  m->verify();
+  for (int d = 0; d <= 3; ++d)
+    counts[d] = apf::countOwned(m, d);
+  PCU_Add_Longs(counts, 4);
+  return m;
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  int n = argc > 1 ? atoi(argv[1]) : 3;
+  long bulkCounts[4];
+  long generalCounts[4];
+  apf::Mesh2* bulk = refine(n, true, bulkCounts);
+  apf::Mesh2* general = refine(n, false, generalCounts);
+  for (int d = 0; d <= 3; ++d)
+    PCU_ALWAYS_ASSERT(bulkCounts[d] == generalCounts[d]);
+  PCU_ALWAYS_ASSERT(bulkCounts[3] == 6L * 64 * n * n * n);
+  Values bulkValues;
+  Values generalValues;
+  getValues(bulk, bulkValues);
+  getValues(general, generalValues);
+  PCU_ALWAYS_ASSERT(bulkValues.size() == bulk->count(0));
+  PCU_ALWAYS_ASSERT(bulkValues.size() == generalValues.size());
+  long bad = 0;
+  for (Values::iterator it = bulkValues.begin();
+       it != bulkValues.end(); ++it) {
+    Values::iterator other = generalValues.find(it->first);
+    PCU_ALWAYS_ASSERT(other != generalValues.end());
+    for (size_t i = 0; i < it->second.size(); ++i)
+      if (std::fabs(it->second[i] - other->second[i]) > 1e-12)
+        ++bad;
+  }
+  bad = PCU_Add_Long(bad);
+  if (!PCU_Comm_Self())
+    lion_oprint(1, "%ld tets, %ld transferred values differ\n",
+        bulkCounts[3], bad);
+  PCU_ALWAYS_ASSERT(bad == 0);
+  general->destroyNative();
+  apf::destroyMesh(general);
+  bulk->destroyNative();
+  apf::destroyMesh(bulk);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,74 @@
+#include <gmi_mesh.h>
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfMDS.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#ifdef HAVE_SIMMETRIX
+#include <gmi_sim.h>
+#include <SimUtil.h>
+#include <MeshSim.h>
+#include <SimModel.h>
+#endif
+#include <cstdlib>
+
+/* splits each part along a space-filling curve and writes
+   the result without ever holding the larger partition,
+   so it can run on as many ranks as the input has parts */
+
+namespace {
+
+const char* modelFile = 0;
+const char* meshFile = 0;
+const char* outFile = 0;
+int partitionFactor = 1;
+
+void getConfig(int argc, char** argv)
+{
+  if ( argc != 5 ) {
+    if ( !PCU_Comm_Self() )
+      printf("Usage: %s <model> <mesh> <outMesh> <factor>\n", argv[0]);
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+  }
+  modelFile = argv[1];
+  meshFile = argv[2];
+  outFile = argv[3];
+  partitionFactor = atoi(argv[4]);
+  if (partitionFactor < 1) {
+    if ( !PCU_Comm_Self() )
+      printf("the factor must be positive\n");
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+  }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+#ifdef HAVE_SIMMETRIX
+  MS_init();
+  SimModel_start();
+  Sim_readLicenseFile(0);
+  gmi_sim_start();
+  gmi_register_sim();
+#endif
+  gmi_register_mesh();
+  getConfig(argc,argv);
+  apf::Mesh2* m = apf::loadMdsMesh(modelFile, meshFile);
+  apf::writeSplitMdsMesh(m, partitionFactor, outFile);
+  m->destroyNative();
+  apf::destroyMesh(m);
+#ifdef HAVE_SIMMETRIX
+  gmi_sim_stop();
+  Sim_unregisterAllKeys();
+  SimModel_stop();
+  MS_exit();
+#endif
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,134 @@
+#include <ma.h>
+#include <maShape.h>
+#include <apf.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfMesh2.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <cmath>
+#include <cstdlib>
+
+/* perturbs the interior of a box spread over several parts,
+   then adapts it with vertex smoothing on and nothing else to
+   do, and checks that the mesh got no worse and that the parts
+   still agree on where their shared vertices are */
+
+/* a function of position, so all copies of a vertex move alike */
+static void perturb(apf::Mesh2* m, double h)
+{
+  apf::MeshEntity* v;
+  apf::MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    if (m->getModelType(m->toModel(v)) != 3)
+      continue;
+    apf::Vector3 x;
+    m->getPoint(v, 0, x);
+    apf::Vector3 d(std::sin(37 * x[1] + 11 * x[2]),
+                   std::sin(29 * x[2] + 13 * x[0]),
+                   std::sin(23 * x[0] + 17 * x[1]));
+    m->setPoint(v, 0, x + d * (0.15 * h));
+  }
+  m->end(it);
+}
+
+class Uniform : public ma::IsotropicFunction
+{
+  public:
+    Uniform(double h_):h(h_) {}
+    virtual double getValue(ma::Entity*)
+    {
+      return h;
+    }
+  private:
+    double h;
+};
+
+static void measure(apf::Mesh* m, double& worst, double& average)
+{
+  worst = 1;
+  double sum = 0;
+  apf::MeshEntity* e;
+  apf::MeshIterator* it = m->begin(3);
+  while ((e = m->iterate(it))) {
+    ma::Vector x[4];
+    ma::getVertPoints(m, e, x);
+    double q = ma::measureLinearTetQuality(x);
+    worst = std::min(worst, q);
+    sum += q;
+  }
+  m->end(it);
+  worst = PCU_Min_Double(worst);
+  average = PCU_Add_Double(sum) / PCU_Add_Long(m->count(3));
+}
+
+/* every part sends the coordinates of its shared
+   vertices to their copies, which must have the same */
+static long countMismatches(apf::Mesh* m)
+{
+  PCU_Comm_Begin();
+  apf::MeshEntity* v;
+  apf::MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    if (!m->isShared(v))
+      continue;
+    apf::Vector3 x;
+    m->getPoint(v, 0, x);
+    apf::Copies remotes;
+    m->getRemotes(v, remotes);
+    APF_ITERATE(apf::Copies, remotes, rit) {
+      PCU_COMM_PACK(rit->first, rit->second);
+      PCU_COMM_PACK(rit->first, x);
+    }
+  }
+  m->end(it);
+  PCU_Comm_Send();
+  long bad = 0;
+  while (PCU_Comm_Receive()) {
+    apf::MeshEntity* r;
+    apf::Vector3 x;
+    PCU_COMM_UNPACK(r);
+    PCU_COMM_UNPACK(x);
+    apf::Vector3 y;
+    m->getPoint(r, 0, y);
+    if ((x - y).getLength() != 0)
+      ++bad;
+  }
+  return PCU_Add_Long(bad);
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  int n = argc > 1 ? atoi(argv[1]) : 6;
+  double h = 1.0 / n;
+  apf::Mesh2* m = apf::makeMdsBoxOnParts(n, n, n, 1, 1, 1, true);
+  perturb(m, h);
+  m->verify();
+  double worstBefore, averageBefore;
+  measure(m, worstBefore, averageBefore);
+  Uniform size(h);
+  ma::Input* in = ma::configure(m, &size);
+  in->maximumIterations = 0;
+  in->shouldFixShape = false;
+  in->shouldSmooth = true;
+  ma::adapt(in);
+  m->verify();
+  double worstAfter, averageAfter;
+  measure(m, worstAfter, averageAfter);
+  long bad = countMismatches(m);
+  if (!PCU_Comm_Self())
+    lion_oprint(1, "quality min %f -> %f, average %f -> %f, "
+        "%ld shared vertices differ\n", worstBefore, worstAfter,
+        averageBefore, averageAfter, bad);
+  PCU_ALWAYS_ASSERT(worstAfter >= worstBefore);
+  PCU_ALWAYS_ASSERT(averageAfter >= averageBefore);
+  PCU_ALWAYS_ASSERT(bad == 0);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
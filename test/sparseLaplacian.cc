@@ -0,0 +1,151 @@
+#include <dsp.h>
+#include <apf.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfMesh2.h>
+#include <ma.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <cmath>
+#include <cstdlib>
+
+static apf::Vector3 getLinear(apf::Vector3 const& x)
+{
+  return apf::Vector3(0.1 * x[0] + 0.05 * x[1], 0.02 * x[2],
+      0.03 * (x[0] - x[2]));
+}
+
+/* the whole model boundary moves, interior vertices are solved for */
+static void getBoundary(apf::Mesh* m, dsp::Boundary& moving)
+{
+  apf::MeshEntity* v;
+  apf::MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it)))
+    if (m->getModelType(m->toModel(v)) < 3)
+      moving.insert(m->toModel(v));
+  m->end(it);
+}
+
+static apf::Field* makeDisplacement(apf::Mesh* m, dsp::Boundary& moving)
+{
+  apf::Field* df = apf::createFieldOn(m, "dsp", apf::VECTOR);
+  apf::MeshEntity* v;
+  apf::MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    apf::Vector3 x;
+    m->getPoint(v, 0, x);
+    if (moving.count(m->toModel(v)))
+      apf::setVector(df, v, 0, getLinear(x));
+    else
+      apf::setVector(df, v, 0, apf::Vector3(0,0,0));
+  }
+  m->end(it);
+  return df;
+}
+
+/* the largest assembled graph Laplacian row at interior vertices,
+   each edge counted once on its owning part */
+static double getResidual(apf::Mesh* m, apf::Field* df,
+    dsp::Boundary& moving)
+{
+  apf::Field* r = apf::createFieldOn(m, "residual", apf::VECTOR);
+  apf::zeroField(r);
+  apf::MeshEntity* e;
+  apf::MeshIterator* it = m->begin(1);
+  while ((e = m->iterate(it))) {
+    if (!m->isOwned(e))
+      continue;
+    apf::MeshEntity* ev[2];
+    m->getDownward(e, 0, ev);
+    apf::Vector3 d[2];
+    for (int i = 0; i < 2; ++i)
+      apf::getVector(df, ev[i], 0, d[i]);
+    for (int i = 0; i < 2; ++i) {
+      apf::Vector3 s;
+      apf::getVector(r, ev[i], 0, s);
+      apf::setVector(r, ev[i], 0, s + d[i] - d[1 - i]);
+    }
+  }
+  m->end(it);
+  apf::accumulate(r);
+  double worst = 0;
+  apf::MeshEntity* v;
+  it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    if (moving.count(m->toModel(v)))
+      continue;
+    apf::Vector3 s;
+    apf::getVector(r, v, 0, s);
+    worst = std::max(worst, s.getLength());
+  }
+  m->end(it);
+  apf::destroyField(r);
+  return PCU_Max_Double(worst);
+}
+
+static double getLinearError(apf::Mesh* m, apf::Field* df)
+{
+  double worst = 0;
+  apf::MeshEntity* v;
+  apf::MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    apf::Vector3 x;
+    m->getPoint(v, 0, x);
+    apf::Vector3 d;
+    apf::getVector(df, v, 0, d);
+    worst = std::max(worst, (d - getLinear(x)).getLength());
+  }
+  m->end(it);
+  return PCU_Max_Double(worst);
+}
+
+static void check(apf::Mesh2* m, dsp::Smoother* smoother)
+{
+  dsp::Boundary fixed;
+  dsp::Boundary moving;
+  getBoundary(m, moving);
+  apf::Field* df = makeDisplacement(m, moving);
+  smoother->preprocess(m, fixed, moving);
+  smoother->smooth(df, fixed, moving);
+  smoother->cleanup();
+  double residual = getResidual(m, df, moving);
+  double error = getLinearError(m, df);
+  if (!PCU_Comm_Self())
+    lion_oprint(1, "%ld vertices: residual %e, linear error %e\n",
+        apf::countOwned(m, 0), residual, error);
+  PCU_ALWAYS_ASSERT(residual < 1e-8);
+  PCU_ALWAYS_ASSERT(error < 1e-8);
+  apf::destroyField(df);
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  int n = argc > 1 ? atoi(argv[1]) : 12;
+  apf::Mesh2* m = apf::makeMdsBoxOnParts(n, n, n, 1, 1, 1, true);
+  dsp::Smoother* smoother = dsp::Smoother::makeSparseLaplacian(1e-12);
+  /* the second check reuses the assembled system */
+  check(m, smoother);
+  check(m, smoother);
+  /* and the displacement driver moves the mesh with it */
+  dsp::Boundary fixed;
+  dsp::Boundary moving;
+  getBoundary(m, moving);
+  apf::Field* df = makeDisplacement(m, moving);
+  dsp::Adapter* adapter = dsp::Adapter::makeEmpty();
+  dsp::displace(m, df, smoother, adapter, fixed, moving);
+  apf::destroyField(df);
+  delete adapter;
+  /* topology changes need a new system */
+  ma::runUniformRefinement(m);
+  smoother->invalidate();
+  check(m, smoother);
+  delete smoother;
+  m->destroyNative();
+  apf::destroyMesh(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,91 @@
+#include <spr.h>
+#include <apfMesh2.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfShape.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static void setSolution(apf::Field* f)
+{
+  apf::Mesh* m = apf::getMesh(f);
+  apf::MeshEntity* v;
+  apf::MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    apf::Vector3 x;
+    m->getPoint(v, 0, x);
+    apf::Vector3 u(x[0] * x[0], x[1] * x[2], std::sin(3 * x[0]) * x[1]);
+    apf::setVector(f, v, 0, u);
+  }
+  m->end(it);
+}
+
+/* recovery may migrate elements to complete boundary patches, so
+   each result stays on the mesh as a field and moves along with it */
+static apf::Field* recoverWith(int threads, apf::Field* eps)
+{
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#else
+  (void)threads;
+#endif
+  apf::Field* star = spr::recoverField(eps);
+  apf::renameField(star, threads == 1 ? "serial" : "threaded");
+  return star;
+}
+
+static long countDifferences(apf::Field* a, apf::Field* b)
+{
+  apf::Mesh* m = apf::getMesh(a);
+  int nc = apf::countComponents(a);
+  PCU_ALWAYS_ASSERT(apf::countComponents(b) == nc);
+  std::vector<double> ca(nc);
+  std::vector<double> cb(nc);
+  long bad = 0;
+  apf::MeshEntity* v;
+  apf::MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    apf::getComponents(a, v, 0, &ca[0]);
+    apf::getComponents(b, v, 0, &cb[0]);
+    for (int i = 0; i < nc; ++i)
+      if (std::fabs(ca[i] - cb[i]) > 1e-12)
+        ++bad;
+  }
+  m->end(it);
+  return PCU_Add_Long(bad);
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  int n = argc > 1 ? atoi(argv[1]) : 8;
+  /* one slab per part, so that recovery has both
+     local and boundary patches */
+  apf::Mesh2* m = apf::makeMdsBoxOnParts(n, n, n, 1, 1, 1, true);
+  apf::Field* f = apf::createLagrangeField(m, "solution", apf::VECTOR, 1);
+  setSolution(f);
+  apf::Field* eps = spr::getGradIPField(f, "eps", 1);
+  apf::Field* serial = recoverWith(1, eps);
+  apf::Field* threaded = recoverWith(4, eps);
+  long bad = countDifferences(serial, threaded);
+  if (!PCU_Comm_Self())
+    lion_oprint(1, "threaded SPR recovery: %ld values differ\n", bad);
+  PCU_ALWAYS_ASSERT(bad == 0);
+  apf::destroyField(threaded);
+  apf::destroyField(serial);
+  apf::destroyField(eps);
+  apf::destroyField(f);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
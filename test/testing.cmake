@@ -50,6 +50,11 @@ mpi_test(test_integrator 1
          "${MESHES}/cube/cube.dmg"
          "${MESHES}/cube/pumi11/cube.smb"
          )
+mpi_test(threadedAssembly 1
+         ./threadedAssembly
+         "${MESHES}/cube/cube.dmg"
+         "${MESHES}/cube/pumi11/cube.smb"
+         )
 mpi_test(test_matrix_gradient 1
          ./test_matrix_gradient
          "${MESHES}/cube/cube.dmg"
@@ -59,6 +64,9 @@ mpi_test(test_matrix_gradient 1
 mpi_test(modelInfo_dmg 1
   ./modelInfo
   "${MESHES}/cube/cube.dmg")
+mpi_test(in_closure_of_dmg 1
+  ./inClosureOf_test
+  "${MESHES}/cube/cube.dmg")
 if(ENABLE_SIMMETRIX)
   mpi_test(in_closure_of 1
     ./inClosureOf_test
@@ -261,6 +269,9 @@ mpi_test(uniform_serial 1
   "pipe.smb"
   "pipe_unif.smb")
 mpi_test(classifyThenAdapt 1 ./classifyThenAdapt)
+mpi_test(refineUniform 4 ./refineUniform)
+mpi_test(predictedCount 4 ./predictedCount)
+mpi_test(smoothAdapt 4 ./smoothAdapt)
 smoke_test(uniform_serial 1
   ./uniform
   "${MDIR}/pipe.${GXT}"
@@ -304,7 +315,9 @@ if(ENABLE_SIMMETRIX)
     "${MESHES}/electromagnetic/fichera.x_t"
     "${MESHES}/electromagnetic/fichera_1k.smb")
 endif()
-if(PCU_COMPRESS)
+if(PCU_ZSTD)
+  set(MESHFILE "zst:pipe_2_.smb")
+elseif(PCU_COMPRESS)
   set(MESHFILE "bz2:pipe_2_.smb")
 else()
   set(MESHFILE "pipe_2_.smb")
@@ -348,6 +361,16 @@ else()
     "pipe_4_.smb"
     2)
 endif()
+mpi_test(sfcsplit_4 2
+  ./sfcsplit
+  "${MDIR}/pipe.${GXT}"
+  ${MESHFILE}
+  "pipe_sfc_4_.smb"
+  2)
+mpi_test(verify_sfcsplit 4
+  ./verify
+  "${MDIR}/pipe.${GXT}"
+  "pipe_sfc_4_.smb")
 mpi_test(pipe_condense 4
   ./serialize
   "${MDIR}/pipe.${GXT}"
@@ -362,6 +385,11 @@ mpi_test(vtxElmMixedBalance 4
   ./vtxElmMixedBalance
   "${MDIR}/pipe.${GXT}"
   "pipe_4_.smb")
+mpi_test(checkpoint 4
+  ./checkpoint
+  "${MDIR}/pipe.${GXT}"
+  "pipe_4_.smb"
+  "pipe_4.ckpt")
 if(ENABLE_ZOLTAN)
   mpi_test(ma_parallel 4
     ./ma_test
@@ -475,6 +503,7 @@ mpi_test(construct 4
   ./construct
   "${MDIR}/cube.dmg"
   "${MDIR}/pumi7k/4/cube.smb")
+mpi_test(construct_csr 4 ./construct_csr)
 mpi_test(constructThenGhost 4
   ./constructThenGhost
   "${MDIR}/cube.dmg"
@@ -500,6 +529,7 @@ mpi_test(spr_2D 4
   "${MDIR}/square.smb"
   spr2D
   1)
+mpi_test(spr_threads 4 ./spr_threads)
 mpi_test(mixedNumbering 4
   ./mixedNumbering
   "${MDIR}/square.dmg"
@@ -554,6 +584,11 @@ mpi_test(test_verify 4
   ./test_verify
   "${MDIR}/cube.dmg"
   "${MDIR}/pumi7k/4/cube.smb")
+mpi_test(verifyIncremental 4 ./verifyIncremental)
+mpi_test(nodeShare 4 ./nodeShare)
+if(NOT APPLE)
+  mpi_test(phSharedFiles 4 ./phSharedFiles)
+endif()
 set(MDIR ${MESHES}/nonmanifold)
 mpi_test(nonmanif_verify 1
   ./verify
@@ -735,3 +770,6 @@ if (PCU_COMPRESS)
       WORKING_DIRECTORY ${MESHES}/phasta/4-1-Chef-Tet-Part/4-4-Chef-Part-ts20/run)
   endif()
 endif()
+if(ENABLE_DSP)
+  mpi_test(sparseLaplacian 4 ./sparseLaplacian)
+endif()
@@ -0,0 +1,199 @@
+#include <apf.h>
+#include <apfMDS.h>
+#include <apfMesh2.h>
+#include <apfNumbering.h>
+#include <apfShape.h>
+#include <apfDynamicMatrix.h>
+#include <gmi_mesh.h>
+#include <gmi_null.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <mpi.h>
+#include <cstdio>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* assembles element quantities once serially and once from OpenMP
+   threads, using only the documented thread-safe read paths, and
+   checks that every thread got exactly the serial answers */
+
+enum { RESULTS = 5 };
+
+struct Data
+{
+  apf::Field* u;
+  apf::Field* e;
+  apf::Numbering* nodes;
+  apf::MeshTag* sizes;
+};
+
+static double analytic(apf::Vector3 const& x)
+{
+  return x[0] + x[1] * x[2];
+}
+
+static void setup(apf::Mesh* m, Data& d)
+{
+  d.u = apf::createField(m, "u", apf::SCALAR, apf::getLagrange(2));
+  for (int dim = 0; dim < 2; ++dim) {
+    apf::MeshIterator* it = m->begin(dim);
+    apf::MeshEntity* v;
+    while ((v = m->iterate(it)))
+      apf::setScalar(d.u, v, 0, analytic(apf::getLinearCentroid(m, v)));
+    m->end(it);
+  }
+  d.e = 0;
+  if (m->getDimension() == 3) {
+    d.e = apf::createField(m, "e", apf::SCALAR, apf::getNedelec(1));
+    apf::zeroField(d.e);
+  }
+  d.nodes = apf::numberOverlapNodes(m, "u_nodes", apf::getLagrange(2));
+  d.sizes = m->createDoubleTag("size", 1);
+  apf::MeshIterator* it = m->begin(m->getDimension());
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    double s = apf::measure(m, e);
+    m->setDoubleTag(e, d.sizes, &s);
+  }
+  m->end(it);
+}
+
+static double sumSquares(apf::DynamicMatrix const& k)
+{
+  double s = 0;
+  for (size_t i = 0; i < k.getRows(); ++i)
+    for (size_t j = 0; j < k.getColumns(); ++j)
+      s += k(i,j) * k(i,j);
+  return s;
+}
+
+/* the Laplacian and mass matrices of one element, summarized
+   with a few numbers that are compared between runs */
+static void assemble(apf::Mesh* m, Data& d, apf::MeshEntity* elem,
+    double* r)
+{
+  apf::MeshElement* me = apf::createMeshElement(m, elem);
+  apf::Element* ue = apf::createElement(d.u, me);
+  int nen = apf::countNodes(ue);
+  apf::DynamicMatrix k(nen, nen);
+  k.zero();
+  double uu = 0;
+  apf::NewArray<apf::Vector3> grads;
+  int np = apf::countIntPoints(me, 2);
+  for (int p = 0; p < np; ++p) {
+    apf::Vector3 xi;
+    apf::getIntPoint(me, 2, p, xi);
+    double w = apf::getIntWeight(me, 2, p) * apf::getDV(me, xi);
+    apf::getShapeGrads(ue, xi, grads);
+    for (int i = 0; i < nen; ++i)
+      for (int j = 0; j < nen; ++j)
+        k(i,j) += (grads[i] * grads[j]) * w;
+    double u = apf::getScalar(ue, xi);
+    uu += u * u * w;
+  }
+  apf::destroyElement(ue);
+  r[0] = sumSquares(k);
+  r[1] = uu;
+  r[2] = 0;
+  if (d.e) {
+    apf::Element* ee = apf::createElement(d.e, me);
+    int ne = apf::countNodes(ee);
+    apf::DynamicMatrix mass(ne, ne);
+    mass.zero();
+    apf::NewArray<apf::Vector3> values(ne);
+    np = apf::countIntPoints(me, 2);
+    for (int p = 0; p < np; ++p) {
+      apf::Vector3 xi;
+      apf::getIntPoint(me, 2, p, xi);
+      double w = apf::getIntWeight(me, 2, p) * apf::getDV(me, xi);
+      apf::getVectorShapeValues(ee, xi, values);
+      for (int i = 0; i < ne; ++i)
+        for (int j = 0; j < ne; ++j)
+          mass(i,j) += (values[i] * values[j]) * w;
+    }
+    apf::destroyElement(ee);
+    r[2] = sumSquares(mass);
+  }
+  apf::destroyMeshElement(me);
+  apf::NewArray<int> numbers;
+  int nn = apf::getElementNumbers(d.nodes, elem, numbers);
+  r[3] = 0;
+  for (int i = 0; i < nn; ++i)
+    r[3] += numbers[i] * (i + 1);
+  double size;
+  m->getDoubleTag(elem, d.sizes, &size);
+  apf::Downward faces;
+  int nf = m->getDownward(elem, m->getDimension() - 1, faces);
+  int neighbors = 0;
+  for (int i = 0; i < nf; ++i) {
+    apf::Up up;
+    m->getUp(faces[i], up);
+    neighbors += up.n - 1;
+  }
+  r[4] = size * neighbors;
+}
+
+static double run(apf::Mesh* m, Data& d,
+    std::vector<apf::MeshEntity*> const& elems, std::vector<double>& r,
+    bool threaded)
+{
+  int n = elems.size();
+  r.assign(n * RESULTS, 0);
+  double t0 = PCU_Time();
+  if (threaded) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (int i = 0; i < n; ++i)
+      assemble(m, d, elems[i], &r[i * RESULTS]);
+  } else {
+    for (int i = 0; i < n; ++i)
+      assemble(m, d, elems[i], &r[i * RESULTS]);
+  }
+  return PCU_Time() - t0;
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 3);
+  gmi_register_mesh();
+  gmi_register_null();
+  apf::Mesh2* m = apf::loadMdsMesh(argv[1], argv[2]);
+  Data d;
+  setup(m, d);
+  std::vector<apf::MeshEntity*> elems;
+  apf::MeshIterator* it = m->begin(m->getDimension());
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it)))
+    elems.push_back(e);
+  m->end(it);
+  std::vector<double> serial;
+  std::vector<double> threaded;
+  /* threads go first so that they also race to fill the
+     shape function caches and tables */
+  double threadedTime = run(m, d, elems, threaded, true);
+  double serialTime = run(m, d, elems, serial, false);
+  for (size_t i = 0; i < serial.size(); ++i)
+    PCU_ALWAYS_ASSERT(serial[i] == threaded[i]);
+  int threads = 1;
+#ifdef _OPENMP
+  threads = omp_get_max_threads();
+#endif
+  if (!PCU_Comm_Self())
+    printf("assembled %lu elements: serial %f s, %d threads %f s\n",
+        (unsigned long)elems.size(), serialTime, threads, threadedTime);
+  apf::removeTagFromDimension(m, d.sizes, m->getDimension());
+  m->destroyTag(d.sizes);
+  apf::destroyNumbering(d.nodes);
+  if (d.e)
+    apf::destroyField(d.e);
+  apf::destroyField(d.u);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,80 @@
+#include <ma.h>
+#include <apf.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfMesh2.h>
+#include <PCU.h>
+#include <lionPrint.h>
+#include <pcu_util.h>
+#include <cstdlib>
+
+/* watches a box spread over several parts with an
+   apf::IncrementalVerifier while it is refined and migrated,
+   where it must agree with apf::verify, then moves one copy of
+   a shared vertex so that it must report the mismatch */
+
+/* each part sends the elements of its low y half to the next part */
+static void shift(apf::Mesh2* m)
+{
+  apf::Migration* plan = new apf::Migration(m);
+  int to = (PCU_Comm_Self() + 1) % PCU_Comm_Peers();
+  apf::MeshEntity* e;
+  apf::MeshIterator* it = m->begin(3);
+  while ((e = m->iterate(it)))
+    if (apf::getLinearCentroid(m, e).y() < 0.5)
+      plan->send(e, to);
+  m->end(it);
+  m->migrate(plan);
+}
+
+/* moves the first shared vertex of part 0 there only */
+static void plantMismatch(apf::Mesh2* m)
+{
+  if (PCU_Comm_Self())
+    return;
+  apf::MeshEntity* v;
+  apf::MeshIterator* it = m->begin(0);
+  while ((v = m->iterate(it)))
+    if (m->isShared(v))
+      break;
+  m->end(it);
+  PCU_ALWAYS_ASSERT(v);
+  apf::Vector3 x;
+  m->getPoint(v, 0, x);
+  m->setPoint(v, 0, x + apf::Vector3(1e-3, 0, 0));
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc,&argv);
+  PCU_Comm_Init();
+  lion_set_verbosity(1);
+  PCU_ALWAYS_ASSERT(PCU_Comm_Peers() > 1);
+  int n = argc > 1 ? atoi(argv[1]) : 4;
+  apf::Mesh2* m = apf::makeMdsBoxOnParts(n, n, n, 1, 1, 1, true);
+  apf::IncrementalVerifier* verifier = new apf::IncrementalVerifier(m);
+  ma::runUniformRefinement(m);
+  PCU_ALWAYS_ASSERT(verifier->run() == 0);
+  m->verify();
+  shift(m);
+  PCU_ALWAYS_ASSERT(verifier->run() == 0);
+  m->verify();
+  /* nothing changed since the last run */
+  PCU_ALWAYS_ASSERT(verifier->run() == 0);
+  plantMismatch(m);
+  long found = verifier->run();
+  if (!PCU_Comm_Self())
+    lion_oprint(1, "planted mismatch found %ld times\n", found);
+  PCU_ALWAYS_ASSERT(found > 0);
+  /* clearing reports every entity as destroyed, after which
+     nothing is left to check, including the moved vertex */
+  plantMismatch(m);
+  apf::clear(m);
+  PCU_ALWAYS_ASSERT(m->count(0) == 0);
+  PCU_ALWAYS_ASSERT(verifier->run() == 0);
+  delete verifier;
+  m->destroyNative();
+  apf::destroyMesh(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}